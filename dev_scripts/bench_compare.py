@@ -0,0 +1,81 @@
+# Collects results from the bench firmware (envs/bench.ini) and optionally compares them with an earlier run.
+#
+# Usage:
+#   pio device monitor -e bench | python dev_scripts/bench_compare.py --save after.jsonl
+#   python dev_scripts/bench_compare.py after.jsonl --baseline before.jsonl
+#
+# Result lines are JSON objects with a "bench" key. Everything else on the serial port is ignored,
+# so a raw monitor log works as input too. Input is read until the firmware prints "# Done".
+
+import argparse
+import json
+import sys
+
+
+def read_results(lines):
+    results = {}
+    for line in lines:
+        line = line.strip()
+        if line == "# Done":
+            break
+        if not line.startswith("{"):
+            continue
+        try:
+            result = json.loads(line)
+        except ValueError:
+            continue
+        if "bench" in result:
+            results[result["bench"]] = result
+    return results
+
+
+def load(path):
+    with open(path) as f:
+        return read_results(f)
+
+
+def change(before, after):
+    if not before:
+        return "      "
+    return f"{(after - before) / before * 100:+5.1f}%"
+
+
+def print_table(results, baseline):
+    name_width = max([len("benchmark")] + [len(name) for name in results])
+    header = f"{'benchmark':<{name_width}}  {'min':>8}  {'median':>8}  {'p99':>8}  {'median µs':>9}"
+    if baseline:
+        header += f"  {'Δ min':>6}  {'Δ median':>8}  {'Δ p99':>6}"
+    print(header)
+
+    for name, result in results.items():
+        mhz = result.get("cpuMhz") or 240
+        line = (f"{name:<{name_width}}  {result['min']:>8}  {result['median']:>8}  {result['p99']:>8}"
+                f"  {result['median'] / mhz:>9.2f}")
+        before = baseline.get(name) if baseline else None
+        if before:
+            line += (f"  {change(before['min'], result['min']):>6}  {change(before['median'], result['median']):>8}"
+                     f"  {change(before['p99'], result['p99']):>6}")
+        print(line)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Summarise and compare Palooka bench firmware results.")
+    parser.add_argument("results", nargs="?", help="saved results or monitor log (default: stdin)")
+    parser.add_argument("--baseline", help="earlier results to compare against")
+    parser.add_argument("--save", help="write the results as JSON lines for a later --baseline")
+    args = parser.parse_args()
+
+    results = load(args.results) if args.results else read_results(sys.stdin)
+    if not results:
+        sys.exit("bench_compare: no results found")
+
+    if args.save:
+        with open(args.save, "w") as f:
+            for result in results.values():
+                f.write(json.dumps(result) + "\n")
+
+    print_table(results, load(args.baseline) if args.baseline else None)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,108 @@
+# Converts a black box recording (GET /blackbox on the robot) to CSV.
+#
+# Usage: python dev_scripts/blackbox_decode.py blackbox-previous.bin [-o out.csv]
+#        python dev_scripts/blackbox_decode.py http://192.168.4.1/blackbox?session=current
+#
+# The file layout mirrors BlackBoxRecorder::FileHeader and BlackBoxRecorder::Record in include/BlackBoxRecorder.h.
+
+import argparse
+import csv
+import struct
+import sys
+import urllib.request
+
+MAGIC = 0x58424250  # "PBBX"
+FORMAT_VERSION = 1
+HEADER_FORMAT = "<IBBBBHHI"  # magic, version, recordSize, resetReason, reserved, samplePeriodMs, count, bootCount
+RECORD_FORMAT = "<IHhhBBHBB"  # timeMs, batteryMv, leftVelocity, rightVelocity, flipperAngle, flags, sinceCommandMs, commands, reserved
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+RECORD_SIZE = struct.calcsize(RECORD_FORMAT)
+
+FLAG_BOOST = 1 << 0
+FLAG_ACTUATORS_ASLEEP = 1 << 1
+FLAG_MACRO_RUNNING = 1 << 2
+NO_COMMAND = 0xFFFF
+
+# esp_reset_reason_t
+RESET_REASONS = {
+    0: "live recording",
+    1: "power on",
+    2: "external pin",
+    3: "software",
+    4: "panic",
+    5: "interrupt watchdog",
+    6: "task watchdog",
+    7: "other watchdog",
+    8: "deep sleep",
+    9: "brownout",
+    10: "SDIO",
+}
+
+COLUMNS = ["time_ms", "battery_mv", "left_velocity", "right_velocity", "flipper_angle",
+           "boost", "actuators_asleep", "macro_running", "since_command_ms", "commands"]
+
+
+def read_input(source):
+    if source.startswith(("http://", "https://")):
+        with urllib.request.urlopen(source, timeout=10) as response:
+            return response.read()
+    with open(source, "rb") as f:
+        return f.read()
+
+
+def decode(data):
+    if len(data) < HEADER_SIZE:
+        raise ValueError("file is too short for a header")
+
+    magic, version, record_size, reset_reason, _reserved, period_ms, count, boot_count = \
+        struct.unpack_from(HEADER_FORMAT, data)
+    if magic != MAGIC:
+        raise ValueError("not a black box recording (bad magic)")
+    if version != FORMAT_VERSION or record_size != RECORD_SIZE:
+        raise ValueError(f"unsupported format version {version} (record size {record_size})")
+    if len(data) < HEADER_SIZE + count * RECORD_SIZE:
+        raise ValueError(f"file is truncated: header says {count} records")
+
+    header = {"reset_reason": reset_reason, "period_ms": period_ms, "count": count, "boot_count": boot_count}
+    rows = []
+    for i in range(count):
+        time_ms, battery_mv, left, right, angle, flags, since_command_ms, commands, _reserved = \
+            struct.unpack_from(RECORD_FORMAT, data, HEADER_SIZE + i * RECORD_SIZE)
+        rows.append([
+            time_ms, battery_mv, left, right, angle,
+            int(bool(flags & FLAG_BOOST)),
+            int(bool(flags & FLAG_ACTUATORS_ASLEEP)),
+            int(bool(flags & FLAG_MACRO_RUNNING)),
+            "" if since_command_ms == NO_COMMAND else since_command_ms,
+            commands,
+        ])
+    return header, rows
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert a Palooka black box recording to CSV.")
+    parser.add_argument("source", help="recording file, or the robot's /blackbox URL")
+    parser.add_argument("-o", "--output", help="CSV file to write (default: stdout)")
+    args = parser.parse_args()
+
+    try:
+        header, rows = decode(read_input(args.source))
+    except (OSError, ValueError) as e:
+        sys.exit(f"blackbox_decode: {e}")
+
+    reason = RESET_REASONS.get(header["reset_reason"], f"unknown ({header['reset_reason']})")
+    print(f"{header['count']} samples every {header['period_ms']} ms, boot {header['boot_count']}, ended by: {reason}",
+          file=sys.stderr)
+
+    out = open(args.output, "w", newline="") if args.output else sys.stdout
+    try:
+        writer = csv.writer(out)
+        writer.writerow(COLUMNS)
+        writer.writerows(rows)
+    finally:
+        if args.output:
+            out.close()
+
+
+if __name__ == "__main__":
+    main()
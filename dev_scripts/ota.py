@@ -0,0 +1,121 @@
+# Builds the firmware and filesystem images, then pushes them over WiFi to several robots at once
+# Usage: pio run -t ota
+#
+# Robots are listed in PIO_OTA_HOSTS (comma separated, e.g. "192.168.4.1,palooka-2.local").
+# The same pushing can be done without PlatformIO:
+#   python dev_scripts/ota.py --firmware .pio/build/dev/firmware.bin --filesystem .pio/build/dev/littlefs.bin 192.168.4.1 ...
+#
+# Each image is sent to /update/firmware or /update/filesystem with its MD5, which the robot checks
+# before switching partitions. The robot restarts after each image, so the filesystem goes first.
+
+import argparse
+import hashlib
+import os
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+import requests
+
+REQUEST_TIMEOUT = 120  # seconds, generous for a 1.5 MB image over a busy network
+RESTART_WAIT = 8  # seconds for a robot to come back after a filesystem update
+
+
+def _md5(path):
+    digest = hashlib.md5()
+    with open(path, "rb") as image:
+        for chunk in iter(lambda: image.read(65536), b""):
+            digest.update(chunk)
+    return digest.hexdigest()
+
+
+def _push_image(host, endpoint, path, md5):
+    started = time.monotonic()
+    with open(path, "rb") as image:
+        response = requests.post(
+            f"http://{host}/update/{endpoint}",
+            params={"md5": md5},
+            files={"image": (os.path.basename(path), image, "application/octet-stream")},
+            timeout=REQUEST_TIMEOUT,
+        )
+    elapsed = time.monotonic() - started
+    result = response.json()
+    if not result.get("success"):
+        raise RuntimeError(f"{endpoint} rejected: {result.get('error', response.status_code)}")
+    return result, elapsed
+
+
+def push_to_robot(host, firmware, filesystem):
+    """Returns a one-line summary. Raises on failure."""
+    lines = []
+    if filesystem:
+        result, elapsed = _push_image(host, "filesystem", filesystem, _md5(filesystem))
+        lines.append(f"filesystem {result['bytes']} B, {result['kBps']:.1f} kB/s on robot, {elapsed:.1f} s total")
+        time.sleep(RESTART_WAIT)
+    if firmware:
+        result, elapsed = _push_image(host, "firmware", firmware, _md5(firmware))
+        lines.append(f"firmware {result['bytes']} B, {result['kBps']:.1f} kB/s on robot, {elapsed:.1f} s total")
+    return "; ".join(lines)
+
+
+def push_to_robots(hosts, firmware=None, filesystem=None):
+    """Pushes to every host in parallel. Returns the number of failed robots."""
+    failures = 0
+    with ThreadPoolExecutor(max_workers=len(hosts)) as pool:
+        futures = {host: pool.submit(push_to_robot, host, firmware, filesystem) for host in hosts}
+        for host, future in futures.items():
+            try:
+                print(f"[ota] {host}: {future.result()}")
+            except Exception as error:
+                failures += 1
+                print(f"[ota] {host}: FAILED - {error}")
+    return failures
+
+
+def _parse_hosts(value):
+    return [host.strip() for host in (value or "").split(",") if host.strip()]
+
+
+try:
+    Import("env")
+except NameError:
+    env = None
+
+if env is not None:
+    def ota_action(source, target, env):
+        hosts = _parse_hosts(os.environ.get("PIO_OTA_HOSTS"))
+        if not hosts:
+            print("Set PIO_OTA_HOSTS to a comma separated list of robot addresses.")
+            sys.exit(1)
+
+        # Build both images for this env, as they're pushed from its build directory
+        pioenv = env.subst("$PIOENV")
+        result = env.Execute(f"pio run -e {pioenv}")
+        if result != 0:
+            sys.exit(result)
+        result = env.Execute(f"npm --prefix frontend run build && pio run -e {pioenv} -t buildfs")
+        if result != 0:
+            sys.exit(result)
+
+        build_dir = env.subst("$BUILD_DIR")
+        failures = push_to_robots(hosts, os.path.join(build_dir, "firmware.bin"), os.path.join(build_dir, "littlefs.bin"))
+        if failures:
+            sys.exit(1)
+
+    env.AddCustomTarget(
+        "ota",
+        None,
+        ota_action,
+        title="Build and push firmware + filesystem over WiFi",
+        description="Push the same build to every robot in PIO_OTA_HOSTS in parallel."
+    )
+elif __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Push firmware and filesystem images to several robots in parallel")
+    parser.add_argument("hosts", nargs="+", help="Robot addresses")
+    parser.add_argument("--firmware", help="Path to firmware.bin")
+    parser.add_argument("--filesystem", help="Path to littlefs.bin")
+    args = parser.parse_args()
+
+    if not args.firmware and not args.filesystem:
+        parser.error("Nothing to push - pass --firmware and/or --filesystem")
+    sys.exit(1 if push_to_robots(args.hosts, args.firmware, args.filesystem) else 0)
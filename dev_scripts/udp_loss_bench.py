@@ -0,0 +1,230 @@
+# Compares joystick latency over a TCP (WebSocket-like) link and the UDP control channel
+# when packets are lost, using a local stand-in for the robot.
+#
+# TCP never skips a lost segment: it is retransmitted after the RTO and every later frame waits
+# behind it (head-of-line blocking). UDP frames are simply lost and the next one supersedes them.
+# Both links run over loopback; loss is injected by the sending side of each link.
+#
+# Usage: python dev_scripts/udp_loss_bench.py [--loss 0.05] [--rate 60] [--duration 10] [--rto 0.2]
+#
+# The frame format and stale-frame filtering mirror include/ControlFrame.h.
+
+import argparse
+import math
+import queue
+import random
+import socket
+import struct
+import threading
+import time
+
+FRAME_FORMAT = "<2sBBHIhh"  # magic, version, flags, token, sequence, x, y
+FRAME_SIZE = struct.calcsize(FRAME_FORMAT)
+AXIS_SCALE = 32767
+TOKEN = 0x5A5A
+
+
+def encode_frame(sequence, x, y, token=TOKEN):
+    return struct.pack(FRAME_FORMAT, b"PK", 1, 0, token, sequence & 0xFFFFFFFF,
+                       int(max(-1.0, min(1.0, x)) * AXIS_SCALE), int(max(-1.0, min(1.0, y)) * AXIS_SCALE))
+
+
+def decode_frame(data):
+    if len(data) != FRAME_SIZE:
+        return None
+    magic, version, _flags, token, sequence, x, y = struct.unpack(FRAME_FORMAT, data)
+    if magic != b"PK" or version != 1:
+        return None
+    return token, sequence, x / AXIS_SCALE, y / AXIS_SCALE
+
+
+class SequenceFilter:
+    """Same wrap-around comparison as ControlFrame::SequenceFilter."""
+
+    def __init__(self):
+        self.last = None
+
+    def accept(self, sequence):
+        if self.last is not None:
+            diff = (sequence - self.last) & 0xFFFFFFFF
+            if diff == 0 or diff >= 0x80000000:
+                return False
+        self.last = sequence
+        return True
+
+
+class StandInRobot:
+    """Records when each frame would be applied to the motors."""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.applied = []  # (apply_time, sequence)
+
+    def apply(self, sequence):
+        with self.lock:
+            self.applied.append((time.perf_counter(), sequence))
+
+
+def run_udp(frames, loss, rng):
+    robot = StandInRobot()
+    receiver = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    receiver.bind(("127.0.0.1", 0))
+    receiver.settimeout(0.5)
+    address = receiver.getsockname()
+    done = threading.Event()
+
+    def receive():
+        seq_filter = SequenceFilter()
+        while not done.is_set():
+            try:
+                data, _ = receiver.recvfrom(64)
+            except socket.timeout:
+                continue
+            frame = decode_frame(data)
+            if frame and frame[0] == TOKEN and seq_filter.accept(frame[1]):
+                robot.apply(frame[1])
+
+    thread = threading.Thread(target=receive, daemon=True)
+    thread.start()
+
+    sender = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    send_times = {}
+    start = time.perf_counter()
+    for sequence, offset, x, y in frames:
+        _sleep_until(start + offset)
+        send_times[sequence] = time.perf_counter()
+        if rng.random() < loss:
+            continue  # Lost in the air
+        sender.sendto(encode_frame(sequence, x, y), address)
+
+    time.sleep(0.3)
+    done.set()
+    thread.join()
+    return send_times, robot.applied
+
+
+def run_tcp(frames, loss, rto, rng):
+    robot = StandInRobot()
+    listener = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    listener.bind(("127.0.0.1", 0))
+    listener.listen(1)
+    address = listener.getsockname()
+
+    def receive():
+        connection, _ = listener.accept()
+        connection.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        buffer = b""
+        while True:
+            chunk = connection.recv(4096)
+            if not chunk:
+                break
+            buffer += chunk
+            while len(buffer) >= FRAME_SIZE:
+                frame = decode_frame(buffer[:FRAME_SIZE])
+                buffer = buffer[FRAME_SIZE:]
+                if frame:
+                    robot.apply(frame[1])  # TCP delivers in order, nothing to filter
+        connection.close()
+
+    thread = threading.Thread(target=receive, daemon=True)
+    thread.start()
+
+    sender = socket.create_connection(address)
+    sender.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+
+    # The link delivers segments strictly in order. A lost segment arrives one RTO late, and the
+    # receiver holds back everything sent after it until then (later segments are not delayed further).
+    link = queue.Queue()
+
+    def forward():
+        while True:
+            item = link.get()
+            if item is None:
+                break
+            sequence, x, y, deliver_at = item
+            _sleep_until(deliver_at)
+            sender.sendall(encode_frame(sequence, x, y))
+
+    link_thread = threading.Thread(target=forward, daemon=True)
+    link_thread.start()
+
+    send_times = {}
+    previous_delivery = 0.0
+    start = time.perf_counter()
+    for sequence, offset, x, y in frames:
+        _sleep_until(start + offset)
+        now = time.perf_counter()
+        send_times[sequence] = now
+        arrival = now + (rto if rng.random() < loss else 0.0)
+        previous_delivery = max(arrival, previous_delivery)
+        link.put((sequence, x, y, previous_delivery))
+
+    link.put(None)
+    link_thread.join()
+    time.sleep(0.3)
+    sender.close()
+    thread.join(timeout=1)
+    listener.close()
+    return send_times, robot.applied
+
+
+def _sleep_until(deadline):
+    remaining = deadline - time.perf_counter()
+    if remaining > 0:
+        time.sleep(remaining)
+
+
+def control_age_ms(send_times, applied, duration, step=0.001):
+    """Age of the command the motors are following, sampled every step seconds."""
+    if not applied:
+        return []
+    applied = sorted(applied)
+    start = min(send_times.values())
+    ages = []
+    index = -1
+    t = applied[0][0]
+    end = start + duration
+    while t < end:
+        while index + 1 < len(applied) and applied[index + 1][0] <= t:
+            index += 1
+        ages.append((t - send_times[applied[index][1]]) * 1000.0)
+        t += step
+    return ages
+
+
+def percentile(values, fraction):
+    if not values:
+        return float("nan")
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+def report(name, send_times, applied, duration):
+    latencies = [(t - send_times[sequence]) * 1000.0 for t, sequence in applied]
+    ages = control_age_ms(send_times, applied, duration)
+    print(f"{name:>4}: sent={len(send_times):5d} applied={len(applied):5d} | "
+          f"latency ms p50={percentile(latencies, 0.5):6.1f} p99={percentile(latencies, 0.99):6.1f} "
+          f"max={max(latencies, default=float('nan')):6.1f} | "
+          f"control age ms p50={percentile(ages, 0.5):6.1f} p99={percentile(ages, 0.99):6.1f} "
+          f"max={max(ages, default=float('nan')):6.1f}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="TCP vs UDP joystick latency under packet loss")
+    parser.add_argument("--loss", type=float, default=0.05, help="Probability each packet is lost")
+    parser.add_argument("--rate", type=float, default=60.0, help="Joystick frames per second")
+    parser.add_argument("--duration", type=float, default=10.0, help="Seconds of driving per link")
+    parser.add_argument("--rto", type=float, default=0.2, help="TCP retransmission timeout in seconds")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    count = int(args.rate * args.duration)
+    frames = [(i, i / args.rate, math.sin(i / args.rate), math.cos(i / args.rate)) for i in range(count)]
+
+    print(f"{count} frames at {args.rate:.0f} Hz, {args.loss * 100:.1f}% loss, RTO {args.rto * 1000:.0f} ms")
+    report("tcp", *run_tcp(frames, args.loss, args.rto, random.Random(args.seed)), args.duration)
+    report("udp", *run_udp(frames, args.loss, random.Random(args.seed)), args.duration)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,203 @@
+# Measures WebSocket round-trip latency to one or more robots with {"ping": n} / {"pong": n} messages,
+# which the robot answers from its network loop without touching the motors.
+#
+# Arena mode (every robot on one shared AP) - join the arena network and pass every robot's IP at once:
+#   python dev_scripts/ws_latency_bench.py 10.0.0.21 10.0.0.22 10.0.0.23 --rate 50 --duration 30
+# Separate APs (the default setup) - with the other robots' APs running nearby, join each robot's own AP in turn:
+#   python dev_scripts/ws_latency_bench.py 192.168.4.1 --rate 50 --duration 30
+#
+# Compare the per-robot p50/p99 and loss between the two runs. --json prints one JSON line per robot instead.
+#
+# --drive-rate sends joystick commands (a slow circle) alongside the pings, so the pongs are timed while the robot
+# task is busy:
+#   python dev_scripts/ws_latency_bench.py 192.168.4.1 --rate 50 --drive-rate 50 --duration 30
+
+import argparse
+import json
+import math
+import socket
+import statistics
+import threading
+import time
+
+from wsproto import WSConnection
+from wsproto.connection import ConnectionType
+from wsproto.events import AcceptConnection, CloseConnection, Message, Ping, Request, TextMessage
+
+WEBSOCKET_PORT = 81
+RECEIVE_SIZE = 4096
+
+
+def percentile(sorted_values, fraction):
+    if not sorted_values:
+        return float("nan")
+    index = min(len(sorted_values) - 1, int(round(fraction * (len(sorted_values) - 1))))
+    return sorted_values[index]
+
+
+class RobotProbe:
+    def __init__(self, host, port, rate, duration, drive_rate=0.0):
+        self.host = host
+        self.port = port
+        self.interval = 1.0 / rate
+        self.drive_interval = 1.0 / drive_rate if drive_rate > 0 else None
+        self.duration = duration
+        self.sent = 0
+        self.drive_sent = 0
+        self.rtts_ms = []
+        self.error = None
+        self._sent_at = {}
+        self._lock = threading.Lock()
+
+    def run(self):
+        try:
+            self._run()
+        except (OSError, RuntimeError) as e:
+            self.error = str(e)
+
+    def _run(self):
+        sock = socket.create_connection((self.host, self.port), timeout=5)
+        sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        ws = WSConnection(ConnectionType.CLIENT)
+        sock.sendall(ws.send(Request(host=f"{self.host}:{self.port}", target="/")))
+
+        # Wait for the handshake
+        accepted = False
+        while not accepted:
+            data = sock.recv(RECEIVE_SIZE)
+            if not data:
+                raise RuntimeError("connection closed during handshake")
+            ws.receive_data(data)
+            for event in ws.events():
+                if isinstance(event, AcceptConnection):
+                    accepted = True
+
+        stop = threading.Event()
+        reader = threading.Thread(target=self._read, args=(sock, ws, stop), daemon=True)
+        reader.start()
+
+        start = time.perf_counter()
+        next_send = start
+        next_drive = start if self.drive_interval else float("inf")
+        while time.perf_counter() - start < self.duration:
+            now = time.perf_counter()
+            next_due = min(next_send, next_drive)
+            if now < next_due:
+                time.sleep(next_due - now)
+            if next_drive < next_send:
+                t = time.perf_counter() - start
+                drive = {"x": round(0.8 * math.sin(math.pi * t), 3), "y": round(0.8 * math.cos(math.pi * t), 3)}
+                with self._lock:
+                    payload = ws.send(Message(data=json.dumps(drive)))
+                    self.drive_sent += 1
+                sock.sendall(payload)
+                next_drive += self.drive_interval
+                continue
+            with self._lock:
+                self._sent_at[self.sent] = time.perf_counter()
+                payload = ws.send(Message(data=json.dumps({"ping": self.sent})))
+                self.sent += 1
+            sock.sendall(payload)
+            next_send += self.interval
+
+        if self.drive_interval:
+            with self._lock:
+                payload = ws.send(Message(data=json.dumps({"x": 0, "y": 0})))  # Leave the robot stopped
+            sock.sendall(payload)
+
+        time.sleep(1.0)  # Let late pongs arrive
+        stop.set()
+        with self._lock:
+            try:
+                sock.sendall(ws.send(CloseConnection(code=1000)))
+            except Exception:
+                pass
+        sock.close()
+        reader.join(timeout=1)
+
+    def _read(self, sock, ws, stop):
+        sock.settimeout(0.2)
+        while not stop.is_set():
+            try:
+                data = sock.recv(RECEIVE_SIZE)
+            except socket.timeout:
+                continue
+            except OSError:
+                return
+            if not data:
+                return
+
+            received_at = time.perf_counter()
+            with self._lock:
+                ws.receive_data(data)
+                events = list(ws.events())
+                replies = []
+                for event in events:
+                    if isinstance(event, Ping):
+                        replies.append(ws.send(event.response()))
+                    elif isinstance(event, TextMessage):
+                        self._record(event.data, received_at)
+            for reply in replies:
+                sock.sendall(reply)
+
+    def _record(self, text, received_at):
+        try:
+            message = json.loads(text)
+        except ValueError:
+            return
+        sent_at = self._sent_at.pop(message.get("pong"), None) if isinstance(message, dict) else None
+        if sent_at is not None:
+            self.rtts_ms.append((received_at - sent_at) * 1000.0)
+
+    def summary(self):
+        rtts = sorted(self.rtts_ms)
+        received = len(rtts)
+        return {
+            "host": self.host,
+            "sent": self.sent,
+            "drive_sent": self.drive_sent,
+            "received": received,
+            "loss": (1.0 - received / self.sent) if self.sent else float("nan"),
+            "p50_ms": percentile(rtts, 0.50),
+            "p90_ms": percentile(rtts, 0.90),
+            "p99_ms": percentile(rtts, 0.99),
+            "max_ms": rtts[-1] if rtts else float("nan"),
+            "mean_ms": statistics.fmean(rtts) if rtts else float("nan"),
+            "error": self.error,
+        }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="WebSocket round-trip latency to one or more Palooka robots.")
+    parser.add_argument("hosts", nargs="+", help="robot IPs or host names")
+    parser.add_argument("--port", type=int, default=WEBSOCKET_PORT)
+    parser.add_argument("--rate", type=float, default=50.0, help="pings per second per robot")
+    parser.add_argument("--duration", type=float, default=10.0, help="seconds")
+    parser.add_argument("--drive-rate", type=float, default=0.0,
+                        help="joystick commands per second per robot, sent between the pings (default none)")
+    parser.add_argument("--json", action="store_true", help="print one JSON line per robot")
+    args = parser.parse_args()
+
+    probes = [RobotProbe(host, args.port, args.rate, args.duration, args.drive_rate) for host in args.hosts]
+    threads = [threading.Thread(target=probe.run) for probe in probes]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    for probe in probes:
+        result = probe.summary()
+        if args.json:
+            print(json.dumps(result))
+            continue
+        if result["error"]:
+            print(f"{result['host']:>16}  error: {result['error']}")
+            continue
+        print(f"{result['host']:>16}  sent {result['sent']:5d}  loss {result['loss'] * 100:5.1f}%  "
+              f"p50 {result['p50_ms']:6.1f} ms  p90 {result['p90_ms']:6.1f} ms  "
+              f"p99 {result['p99_ms']:6.1f} ms  max {result['max_ms']:6.1f} ms"
+              + (f"  drive {result['drive_sent']}" if result["drive_sent"] else ""))
+
+
+if __name__ == "__main__":
+    main()
@@ -1,5 +1,5 @@
 import { isEditMode } from './edit_mode.js';
-import { sendJoystickData } from './web_socket_manager.js';
+import { sendJoystickData, getJoystickStats } from './web_socket_manager.js';
 
 let joystickCenter = { x: 0, y: 0 };
 let joystickActive = false;
@@ -115,13 +115,8 @@ function prepareJoystickCoordinates(x, y) {
 	const decimalX = rotatedX / (joystickRect.width / 2)
 	const decimalY = rotatedY / (joystickRect.height / 2)
 
-	// Round to 5 decimal places to avoid server overloads
-	const roundedX = Math.round(decimalX * 1e5) / 1e5;
-	const roundedY = Math.round(decimalY * 1e5) / 1e5;
-
-	console.log("Final X: " + roundedX, "Final Y: " + roundedY);
-
-	return [roundedX, roundedY];
+	// Rounding to the sent resolution happens in sendJoystickData()
+	return [decimalX, decimalY];
 }
 
 function updateHandlePosition(x, y) {
@@ -198,5 +193,6 @@ function resetJoystick() {
 	joystickActive = false;
 	const handle = document.querySelector('.joystick-handle');
 	handle.style.transform = 'translate(-50%, -50%)';
-	console.log('Joystick reset');
+	const { moves, sent, suppressed } = getJoystickStats();
+	console.log(`Joystick reset - ${sent} frames sent, ${suppressed} unchanged frames suppressed from ${moves} moves`);
 }
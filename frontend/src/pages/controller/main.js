@@ -2,10 +2,11 @@ import { isEditMode, startDrag, toggleMode, updateControlInteractivity } from '.
 import { toggleFullscreen } from './fullscreen.js';
 import { changeInputType } from './switch_control_type.js';
 import { loadControlType, loadLayout, } from './controller.js';
-import { sendFlipData, sendBoostData, sendSliderData } from './web_socket_manager.js';
+import { sendFlipData, sendBoostData, sendSliderData, onRobotSnapshot } from './web_socket_manager.js';
 import { setupBatteryWebsocket } from '@/utils/battery_websocket.js';
 import { handleResetBtnClick } from './reset_controller_layout.js';
 import { editText } from './edit_text.js';
+import { setupRobotPicker } from './robot_picker.js';
 import {
 	initAspectRatios,
 	setDefaultLayout,
@@ -47,6 +48,9 @@ radios.forEach(radio => radio.addEventListener('change', (e) => {
 	changeInputType();
 }));
 
+// Robot picker in settings modal (arena mode only)
+setupRobotPicker(document.getElementById('robot-picker-block'), document.getElementById('robot-picker'));
+
 // Resize listener on window
 let lastWidth = window.innerWidth;
 let lastHeight = window.innerHeight;
@@ -90,6 +94,15 @@ boostButton.addEventListener('click', () => {
 	sendBoostData();
 });
 
+// After a (re)connect, show what the robot is actually doing
+onRobotSnapshot((snapshot) => {
+	// The button arms automatic boost rather than switching it (older firmware only sends boost)
+	boostButton.classList.toggle('active', Boolean(snapshot.autoBoost ?? snapshot.boost));
+	if (snapshot.driver !== -1 && snapshot.driver !== snapshot.client) {
+		console.log(`Client ${snapshot.driver} was driving the robot`);
+	}
+});
+
 // Register all for sliders
 document.querySelectorAll('.slider').forEach(slider => {
 	const id = slider.dataset.id; // 'F', 'R', 'L', etc.
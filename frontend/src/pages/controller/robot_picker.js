@@ -0,0 +1,42 @@
+import { fetchRobots, getSelectedRobotHost, selectRobot } from '@/utils/robots.js';
+
+const REFRESH_INTERVAL_MS = 3000; // Beacons arrive every second and expire after five
+
+function robotLabel(robot) {
+	return robot.self ? `${robot.name} (this page)` : robot.name;
+}
+
+// Lists the robots on the arena network. Hidden when there is only one robot to choose from.
+export function setupRobotPicker(block, picker) {
+	const refresh = async () => {
+		if (document.activeElement === picker) return; // Don't rebuild the list while it's open
+
+		let robots;
+		try {
+			robots = await fetchRobots();
+		} catch (err) {
+			console.error('Could not list robots', err);
+			return;
+		}
+
+		const selected = getSelectedRobotHost();
+		block.style.display = robots.length > 1 ? '' : 'none';
+		picker.replaceChildren(...robots.map(robot => {
+			const option = document.createElement('option');
+			option.value = robot.ip;
+			option.textContent = `${robotLabel(robot)} - ${robot.ip}`;
+			if (robot.self) option.dataset.self = 'true';
+			option.selected = robot.ip === selected || (robot.self && selected === window.location.hostname);
+			return option;
+		}));
+	};
+
+	picker.addEventListener('change', () => {
+		// The robot that served the page is stored as the page's own host
+		const isSelf = picker.selectedOptions[0]?.dataset.self === 'true';
+		selectRobot(isSelf ? window.location.hostname : picker.value);
+	});
+
+	refresh();
+	setInterval(refresh, REFRESH_INTERVAL_MS);
+}
@@ -15,14 +15,119 @@ export function sendBoostData() {
 	ws.send(data);
 }
 
+// The robot stops its wheels if drive input goes quiet for a while (see CommandDeadline on the robot), so held
+// input is resent on a timer. Only non-zero wheel input is kept alive - stops are sent once, as before.
+const KEEPALIVE_INTERVAL_MS = 150;
+const WHEEL_SLIDERS = ['L', 'R'];
+const heldSliders = new Map();
+let keepaliveTimer = null;
+
+function resendHeldInput() {
+	if (lastSentJoystick && (lastSentJoystick.x !== 0 || lastSentJoystick.y !== 0)) {
+		ws.send(JSON.stringify(lastSentJoystick));
+	}
+	heldSliders.forEach((value, sliderName) => ws.send(JSON.stringify({ sliderName, value })));
+}
+
+function updateKeepalive() {
+	const isHeld = heldSliders.size > 0 || (lastSentJoystick && (lastSentJoystick.x !== 0 || lastSentJoystick.y !== 0));
+	if (isHeld && !keepaliveTimer) {
+		keepaliveTimer = setInterval(resendHeldInput, KEEPALIVE_INTERVAL_MS);
+	} else if (!isHeld && keepaliveTimer) {
+		clearInterval(keepaliveTimer);
+		keepaliveTimer = null;
+	}
+}
+
 export function sendSliderData(sliderName, value) {
 	const data = JSON.stringify({ sliderName, value });
 	console.log(data);
 	ws.send(data);
+
+	if (WHEEL_SLIDERS.includes(sliderName.toUpperCase())) {
+		if (Number(value) === 0) {
+			heldSliders.delete(sliderName);
+		} else {
+			heldSliders.set(sliderName, value);
+		}
+		updateKeepalive();
+	}
+}
+
+// Joystick positions arrive with every mousemove/touchmove, far more often than the robot can use them.
+// Only the latest position is sent, at most once per animation frame, and only if it changed.
+const JOYSTICK_RESOLUTION = 100; // Steps per unit, i.e. values are rounded to 0.01
+
+const joystickStats = { moves: 0, sent: 0, suppressed: 0 };
+let pendingJoystick = null;
+let lastSentJoystick = null;
+let joystickFrameRequested = false;
+
+function quantize(value) {
+	return Math.round(value * JOYSTICK_RESOLUTION) / JOYSTICK_RESOLUTION;
+}
+
+function flushJoystickData() {
+	joystickFrameRequested = false;
+	if (!pendingJoystick) return;
+
+	const { x, y } = pendingJoystick;
+	pendingJoystick = null;
+	if (lastSentJoystick && lastSentJoystick.x === x && lastSentJoystick.y === y) {
+		joystickStats.suppressed++;
+		return;
+	}
+
+	ws.send(JSON.stringify({ x, y }));
+	lastSentJoystick = { x, y };
+	joystickStats.sent++;
+	updateKeepalive();
 }
 
 export function sendJoystickData(x, y) {
-	const data = JSON.stringify({x, y});
+	joystickStats.moves++;
+	pendingJoystick = { x: quantize(x), y: quantize(y) };
+
+	// Stopping can't wait for the next frame (it may never come if the page is hidden)
+	if (pendingJoystick.x === 0 && pendingJoystick.y === 0) {
+		flushJoystickData();
+		return;
+	}
+
+	if (!joystickFrameRequested) {
+		joystickFrameRequested = true;
+		requestAnimationFrame(flushJoystickData);
+	}
+}
+
+// Compare with the robot's applied count from GET /control
+export function getJoystickStats() {
+	return { ...joystickStats };
+}
+
+// The robot sends { snapshot: 1, boost, flipper, battery, driver, client } to every client as it connects
+export function onRobotSnapshot(callback) {
+	ws.addOnMessage((data) => {
+		let message;
+		try {
+			message = JSON.parse(data);
+		} catch (err) {
+			return; // Other handlers report bad messages
+		}
+		if (message.snapshot) callback(message);
+	});
+}
+
+// Steps look like { move: [x, y], ms }, { flipper: angle, ms } or { boost: true, ms }.
+// The robot applies each step, then waits ms before the next one. An empty steps array deletes the macro.
+export function sendMacroDefinition(name, steps) {
+	const data = JSON.stringify({ macro: name, steps });
+	console.log(data);
+	ws.send(data);
+}
+
+export function sendRunMacro(name) {
+	const data = JSON.stringify({ runMacro: name });
 	console.log(data);
 	ws.send(data);
 }
@@ -0,0 +1,64 @@
+import requestRestart from '@/utils/request_restart.js';
+
+function showArenaMessage(text, isError = true) {
+	const formMessage = document.getElementById('arena-form-message');
+	formMessage.style.display = text ? 'block' : 'none';
+	formMessage.textContent = text;
+	formMessage.style.color = isError ? 'var(--red)' : '';
+}
+
+export async function loadArenaSettings() {
+	try {
+		const response = await fetch('/network');
+		const network = await response.json();
+
+		document.getElementById('arena-enabled').checked = network.arenaEnabled;
+		document.getElementById('arena-ssid').value = network.arenaSsid ?? '';
+		document.getElementById('arena-status').textContent = network.mode === 'arena'
+			? `Connected to the arena as ${network.ip} (channel ${network.channel}).`
+			: network.arenaEnabled
+				? "Arena network couldn't be joined - running our own network."
+				: 'Running our own network.';
+	} catch (error) {
+		console.error('Error:', error);
+	}
+}
+
+export async function arenaFormSubmissionHandler(e) {
+	e.preventDefault();
+	showArenaMessage('');
+
+	const arenaEnabled = document.getElementById('arena-enabled').checked;
+	const arenaSsid = document.getElementById('arena-ssid').value.trim();
+	const arenaPassword = document.getElementById('arena-password').value;
+
+	if (arenaEnabled && !arenaSsid) {
+		showArenaMessage('The arena network needs a name, comrade!');
+		return;
+	}
+	if (arenaPassword && arenaPassword.length < 8) {
+		showArenaMessage('WiFi passwords are at least 8 characters, comrade!');
+		return;
+	}
+
+	// An empty password field keeps the stored password
+	const data = { arenaEnabled, arenaSsid };
+	if (arenaPassword) data.arenaPassword = arenaPassword;
+
+	try {
+		const response = await fetch('/network', {
+			method: 'POST',
+			headers: { 'Content-Type': 'application/json' },
+			body: JSON.stringify(data)
+		});
+		const result = await response.json();
+		if (result.status !== 'ok') {
+			showArenaMessage(result.message || 'An error occurred. Please try again.');
+			return;
+		}
+		requestRestart();
+	} catch (error) {
+		console.error('Error:', error);
+		showArenaMessage('An error occurred. Please try again.');
+	}
+}
@@ -1,3 +1,5 @@
+import { waitForJob } from '@/utils/jobs.js';
+
 export async function calibrateBattery() {
 	try {
 		const response = await fetch('/calibrateBattery', { method: 'GET' });
@@ -5,10 +7,10 @@ export async function calibrateBattery() {
 			throw new Error(`Network response was not ok: ${response.statusText}`);
 		}
 		const result = await response.json(); // parse JSON
-		console.log('Battery calibration response:', result);
+		console.log('Battery calibration job:', result);
 
-		// Check if success is true
-		return result.success === true;
+		// Calibration runs in the background - wait for it to finish
+		return await waitForJob(result.job);
 	} catch (error) {
 		console.error('Error during battery calibration:', error);
 		return false;
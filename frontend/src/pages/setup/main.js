@@ -2,6 +2,7 @@ import Modal from '@/utils/Modal.js';
 import { calibrateBattery } from './battery.js';
 import { setupFormSubmissionHandler } from './forms.js';
 import { handleFactoryReset } from './factory_reset.js';
+import { loadArenaSettings, arenaFormSubmissionHandler } from './arena.js';
 import { setupBatteryWebsocket } from '@/utils/battery_websocket.js';
 
 setupBatteryWebsocket();
@@ -51,5 +52,7 @@ fetch('img/star.svg')
 
 // Setup form submissions
 document.getElementById('setup-form').addEventListener('submit', setupFormSubmissionHandler);
+document.getElementById('arena-form').addEventListener('submit', arenaFormSubmissionHandler);
+loadArenaSettings();
 
 document.getElementById('factory-reset-button').addEventListener('click', handleFactoryReset);
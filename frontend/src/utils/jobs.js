@@ -0,0 +1,59 @@
+import ws from './websocket.js';
+
+const POLL_INTERVAL_MS = 500;
+const FINISHED = ['succeeded', 'failed'];
+
+/**
+ * Wait for a job started by an HTTP handler to finish.
+ * Resolves on whichever comes first: the robot's {job, status} WebSocket message or a /jobs poll.
+ * The WebSocket is only trusted when it's connected to the robot that served the page (and runs the job):
+ * in arena mode it may be driving another robot, whose job IDs overlap.
+ * @param {number} id - Job ID returned by the handler.
+ * @param {number} [timeoutMs=15000]
+ * @returns {Promise<boolean>} Whether the job succeeded. False on timeout.
+ */
+export function waitForJob(id, timeoutMs = 15000) {
+	return new Promise((resolve) => {
+		let settled = false;
+		let pollTimer = null;
+
+		const onMessage = (data) => {
+			try {
+				const message = JSON.parse(data);
+				if (message.job === id && FINISHED.includes(message.status)) finish(message.status);
+			} catch (err) {
+				// Not a job message
+			}
+		};
+		const isSocketToThisRobot = new URL(ws.url).hostname === window.location.hostname;
+
+		const finish = (status) => {
+			if (settled) return;
+			settled = true;
+			clearTimeout(pollTimer);
+			clearTimeout(timeoutTimer);
+			ws.removeOnMessage(onMessage);
+			resolve(status === 'succeeded');
+		};
+
+		if (isSocketToThisRobot) ws.addOnMessage(onMessage);
+
+		const poll = async () => {
+			if (settled) return;
+			try {
+				const response = await fetch(`/jobs?id=${id}`);
+				const result = await response.json();
+				if (FINISHED.includes(result.status)) {
+					finish(result.status);
+					return;
+				}
+			} catch (error) {
+				console.error('Error polling job:', error);
+			}
+			pollTimer = setTimeout(poll, POLL_INTERVAL_MS);
+		};
+
+		const timeoutTimer = setTimeout(() => finish('timeout'), timeoutMs);
+		poll();
+	});
+}
@@ -0,0 +1,48 @@
+// Arena mode: robots share one network, so the robot that served this page may not be the one we drive.
+// The selection lasts for the browser tab, so a new tab always starts with the robot that served it.
+const SELECTED_ROBOT_KEY = 'robotHost';
+// The host simulator (envs/sim.ini) serves its WebSocket on another port: open the page with ?wsPort=8081
+const WEBSOCKET_PORT_KEY = 'robotWsPort';
+const DEFAULT_WEBSOCKET_PORT = 81;
+
+/**
+ * Host (IP) of the robot to open the control session with.
+ * @returns {string}
+ */
+export function getSelectedRobotHost() {
+	return sessionStorage.getItem(SELECTED_ROBOT_KEY) || window.location.hostname;
+}
+
+/**
+ * WebSocket port of the robot to open the control session with.
+ * @returns {number}
+ */
+export function getSelectedRobotWebSocketPort() {
+	const fromQuery = new URLSearchParams(window.location.search).get('wsPort');
+	if (fromQuery) sessionStorage.setItem(WEBSOCKET_PORT_KEY, fromQuery);
+	return Number(sessionStorage.getItem(WEBSOCKET_PORT_KEY)) || DEFAULT_WEBSOCKET_PORT;
+}
+
+/**
+ * Switch the control session to another robot. Reloads the page so every connection moves over.
+ * @param {string} host - IP of the robot, or the page's own host to go back to the robot that served it.
+ */
+export function selectRobot(host) {
+	if (!host || host === window.location.hostname) {
+		sessionStorage.removeItem(SELECTED_ROBOT_KEY);
+	} else {
+		sessionStorage.setItem(SELECTED_ROBOT_KEY, host);
+	}
+	window.location.reload();
+}
+
+/**
+ * Robots announced on the arena network, including the one that served this page.
+ * @returns {Promise<Array<{name: string, ip: string, ws: number, self?: boolean}>>}
+ */
+export async function fetchRobots() {
+	const response = await fetch('/robots');
+	if (!response.ok) throw new Error(`GET /robots failed: ${response.status}`);
+	const data = await response.json();
+	return data.robots ?? [];
+}
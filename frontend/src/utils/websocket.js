@@ -1,18 +1,25 @@
+import { getSelectedRobotHost, getSelectedRobotWebSocketPort } from './robots.js';
+
+// After a drop the first retry is immediate, then the delay doubles from here up to maxReconnectDelay
+const FIRST_BACKOFF_MS = 250;
+
 export class WebSocketClient {
   /**
    * Create a new WebSocketClient.
    * @param {string} url - The WebSocket server URL.
    * @param {string | string[]} [protocols] - Optional protocols.
-   * @param {number} [reconnectInterval=5000] - Interval (in ms) between reconnection attempts.
-   * @param {number} [maxReconnectAttempts=10] - Maximum number of reconnection attempts.
+   * @param {number} [maxReconnectDelay=5000] - Longest wait (in ms) between reconnection attempts.
+   * @param {number} [maxReconnectAttempts=Infinity] - Maximum number of reconnection attempts in a row.
    */
-  constructor(url, protocols, reconnectInterval = 5000, maxReconnectAttempts = 10) {
-    this.url = url || `${window.location.protocol === 'https:' ? 'wss' : 'ws'}://${window.location.host}:81`;
+  constructor(url, protocols, maxReconnectDelay = 5000, maxReconnectAttempts = Infinity) {
+    // hostname, not host: host already carries the page's port when it isn't 80
+    this.url = url || `${window.location.protocol === 'https:' ? 'wss' : 'ws'}://${getSelectedRobotHost()}:${getSelectedRobotWebSocketPort()}`;
     this.protocols = protocols;
     this.ws = null;
-    this.reconnectInterval = reconnectInterval;
+    this.maxReconnectDelay = maxReconnectDelay;
     this.maxReconnectAttempts = maxReconnectAttempts;
     this.reconnectAttempts = 0;
+    this.reconnectTimer = null;
 
     // Delegate containers: arrays for each type of event.
     this.onOpenCallbacks = [];
@@ -58,19 +65,40 @@ export class WebSocketClient {
   }
 
   /**
-   * Handle reconnection attempts.
+   * Handle reconnection attempts: immediately, then with exponential backoff.
+   * The robot sends a state snapshot as soon as the connection opens, so nothing else has to be waited for.
    */
   handleReconnection() {
-    if (this.reconnectAttempts < this.maxReconnectAttempts) {
-      this.reconnectAttempts++;
-      console.log(`Reconnection attempt ${this.reconnectAttempts} of ${this.maxReconnectAttempts}`);
-      setTimeout(() => {
-        console.log('Attempting to reconnect...');
-        this.connect();
-      }, this.reconnectInterval);
-    } else {
+    if (this.reconnectTimer) {
+      return; // Already scheduled
+    }
+    if (this.reconnectAttempts >= this.maxReconnectAttempts) {
       console.log('Max reconnection attempts reached. No further attempts will be made.');
+      return;
+    }
+
+    const delay = this.reconnectAttempts === 0
+      ? 0
+      : Math.min(this.maxReconnectDelay, FIRST_BACKOFF_MS * 2 ** (this.reconnectAttempts - 1));
+    this.reconnectAttempts++;
+    console.log(`Reconnection attempt ${this.reconnectAttempts} in ${delay} ms`);
+    this.reconnectTimer = setTimeout(() => {
+      this.reconnectTimer = null;
+      this.connect();
+    }, delay);
+  }
+
+  /**
+   * Skip any remaining backoff, e.g. when the network comes back or the page is shown again.
+   */
+  reconnectNow() {
+    if (!this.ws || this.ws.readyState === WebSocket.OPEN || this.ws.readyState === WebSocket.CONNECTING) {
+      return; // Never connected, or nothing to do
     }
+    clearTimeout(this.reconnectTimer);
+    this.reconnectTimer = null;
+    this.reconnectAttempts = 0;
+    this.connect();
   }
 
   /**
@@ -93,6 +121,14 @@ export class WebSocketClient {
     }
   }
 
+  /**
+   * Remove a callback added with addOnMessage.
+   * @param {Function} callback
+   */
+  removeOnMessage(callback) {
+    this.onMessageCallbacks = this.onMessageCallbacks.filter((cb) => cb !== callback);
+  }
+
   /**
    * Add a callback for the error event.
    * @param {Function} callback
@@ -137,6 +173,12 @@ export class WebSocketClient {
   }
 }
 
-// Export a singleton instance with a specific URL
+// Export a singleton instance connected to the selected robot (see robots.js)
 const wsClient = new WebSocketClient();
+window.addEventListener('online', () => wsClient.reconnectNow());
+document.addEventListener('visibilitychange', () => {
+  if (document.visibilityState === 'visible') {
+    wsClient.reconnectNow();
+  }
+});
 export default wsClient;
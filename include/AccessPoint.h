@@ -9,6 +9,11 @@
 #include <ArduinoJson.h>
 #include <functional>
 
+#include "CaptivePortal.h"
+#include "CommandRateLimiter.h"
+#include "RobotBeacon.h"
+#include "UdpControlChannel.h"
+
 extern QueueHandle_t robotQueue;
 
 namespace PalookaNetwork
@@ -28,20 +33,60 @@ namespace PalookaNetwork
 		const char* contentType; // Proper MIME type
 		HttpMethod method; // HTTP Request type
 		std::function<void(WebServer* server)> handler; // Callback function to process request
+		std::function<void(WebServer* server)> uploadHandler; // Called for each chunk of a multipart file upload, before handler
 
 		Route(const char* ep,
 				const char* path,
 				const char* type = "text/html",
 				HttpMethod httpMethod = HttpMethod::GET,
-				std::function<void(WebServer* server)> callback = nullptr) // nullptr default means no specific function, just serve the file
+				std::function<void(WebServer* server)> callback = nullptr, // nullptr default means no specific function, just serve the file
+				std::function<void(WebServer* server)> uploadCallback = nullptr)
 			: endpoint(ep),
 			filePath(path),
 			contentType(type),
 			method(httpMethod),
-			handler(callback)
+			handler(callback),
+			uploadHandler(uploadCallback)
 		{}
 	};
 
+	// Radio options stored alongside the AP name and password
+	struct RadioConfig {
+		static constexpr uint8_t AUTO_CHANNEL = 0; // Scan at boot and pick the least congested channel
+		static constexpr int8_t MIN_TX_POWER = 8; // Quarter-dBm units, as used by esp_wifi_set_max_tx_power()
+		static constexpr int8_t MAX_TX_POWER = 78; // 19.5 dBm
+
+		uint8_t channel{AUTO_CHANNEL};
+		int8_t txPowerQuarterDbm{MAX_TX_POWER};
+		uint8_t bandwidthMhz{20}; // 20 or 40
+
+		bool isValid() const;
+		static RadioConfig load();
+		void save() const;
+	};
+
+	// Arena mode: join a shared network as a station instead of running an AP, so one controller
+	// can reach every robot without switching WiFi networks. Falls back to the AP if the network can't be joined.
+	struct ArenaConfig {
+		static constexpr uint32_t CONNECT_TIMEOUT_MS = 15000;
+
+		bool enabled{false};
+		String ssid;
+		String password; // Empty for an open network
+
+		bool isValid() const;
+		static ArenaConfig load();
+		void save() const;
+	};
+
+	// Counters for comparing what clients sent with what reached the robot
+	struct ControlStats {
+		uint32_t continuousReceived; // Joystick and slider messages, over the WebSocket or UDP
+		uint32_t rateLimited; // Held back by the rate limit, then replaced by a newer command before it could be sent
+		uint32_t udpAccepted; // UDP frames that reached the robot queue
+		uint32_t udpDropped;
+	};
+
 	struct CommandData {
 		char sliderName[16];
 		bool hasSlider;
@@ -49,7 +94,12 @@ namespace PalookaNetwork
 		float x, y;
 		bool hasJoystick;
 		bool flip;
-		bool toggleBoost;
+		char macroName[16];
+		bool runMacro;
+		uint32_t receivedMs; // millis() when the command arrived, so the robot task can drop stale ones
+
+		// Releasing the stick or centring a slider
+		inline bool isStop() const { return hasJoystick ? (x == 0.0f && y == 0.0f) : (hasSlider && value == 0); }
 	};
 
 	class AccessPoint
@@ -65,17 +115,63 @@ namespace PalookaNetwork
 					const String& SSID_BASE = "Palooka_");
 
 			bool begin();
-			void handleWebSocketMessage(uint8_t *payload, size_t length);
+			void handleWebSocketMessage(uint8_t clientNum, uint8_t *payload, size_t length);
 			void handleClients();
 			void sendWebSocketMessage(const String& message);
+			inline uint8_t getChannel() const { return channel; }
+			inline bool isArenaMode() const { return arenaMode; }
+			IPAddress getIP() const;
+			inline const String& getName() const { return name; }
+			inline size_t getArenaRobots(RobotBeacon::Robot* out, size_t maxRobots) const { return beacon.getRobots(out, maxRobots); }
+			inline uint16_t getWebSocketPort() const { return WEB_SOCKET_PORT; }
+
+			// Per-client cap on joystick and slider messages. Stored across restarts, 0 disables it.
+			void setMaxCommandRate(uint16_t perSecond);
+			inline uint16_t getMaxCommandRate() const { return maxCommandRate; }
+			ControlStats getControlStats() const;
+
+			inline CaptivePortal::FamilyStats getCaptivePortalStats(CaptivePortal::Family family) {
+				return captivePortal ? captivePortal->getStats(family) : CaptivePortal::FamilyStats{};
+			}
 
 		private:
 			WebServer server;
 			WebSocketsServer webSocket;
 			DNSServer dnsServer;
+			UdpControlChannel udpControl;
+			RobotBeacon beacon;
+			CaptivePortal* captivePortal{nullptr}; // Owned by server, which deletes its handlers
+
+			static constexpr uint16_t DEFAULT_MAX_COMMAND_RATE = 50; // Per second, a little under a 60 Hz display
+			uint16_t maxCommandRate{DEFAULT_MAX_COMMAND_RATE};
+			CommandRateLimiter rateLimiters[WEBSOCKETS_SERVER_CLIENT_MAX];
+			// Newest joystick or slider command each client had rate limited, sent once its limiter allows.
+			// Without it a stick that stops moving right after a limited frame would stay on the older value.
+			CommandData heldCommands[WEBSOCKETS_SERVER_CLIENT_MAX]{};
+			bool isCommandHeld[WEBSOCKETS_SERVER_CLIENT_MAX]{};
+			uint32_t continuousReceived{0};
+			uint32_t rateLimited{0};
+			uint32_t udpAccepted{0};
+			uint32_t udpQueueFull{0};
+			int8_t driverClient{-1}; // Last client whose joystick or slider input was accepted, -1 if none
 			uint16_t DNS_SERVER_PORT;
+			const uint16_t WEB_SOCKET_PORT;
+			uint8_t channel{1};
+			bool arenaMode{false};
+			String name;
 
 			const String generateSSID(const String& SSID_BASE);
+			uint8_t scanForLeastCongestedChannel();
+			bool beginAccessPoint(const String& password, const RadioConfig& radioConfig);
+			bool joinArena(const ArenaConfig& arenaConfig, const RadioConfig& radioConfig);
+			void applyRadioConfig(const RadioConfig& config, wifi_interface_t interface);
+			void handleMacroUpload(uint8_t *payload, size_t length);
+			void openUdpSession(uint8_t clientNum);
+			void pollUdpControl();
+			bool admitContinuous(uint8_t clientNum, const CommandData& cmdData);
+			void sendHeldCommands();
+			void replyToPing(uint8_t clientNum, uint32_t id);
+			void sendSnapshot(uint8_t clientNum);
 			void registerServerRoutes();
 			void serveFile(const char* filePath, const char* contentType);
 	};
@@ -14,6 +14,16 @@ namespace PalookaNetwork {
 			bool begin();
 			void handleClients();
 			void sendWebSocketMessage(const String& message);
+			inline uint8_t getChannel() const { return ap.getChannel(); }
+			inline bool isArenaMode() const { return ap.isArenaMode(); }
+			inline IPAddress getIP() const { return ap.getIP(); }
+			inline const String& getName() const { return ap.getName(); }
+			inline uint16_t getWebSocketPort() const { return ap.getWebSocketPort(); }
+			inline size_t getArenaRobots(RobotBeacon::Robot* out, size_t maxRobots) const { return ap.getArenaRobots(out, maxRobots); }
+			inline void setMaxCommandRate(uint16_t perSecond) { ap.setMaxCommandRate(perSecond); }
+			inline uint16_t getMaxCommandRate() const { return ap.getMaxCommandRate(); }
+			inline ControlStats getControlStats() const { return ap.getControlStats(); }
+			inline CaptivePortal::FamilyStats getCaptivePortalStats(CaptivePortal::Family family) { return ap.getCaptivePortalStats(family); }
 
 		private:
 			static const Route AP_ROUTES[];
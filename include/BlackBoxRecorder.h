@@ -0,0 +1,87 @@
+#ifndef ROBOT_BLACK_BOX_RECORDER_H
+#define ROBOT_BLACK_BOX_RECORDER_H
+
+#include <Arduino.h>
+#include <mutex>
+#include <vector>
+
+#include <PalookaBot/FlipperBot.h>
+
+namespace Robot {
+	// Records the last few seconds of robot state into a ring buffer in RTC memory, which is left alone by
+	// watchdog, panic, brownout and software resets. After such a reset the previous recording is kept for export.
+	// Owned and driven by the robot task.
+	//
+	// Export format (all little-endian, decoded by dev_scripts/blackbox_decode.py):
+	//   FileHeader, then FileHeader::count Records, oldest first.
+	class BlackBoxRecorder {
+		public:
+			static constexpr uint32_t MAGIC = 0x58424250; // "PBBX"
+			static constexpr uint8_t FORMAT_VERSION = 1;
+			static constexpr uint16_t SAMPLE_PERIOD_MS = 50;
+			static constexpr size_t CAPACITY = 256; // 12.8 seconds at SAMPLE_PERIOD_MS
+
+			static constexpr uint16_t NO_COMMAND = 0xFFFF; // sinceCommandMs when no command arrived in the last 65 s
+
+			enum Flags : uint8_t {
+				FLAG_BOOST = 1 << 0,
+				FLAG_ACTUATORS_ASLEEP = 1 << 1,
+				FLAG_MACRO_RUNNING = 1 << 2,
+			};
+
+			struct __attribute__((packed)) Record {
+				uint32_t timeMs;		// millis() when sampled
+				uint16_t batteryMv;
+				int16_t leftVelocity;	// -255 to 255
+				int16_t rightVelocity;
+				uint8_t flipperAngle;
+				uint8_t flags;			// Flags
+				uint16_t sinceCommandMs;	// Age of the newest command, saturates at NO_COMMAND
+				uint8_t commands;		// Commands that arrived since the previous sample, saturates at 255
+				uint8_t reserved;
+			};
+			static_assert(sizeof(Record) == 16, "Record layout is part of the export format");
+
+			struct __attribute__((packed)) FileHeader {
+				uint32_t magic;
+				uint8_t version;
+				uint8_t recordSize;
+				uint8_t resetReason;	// esp_reset_reason_t that ended the recording, 0 for the live recording
+				uint8_t reserved;
+				uint16_t samplePeriodMs;
+				uint16_t count;
+				uint32_t bootCount;		// Consecutive boots with intact RTC memory
+			};
+			static_assert(sizeof(FileHeader) == 16, "FileHeader layout is part of the export format");
+
+			explicit BlackBoxRecorder(PalookaBot::FlipperBot& robot) : robot(robot) {}
+
+			// Saves the recording left by the previous boot (if it survived) and starts a new one
+			void begin();
+
+			// Call when a command arrives
+			void noteCommand();
+			// Call from the robot task loop. Records a sample when one is due.
+			void update(bool isMacroRunning);
+			uint32_t msUntilNextSample() const;
+
+			inline bool hasPreviousRecording() const { return !previousRecording.empty(); }
+			// Returns the export file, or an empty vector if there is no previous recording
+			std::vector<uint8_t> exportPrevious() const { return previousRecording; }
+			std::vector<uint8_t> exportCurrent();
+
+		private:
+			PalookaBot::FlipperBot& robot;
+
+			std::mutex ringMutex; // The ring is written by the robot task and exported from the network task
+			std::vector<uint8_t> previousRecording;
+
+			bool isStarted{false};
+			uint32_t nextSampleMs{0};
+			uint32_t lastCommandMs{0};
+			bool hasCommand{false};
+			uint8_t commandsSinceSample{0};
+	};
+}
+
+#endif // ROBOT_BLACK_BOX_RECORDER_H
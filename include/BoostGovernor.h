@@ -0,0 +1,106 @@
+#ifndef ROBOT_BOOST_GOVERNOR_H
+#define ROBOT_BOOST_GOVERNOR_H
+
+#include <Arduino.h>
+#include <atomic>
+
+namespace Robot {
+	// Turns the servo boost on for bursts of demand (a flip, or the stick pushed to full) and off again shortly after,
+	// within two budgets that stand in for the servo's limits:
+	//  - Heat: first order, rising towards BOOSTED_STEADY_HEAT while boosted and falling towards 0 otherwise,
+	//    with a time constant of heatTimeConstantMs. 1.0 is the limit, so sustained boost is cut off.
+	//  - Duty: a bucket of boost time that refills at maxDutyCycle and holds up to dutyBurstMs.
+	// Either running out turns boost off until it has recovered past its resume level. Boost is also refused while
+	// the battery is low. The driver's boost button arms and disarms the governor.
+	//
+	// Only decides - the robot task applies the decision (see RobotTaskManager) - so it runs unchanged on the host.
+	// Owned and driven by the robot task.
+	class BoostGovernor {
+		public:
+			static constexpr float BOOSTED_STEADY_HEAT = 2.0f; // Reaches the limit after ~0.7 time constants from cold
+
+			struct Config {
+				uint32_t holdMs{800};				// Boost stays on this long after the last demand
+				uint32_t heatTimeConstantMs{60000};
+				float heatResume{0.6f};			// After a heat cut-off, boost is allowed again below this
+				float maxDutyCycle{0.25f};			// Long-run share of time boosted
+				uint32_t dutyBurstMs{12000};		// Most boost time that can be saved up
+				uint32_t dutyResumeMs{3000};		// After running out, boost is allowed again above this
+				int lowBatteryPercent{15};			// Refused at or below this (3.73 V at rest), above the low battery warning
+			};
+
+			enum class Reason : uint8_t {
+				IDLE,			// Off - no recent demand
+				DEMAND,			// On
+				DISARMED,		// Off - the driver turned the governor off
+				HEAT_LIMIT,		// Off until cooled to heatResume
+				DUTY_LIMIT,		// Off until dutyResumeMs has built up
+				LOW_BATTERY		// Off until the battery reads above lowBatteryPercent
+			};
+
+			struct Report {
+				bool isArmed;
+				bool isBoosted;
+				Reason reason;
+				float heat;				// 1.0 is the limit
+				uint32_t dutyCreditMs;
+				uint32_t boostCount;
+				uint32_t cutoffCount;	// Heat, duty or battery ended a boost that was still wanted
+				uint32_t totalBoostedMs;
+			};
+
+			BoostGovernor(); // Default Config
+			explicit BoostGovernor(const Config& config);
+
+			void begin(); // Loads whether the driver armed it
+
+			// Saved, so call from the network task rather than the robot task
+			void setArmed(bool isArmed);
+			inline void toggleArmed() { setArmed(!armed); }
+			inline bool isArmed() const { return armed; }
+
+			// Call when a command asks for full power: a flip, or a drive command at full stick
+			void noteDemand(uint32_t nowMs);
+			// Demand that lasts until withdrawn, for a macro's BOOST steps. The limits and arming still apply.
+			inline void request(const bool isWanted) { isRequested = isWanted; }
+			void noteBatteryPercent(int percent);
+
+			// Advances the budgets to nowMs and returns whether boost should be on. Transitions are logged.
+			bool update(uint32_t nowMs);
+
+			inline bool isBoosted() const { return boosted; }
+			inline Reason getReason() const { return reason; }
+			Report getReport() const;
+			static const char* reasonName(Reason reason);
+
+		private:
+			const Config config;
+			static constexpr const char *PREFS_NAMESPACE = "PalookaBot";
+			static constexpr const char *PREFS_ARMED = "Boost::armed";
+
+			std::atomic<bool> armed{false}; // Set by the network task, read by the robot task
+
+			bool boosted{false};
+			Reason reason{Reason::IDLE};
+			bool hasDemand{false};
+			bool isRequested{false};
+			uint32_t lastDemandMs{0};
+			int batteryPercent{-1}; // Unknown until the first reading - not treated as low
+
+			float heat{0.0f};
+			bool isCoolingDown{false};
+			float dutyCreditMs;
+			bool isRecharging{false};
+			uint32_t lastUpdateMs{0};
+			bool hasUpdated{false};
+
+			uint32_t boostCount{0};
+			uint32_t cutoffCount{0};
+			uint32_t totalBoostedMs{0};
+
+			void advance(uint32_t elapsedMs); // Heat and duty over time spent in the current state
+			Reason decide(uint32_t nowMs);
+	};
+}
+
+#endif // ROBOT_BOOST_GOVERNOR_H
@@ -0,0 +1,72 @@
+#ifndef PALOOKANETWORK_CAPTIVEPORTAL_H
+#define PALOOKANETWORK_CAPTIVEPORTAL_H
+
+#include <WiFi.h>
+#include <WebServer.h>
+#include <mutex>
+
+namespace PalookaNetwork {
+	// Answers the connectivity checks phones and laptops make when they join a network, before any route or
+	// file lookup. The AP's DNS server sends every host name to the robot, so the checks arrive here.
+	//
+	// Each check gets the exact reply its OS expects from a working internet connection. Then the device
+	// keeps the network as its default, opens no captive-portal sign-in sheet, and doesn't drop the
+	// network for "no internet". The controller needs a full browser (WebSocket, fullscreen), which
+	// sign-in sheets don't give it.
+	//
+	// It also times each device from getting its DHCP lease to opening the controller's WebSocket.
+	// The times are grouped by the OS family its checks identified.
+	class CaptivePortal : public RequestHandler {
+		public:
+			enum class Family : uint8_t { ANDROID, APPLE, WINDOWS, OTHER, COUNT };
+
+			struct FamilyStats {
+				uint32_t probes;				// Checks answered
+				uint32_t controllers;			// Devices that went on to open the controller
+				uint32_t lastJoinToControllerMs;
+				uint32_t maxJoinToControllerMs;
+			};
+
+			static constexpr size_t MAX_STATIONS = 10; // Most stations a softAP accepts
+
+			void begin(); // Starts watching for DHCP leases. AP mode only.
+
+			// Call when a WebSocket client connects
+			void noteControllerConnected(const IPAddress& ip);
+			FamilyStats getStats(Family family);
+			static const char* familyToString(Family family);
+
+			// RequestHandler
+			bool canHandle(HTTPMethod method, String uri) override;
+			bool handle(WebServer& server, HTTPMethod requestMethod, String requestUri) override;
+
+		private:
+			struct Probe {
+				const char* path;
+				Family family;
+				int code;
+				const char* contentType;
+				const char* body;
+			};
+
+			struct Station {
+				uint32_t ip; // 0 marks an unused entry
+				uint32_t joinedMs;
+				Family family;
+				bool reachedController;
+			};
+
+			static const Probe PROBES[];
+			static const size_t NUM_PROBES;
+
+			std::mutex stationsMutex; // Leases are recorded from the WiFi event task
+			Station stations[MAX_STATIONS]{};
+			FamilyStats stats[static_cast<size_t>(Family::COUNT)]{};
+
+			static const Probe* find(const String& uri);
+			void noteJoined(uint32_t ip);
+			Station* findStation(uint32_t ip); // Callers must hold stationsMutex
+	};
+}
+
+#endif // PALOOKANETWORK_CAPTIVEPORTAL_H
@@ -0,0 +1,62 @@
+#ifndef PALOOKANETWORK_CHANNELSCORER_H
+#define PALOOKANETWORK_CHANNELSCORER_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Kept free of Arduino/ESP-IDF includes so recorded scans can be scored on a host machine.
+namespace PalookaNetwork::ChannelScorer {
+	struct ScanResult {
+		uint8_t channel;
+		int8_t rssi; // dBm
+	};
+
+	// Non-overlapping 2.4 GHz channels - the only sensible choices when neighbours use them too
+	constexpr uint8_t DEFAULT_CANDIDATES[]{1, 6, 11};
+	constexpr size_t NUM_DEFAULT_CANDIDATES{sizeof(DEFAULT_CANDIDATES) / sizeof(DEFAULT_CANDIDATES[0])};
+
+	constexpr int8_t NOISE_FLOOR_DBM = -95;
+
+	// How much of a 20 MHz network on a channel `distance` channels away overlaps ours (channels are 5 MHz apart)
+	constexpr float overlapWeight(const unsigned distance) {
+		constexpr float WEIGHTS[]{1.0f, 0.7f, 0.4f, 0.15f, 0.05f};
+		return distance < (sizeof(WEIGHTS) / sizeof(WEIGHTS[0])) ? WEIGHTS[distance] : 0.0f;
+	}
+
+	// Interference on a channel. Every overlapping network costs airtime, and loud ones cost more.
+	// Lower is better.
+	inline float scoreChannel(const uint8_t channel, const ScanResult* results, const size_t numResults) {
+		float score{0.0f};
+		for (size_t i{0}; i < numResults; ++i) {
+			const unsigned distance = results[i].channel > channel ? results[i].channel - channel : channel - results[i].channel;
+			const float weight = overlapWeight(distance);
+			if (weight <= 0.0f) continue;
+
+			// Power above the noise floor, in units of the noise floor (linear, not dB)
+			const float aboveFloorDb = static_cast<float>(results[i].rssi - NOISE_FLOOR_DBM);
+			const float power = aboveFloorDb > 0.0f ? std::pow(10.0f, aboveFloorDb / 10.0f) : 0.0f;
+			score += weight * (1.0f + std::log10(1.0f + power)); // Log so one loud AP doesn't outweigh a crowd
+		}
+		return score;
+	}
+
+	// Returns the candidate with the lowest score. Ties go to the earliest candidate.
+	inline uint8_t pickChannel(const ScanResult* results, const size_t numResults,
+			const uint8_t* candidates = DEFAULT_CANDIDATES, const size_t numCandidates = NUM_DEFAULT_CANDIDATES) {
+		if (!candidates || numCandidates == 0) return DEFAULT_CANDIDATES[0];
+
+		uint8_t best = candidates[0];
+		float bestScore = scoreChannel(best, results, numResults);
+		for (size_t i{1}; i < numCandidates; ++i) {
+			const float score = scoreChannel(candidates[i], results, numResults);
+			if (score < bestScore) {
+				best = candidates[i];
+				bestScore = score;
+			}
+		}
+		return best;
+	}
+}
+
+#endif // PALOOKANETWORK_CHANNELSCORER_H
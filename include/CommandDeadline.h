@@ -0,0 +1,61 @@
+#ifndef ROBOT_COMMAND_DEADLINE_H
+#define ROBOT_COMMAND_DEADLINE_H
+
+#include <Arduino.h>
+
+#include <PalookaBot/FlipperBot.h>
+
+namespace Robot {
+	// Keeps old control input from moving the robot. Owned and driven by the robot task.
+	//  - Commands are stamped with millis() when they arrive and dropped if they waited longer than the max age
+	//    (in the queue, or behind a slow battery read). Stops are never dropped.
+	//  - If the wheels are turning and no joystick or wheel slider input has arrived for the silence window,
+	//    e.g. because the phone went out of range, the wheels are stopped. The controller resends held input
+	//    every 150 ms so a steady stick doesn't count as silence.
+	class CommandDeadline {
+		public:
+			static constexpr uint32_t DEFAULT_MAX_AGE_MS = 250;
+			static constexpr uint32_t MIN_MAX_AGE_MS = 50; // Commands wait a loop or two even when all is well
+			static constexpr uint32_t DEFAULT_SILENCE_STOP_MS = 500;
+			static constexpr uint32_t MIN_SILENCE_STOP_MS = 300; // Two controller resends
+
+			struct Report {
+				uint32_t maxAgeMs;
+				uint32_t silenceStopMs;
+				uint32_t expired;		// Commands dropped for being too old
+				uint32_t silenceStops;	// Times the wheels were stopped for lack of input
+			};
+
+			explicit CommandDeadline(PalookaBot::FlipperBot& robot) : robot(robot) {}
+
+			void begin(); // Loads the settings
+
+			// Returns false, and counts the command as expired, if a command received at receivedMs is too old to apply
+			bool isFresh(uint32_t receivedMs);
+			// Call after applying joystick or wheel slider input
+			inline void noteDriveInput(uint32_t receivedMs) { lastDriveInputMs = receivedMs; }
+			// Call from the robot task loop. Macros drive the wheels without input, so nothing is stopped while one runs.
+			void update(bool isMacroRunning);
+
+			// Stored across restarts. Values below MIN_MAX_AGE_MS are rejected, 0 disables the check.
+			bool setMaxAge(uint32_t maxAgeMs);
+			// Stored across restarts. Values below MIN_SILENCE_STOP_MS are rejected, 0 disables the stop.
+			bool setSilenceStop(uint32_t silenceStopMs);
+			Report getReport() const;
+
+		private:
+			PalookaBot::FlipperBot& robot;
+
+			uint32_t maxAgeMs{DEFAULT_MAX_AGE_MS};
+			uint32_t silenceStopMs{DEFAULT_SILENCE_STOP_MS};
+			uint32_t lastDriveInputMs{0};
+			uint32_t expired{0};
+			uint32_t silenceStops{0};
+
+			static constexpr const char *PREFS_NAMESPACE = "PalookaBot";
+			static constexpr const char *PREFS_MAX_AGE = "Cmd::maxAgeMs";
+			static constexpr const char *PREFS_SILENCE_STOP = "Cmd::silenceMs";
+	};
+}
+
+#endif // ROBOT_COMMAND_DEADLINE_H
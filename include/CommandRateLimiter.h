@@ -0,0 +1,42 @@
+#ifndef PALOOKANETWORK_COMMANDRATELIMITER_H
+#define PALOOKANETWORK_COMMANDRATELIMITER_H
+
+#include <cstdint>
+
+namespace PalookaNetwork {
+	// Token bucket that caps how many continuous commands one client may push into the robot queue.
+	// A small burst allowance absorbs WiFi jitter bunching frames together.
+	class CommandRateLimiter {
+		public:
+			static constexpr float BURST = 3.0f;
+
+			// 0 disables limiting
+			void setMaxRate(const uint16_t perSecond) { maxPerSecond = perSecond; }
+			uint16_t getMaxRate() const { return maxPerSecond; }
+
+			void reset() { tokens = BURST; hasLast = false; }
+
+			bool allow(const uint32_t nowMs) {
+				if (maxPerSecond == 0) return true;
+
+				if (hasLast) {
+					tokens += (nowMs - lastMs) * (maxPerSecond / 1000.0f);
+					if (tokens > BURST) tokens = BURST;
+				}
+				lastMs = nowMs;
+				hasLast = true;
+
+				if (tokens < 1.0f) return false;
+				tokens -= 1.0f;
+				return true;
+			}
+
+		private:
+			uint16_t maxPerSecond{0};
+			float tokens{BURST};
+			uint32_t lastMs{0};
+			bool hasLast{false};
+	};
+}
+
+#endif // PALOOKANETWORK_COMMANDRATELIMITER_H
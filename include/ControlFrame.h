@@ -0,0 +1,87 @@
+#ifndef PALOOKANETWORK_CONTROLFRAME_H
+#define PALOOKANETWORK_CONTROLFRAME_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Binary joystick frames for the UDP control channel.
+// Kept free of Arduino/ESP-IDF includes so the format and filtering can be exercised on a host machine.
+//
+// Layout (little-endian, 14 bytes):
+//   0  'P' 'K'   magic
+//   2  uint8     version
+//   3  uint8     flags (reserved, 0)
+//   4  uint16    session token handed out over the WebSocket
+//   6  uint32    sequence number, incremented per frame by the sender
+//   10 int16     x scaled by AXIS_SCALE
+//   12 int16     y scaled by AXIS_SCALE
+namespace PalookaNetwork::ControlFrame {
+	constexpr uint8_t MAGIC_0 = 'P';
+	constexpr uint8_t MAGIC_1 = 'K';
+	constexpr uint8_t VERSION = 1;
+	constexpr size_t SIZE = 14;
+	constexpr float AXIS_SCALE = 32767.0f;
+
+	struct Frame {
+		uint16_t token;
+		uint32_t sequence;
+		float x, y;
+	};
+
+	inline size_t encode(const Frame& frame, uint8_t* buffer, const size_t bufferSize) {
+		if (!buffer || bufferSize < SIZE) return 0;
+
+		const auto toAxis = [](float value) -> int16_t {
+			value = value > 1.0f ? 1.0f : (value < -1.0f ? -1.0f : value);
+			return static_cast<int16_t>(value * AXIS_SCALE);
+		};
+		const int16_t x = toAxis(frame.x);
+		const int16_t y = toAxis(frame.y);
+
+		buffer[0] = MAGIC_0;
+		buffer[1] = MAGIC_1;
+		buffer[2] = VERSION;
+		buffer[3] = 0;
+		buffer[4] = frame.token & 0xFF;
+		buffer[5] = frame.token >> 8;
+		for (size_t i{0}; i < 4; ++i) buffer[6 + i] = (frame.sequence >> (8 * i)) & 0xFF;
+		buffer[10] = static_cast<uint16_t>(x) & 0xFF;
+		buffer[11] = static_cast<uint16_t>(x) >> 8;
+		buffer[12] = static_cast<uint16_t>(y) & 0xFF;
+		buffer[13] = static_cast<uint16_t>(y) >> 8;
+		return SIZE;
+	}
+
+	// Returns false for anything that isn't a well-formed frame of this version
+	inline bool decode(const uint8_t* buffer, const size_t length, Frame& out) {
+		if (!buffer || length != SIZE) return false;
+		if (buffer[0] != MAGIC_0 || buffer[1] != MAGIC_1 || buffer[2] != VERSION) return false;
+
+		out.token = static_cast<uint16_t>(buffer[4] | (buffer[5] << 8));
+		out.sequence = 0;
+		for (size_t i{0}; i < 4; ++i) out.sequence |= static_cast<uint32_t>(buffer[6 + i]) << (8 * i);
+		out.x = static_cast<int16_t>(buffer[10] | (buffer[11] << 8)) / AXIS_SCALE;
+		out.y = static_cast<int16_t>(buffer[12] | (buffer[13] << 8)) / AXIS_SCALE;
+		return true;
+	}
+
+	// Accepts only frames newer than the newest one seen, so late and duplicated packets are dropped
+	// instead of replaying old stick positions. Sequence numbers may wrap.
+	class SequenceFilter {
+		public:
+			void reset() { hasLast = false; }
+
+			bool accept(const uint32_t sequence) {
+				if (hasLast && static_cast<int32_t>(sequence - last) <= 0) return false;
+				last = sequence;
+				hasLast = true;
+				return true;
+			}
+
+		private:
+			uint32_t last{0};
+			bool hasLast{false};
+	};
+}
+
+#endif // PALOOKANETWORK_CONTROLFRAME_H
@@ -0,0 +1,61 @@
+#ifndef ROBOT_FREQUENCY_GOVERNOR_H
+#define ROBOT_FREQUENCY_GOVERNOR_H
+
+#include <Arduino.h>
+
+namespace Robot {
+	// Runs the CPU at full speed while the robot is being driven and drops it to LOW_CPU_MHZ a couple of seconds
+	// after the last command or wheel movement. Owned by PowerManager and driven by the robot task.
+	//
+	// Never goes below 80 MHz: down to there the APB clock stays at 80 MHz, so the LEDC PWM (motors, servo,
+	// status LED), UART and WiFi keep their timing without being reconfigured. Arduino builds IDF without
+	// CONFIG_PM_ENABLE, so there are no esp_pm locks to take - the 80 MHz floor is what holds the APB clock.
+	class FrequencyGovernor {
+		public:
+			static constexpr uint32_t LOW_CPU_MHZ = 80;
+			static_assert(LOW_CPU_MHZ >= 80, "Below 80 MHz the APB clock drops and WiFi and PWM timing break");
+			static constexpr uint32_t DEFAULT_SLOWDOWN_MS = 2000;
+			static constexpr size_t MAX_FREQUENCIES = 3; // 240, 160 and 80 MHz
+
+			struct TimeAt {
+				uint32_t mhz; // 0 marks an unused entry
+				uint32_t ms;
+			};
+
+			struct Report {
+				uint32_t currentMhz;
+				TimeAt timeAt[MAX_FREQUENCIES];
+				uint32_t rampUps;
+				uint32_t lastRampUpUs;	// setCpuFrequencyMhz() on the first activity after slowing down
+				uint32_t maxRampUpUs;
+			};
+
+			void begin(); // Full speed is whatever the CPU runs at now
+
+			// Call on every command, and while the wheels or a macro are moving. Ramps straight up if slowed down.
+			void notifyActivity();
+			// Call from the robot task loop
+			void update();
+			// Drops the clock now rather than after the slowdown delay
+			void slowDown();
+
+			inline bool isSlowedDown() const { return currentMhz != fullMhz; }
+			Report getReport() const;
+
+		private:
+			uint32_t fullMhz{240};
+			uint32_t currentMhz{240};
+			uint32_t lastActivityMs{0};
+			uint32_t currentSinceMs{0};
+			TimeAt timeAt[MAX_FREQUENCIES]{};
+
+			uint32_t rampUps{0};
+			uint32_t lastRampUpUs{0};
+			uint32_t maxRampUpUs{0};
+
+			void setFrequency(uint32_t mhz);
+			void account(uint32_t nowMs); // Adds the time since currentSinceMs to currentMhz
+	};
+}
+
+#endif // ROBOT_FREQUENCY_GOVERNOR_H
@@ -0,0 +1,75 @@
+#ifndef ROBOT_MACRO_ENGINE_H
+#define ROBOT_MACRO_ENGINE_H
+
+#include <Arduino.h>
+#include <mutex>
+
+#include <PalookaBot/FlipperBot.h>
+#include "BoostGovernor.h"
+
+namespace Robot {
+	// A single timed action. The action is applied when the step starts
+	// and the next step starts durationMs later.
+	struct MacroStep {
+		enum class Type : uint8_t { MOVE, FLIPPER, BOOST };
+
+		Type type;
+		float x, y;			// MOVE
+		byte angle;			// FLIPPER
+		bool boost;			// BOOST
+		uint16_t durationMs;
+	};
+
+	// Runs named sequences of wheel, flipper and boost steps on the robot task so
+	// their timing doesn't depend on WebSocket round-trips.
+	// Macros are defined from the network task and run from the robot task, so definitions are mutex guarded.
+	// BOOST steps are requests to the BoostGovernor, so its limits apply to macros too.
+	class MacroEngine {
+		public:
+			static constexpr size_t MAX_MACROS = 8;
+			static constexpr size_t MAX_STEPS = 16;
+			static constexpr size_t MAX_NAME_LENGTH = 16; // Including the null terminator
+
+			MacroEngine(PalookaBot::FlipperBot& robot, BoostGovernor& boost) : robot(robot), boost(boost) {}
+
+			// Adds or replaces a macro. Fails if the name is empty or too long,
+			// there are too many steps or every slot is taken.
+			bool define(const char* name, const MacroStep* steps, size_t numSteps);
+			bool remove(const char* name);
+
+			// Starts the macro from its first step, replacing any running macro
+			bool start(const char* name);
+			// Stops the wheels and withdraws any boost request if a macro was running
+			void abort();
+			inline bool isRunning() const { return running; }
+
+			// Applies every step that is due. Call as often as possible from the robot task.
+			void update();
+			// Milliseconds until the next step is due (UINT32_MAX when idle) so the caller can sleep precisely
+			uint32_t msUntilNextStep() const;
+
+		private:
+			struct Macro {
+				char name[MAX_NAME_LENGTH];
+				MacroStep steps[MAX_STEPS];
+				size_t numSteps;
+			};
+
+			PalookaBot::FlipperBot& robot;
+			BoostGovernor& boost;
+
+			Macro macros[MAX_MACROS]{};
+			std::mutex macrosMutex;
+
+			// The running macro is copied so it can be redefined mid-run
+			Macro active{};
+			bool running{false};
+			size_t nextStep{0};
+			int64_t nextStepDueUs{0};
+
+			Macro* find(const char* name); // Callers must hold macrosMutex
+			void applyStep(const MacroStep& step);
+	};
+}
+
+#endif // ROBOT_MACRO_ENGINE_H
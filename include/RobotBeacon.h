@@ -0,0 +1,57 @@
+#ifndef PALOOKANETWORK_ROBOTBEACON_H
+#define PALOOKANETWORK_ROBOTBEACON_H
+
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+namespace PalookaNetwork {
+	// Discovery for arena mode, where robots share one network instead of running their own APs.
+	// Every robot broadcasts a small beacon once a second and keeps a table of the beacons it hears,
+	// so whichever robot served the page can tell the browser about the others (browsers can't listen for UDP).
+	//
+	// Beacon payload: {"palooka":1,"name":"...","ws":81,"udp":4210}. The address is taken from the datagram.
+	class RobotBeacon {
+		public:
+			static constexpr uint16_t DEFAULT_PORT = 4211;
+			static constexpr uint32_t INTERVAL_MS = 1000;
+			static constexpr uint32_t EXPIRY_MS = 5000; // Robots silent for this long are dropped
+			static constexpr size_t MAX_ROBOTS = 16;
+			static constexpr size_t MAX_NAME_LENGTH = 33; // SSID length + terminator
+
+			struct Robot {
+				IPAddress ip;
+				char name[MAX_NAME_LENGTH];
+				uint16_t webSocketPort;
+				uint16_t udpControlPort;
+				uint32_t lastSeenMs;
+			};
+
+			explicit RobotBeacon(const uint16_t port = DEFAULT_PORT) : PORT(port) {}
+
+			bool begin(const String& name, uint16_t webSocketPort, uint16_t udpControlPort);
+			inline bool isRunning() const { return running; }
+
+			// Sends a beacon when one is due and records any received. Call from the network loop.
+			void poll();
+
+			// Copies up to maxRobots live entries (not including this robot) and returns how many were copied
+			size_t getRobots(Robot* out, size_t maxRobots) const;
+
+		private:
+			const uint16_t PORT;
+			WiFiUDP udp;
+			bool running{false};
+
+			String payload; // Never changes after begin()
+			uint32_t lastSentMs{0};
+
+			Robot robots[MAX_ROBOTS]{};
+			size_t numRobots{0};
+
+			void receive();
+			void record(const IPAddress& ip, const char* name, uint16_t webSocketPort, uint16_t udpControlPort);
+			void expire(uint32_t nowMs);
+	};
+}
+
+#endif // PALOOKANETWORK_ROBOTBEACON_H
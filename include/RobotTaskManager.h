@@ -2,10 +2,17 @@
 #define ROBOT_TASK_MANAGER_H
 
 #include <ArduinoJson.h>
+#include <atomic>
 #include <stdexcept>
 
 #include <PalookaBot/FlipperBot.h>
+#include <PalookaTrace/Trace.h>
 #include "AccessPointManager.h"
+#include "BlackBoxRecorder.h"
+#include "BoostGovernor.h"
+#include "CommandDeadline.h"
+#include "MacroEngine.h"
+#include "PowerManager.h"
 
 namespace Robot {
 	class RobotTaskManager {
@@ -25,6 +32,14 @@ namespace Robot {
 			}
 
 			inline QueueHandle_t& getQueue() { return websockQueue; }
+			inline MacroEngine& getMacroEngine() { return macros; }
+			inline PowerManager& getPowerManager() { return power; }
+			inline BlackBoxRecorder& getBlackBox() { return blackBox; }
+			inline CommandDeadline& getCommandDeadline() { return deadline; }
+			inline BoostGovernor& getBoostGovernor() { return boost; }
+			inline uint32_t getAppliedCommandCount() const { return appliedCommands; }
+			// From the last battery broadcast, -1 before the first one. Cheap, unlike reading the battery.
+			inline int getLastBatteryPercent() const { return lastBatteryPercent.load(); }
 			bool requestBatteryCalibration(TickType_t timeout = pdMS_TO_TICKS(5000)); // 5 second wait
 
 			void begin();
@@ -32,18 +47,32 @@ namespace Robot {
 		private:
 			PalookaBot::FlipperBot& robot;
 			PalookaNetwork::AccessPointManager& apManager;
+			MacroEngine macros;
+			PowerManager power;
+			BlackBoxRecorder blackBox;
+			CommandDeadline deadline;
+			BoostGovernor boost;
 
 			TaskHandle_t robotTaskHandle = nullptr;
+			std::atomic<TaskHandle_t> calibrationCaller{nullptr}; // Task waiting on requestBatteryCalibration()
 			QueueHandle_t websockQueue;
+			uint32_t appliedCommands{0}; // Joystick and slider commands that reached the motors
+			std::atomic<int> lastBatteryPercent{-1};
+
+			// Status LED warns at or below this. On SocEstimator's curve 10% is 3.69 V at rest, the top of the knee
+			// where the voltage starts to fall away (about 45 mAh left on the 450 mAh pack).
+			static constexpr int LOW_BATTERY_PERCENT = 10;
+			static constexpr float FULL_STICK = 0.95f; // Drive input at or beyond this asks for boost
 
 			static void RobotTask(void* pvParameters);
 			void robotTaskLoop();
-			void handleWebsocketCommands();
+			void handleWebsocketCommands(TickType_t timeout);
 			void handleRobotSliderCommand(char limb, int value);
+			void applyBoost(); // Follows the governor, which also takes the macros' boost requests
 			void sendBatteryUpdate();
 
 			RobotTaskManager(PalookaNetwork::AccessPointManager& manager)
-				: robot(PalookaBot::FlipperBot::getInstance()), apManager(manager) {}
+				: robot(PalookaBot::FlipperBot::getInstance()), apManager(manager), macros(robot, boost), power(robot), blackBox(robot), deadline(robot) {}
 
 			RobotTaskManager(const RobotTaskManager&) = delete;
 			RobotTaskManager& operator=(const RobotTaskManager&) = delete;
@@ -0,0 +1,47 @@
+#ifndef PALOOKANETWORK_UDPCONTROLCHANNEL_H
+#define PALOOKANETWORK_UDPCONTROLCHANNEL_H
+
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+#include "ControlFrame.h"
+
+namespace PalookaNetwork {
+	// Optional joystick path that avoids TCP head-of-line blocking: a lost UDP frame is simply
+	// superseded by the next one. Clients opt in over the WebSocket, which hands out a session token
+	// and keeps carrying discrete commands such as flip.
+	class UdpControlChannel {
+		public:
+			static constexpr uint16_t DEFAULT_PORT = 4210;
+
+			explicit UdpControlChannel(const uint16_t port = DEFAULT_PORT) : PORT(port) {}
+
+			bool begin();
+			// Starts a new session owned by the requesting WebSocket client and returns its token.
+			// Only one client drives over UDP at a time - a new session replaces the old one.
+			uint16_t openSession(uint8_t clientNum);
+			// Ends the session if clientNum owns it. Call when the client's WebSocket disconnects.
+			void closeSession(uint8_t clientNum);
+			inline uint16_t getPort() const { return PORT; }
+			inline uint8_t getSessionClient() const { return sessionClient; }
+
+			// Drains every pending datagram and returns true with the newest valid frame, if any.
+			// The frame comes from getSessionClient(). Call from the network loop.
+			bool poll(ControlFrame::Frame& newest);
+
+			inline uint32_t getDroppedCount() const { return dropped; }
+
+		private:
+			const uint16_t PORT;
+			WiFiUDP udp;
+
+			uint16_t sessionToken{0};
+			uint8_t sessionClient{0};
+			bool sessionOpen{false};
+			ControlFrame::SequenceFilter sequenceFilter;
+
+			uint32_t dropped{0}; // Malformed, foreign, stale or superseded within one poll
+	};
+}
+
+#endif // PALOOKANETWORK_UDPCONTROLCHANNEL_H
@@ -0,0 +1,76 @@
+#ifndef BENCH_BENCHMARK_H
+#define BENCH_BENCHMARK_H
+
+#include <Arduino.h>
+
+namespace Bench {
+	// A benchmark times one call of run() per iteration with the CPU cycle counter.
+	// setup() runs once beforehand (outside the timing) and may be nullptr.
+	struct Benchmark {
+		using Function = void (*)();
+
+		const char* name;
+		Function run;
+		uint32_t iterations;
+		Function setup;
+	};
+
+	// Collects benchmarks registered with PALOOKA_BENCHMARK and runs them in registration order.
+	// Each result is printed as a single JSON line:
+	//   {"bench":"name","iterations":1000,"cpuMhz":240,"min":812,"median":830,"p99":1204,"max":5120}
+	// Cycle counts have the cost of an empty benchmark (the timing overhead) subtracted.
+	// Anything else printed starts with '#', so results can be picked out of a serial log.
+	class Registry {
+		public:
+			static constexpr size_t MAX_BENCHMARKS = 32;
+			static constexpr uint32_t WARMUP_ITERATIONS = 50; // Fills caches and settles branch history
+
+			static Registry& getInstance() {
+				static Registry instance;
+				return instance;
+			}
+
+			bool add(const Benchmark& benchmark);
+			void runAll(Print& out);
+
+		private:
+			Benchmark benchmarks[MAX_BENCHMARKS]{};
+			size_t count{0};
+
+			struct Result {
+				uint32_t min;
+				uint32_t median;
+				uint32_t p99;
+				uint32_t max;
+			};
+
+			// Returns false if there wasn't enough memory for the samples
+			bool measure(const Benchmark& benchmark, uint32_t overheadCycles, Result& result);
+
+			Registry() = default;
+			Registry(const Registry&) = delete;
+			Registry& operator=(const Registry&) = delete;
+	};
+
+	struct Registrar {
+		Registrar(const char* name, Benchmark::Function run, uint32_t iterations = 1000, Benchmark::Function setup = nullptr) {
+			Registry::getInstance().add(Benchmark{name, run, iterations, setup});
+		}
+	};
+
+	// Keeps the compiler from optimising away a result the benchmark never uses
+	template<typename T>
+	inline void doNotOptimize(const T& value) {
+		asm volatile("" : : "r"(&value) : "memory");
+	}
+}
+
+#define PALOOKA_BENCH_CONCAT_INNER(a, b) a##b
+#define PALOOKA_BENCH_CONCAT(a, b) PALOOKA_BENCH_CONCAT_INNER(a, b)
+
+// Registers a benchmark at static initialisation, e.g.
+//   PALOOKA_BENCHMARK("Motor::rotate", rotateRightWheel, 1000, setupMotors);
+#define PALOOKA_BENCHMARK(name, ...) \
+	static const Bench::Registrar PALOOKA_BENCH_CONCAT(benchRegistrar_, __LINE__){name, __VA_ARGS__}
+
+#endif // BENCH_BENCHMARK_H
@@ -0,0 +1,86 @@
+#ifndef SIM_DRIVEMODEL_H
+#define SIM_DRIVEMODEL_H
+
+#include <Arduino.h>
+
+#include "sim/Hardware.h"
+
+namespace Sim {
+	// Physics of the robot, read from the outputs the firmware drives (see Board.h for the pins):
+	//  - Two brushed DC motors on a DRV8833. Each motor's inputs are read through the PWM waveform, so forwards
+	//    (PWM with the direction pin low) coasts between pulses and backwards (direction pin high) brakes between them,
+	//    exactly as Motor<Pins> drives them. Current follows L dI/dt = V - R I - k v and the tyre force is k I, with the
+	//    gear ratio and wheel radius folded into k.
+	//  - A 1S LiPo: open-circuit voltage from the state of charge, minus internal resistance times the total current.
+	//    The battery ADC pin sees the result through the board's divider.
+	//  - A hobby servo flipper that takes a new pulse at its next frame and then slews at a fixed rate.
+	//    Boost raises the servo supply, which makes it faster and hungrier.
+	//  - Differential-drive kinematics on a flat floor with no wheel slip.
+	class DriveModel {
+		public:
+			struct Params {
+				float trackWidthM{0.085f};			// Between the wheel contact points
+				float motorResistanceOhm{2.8f};
+				float motorInductanceH{0.8e-3f};
+				float motorConstant{6.0f};			// N/A at the tyre, and V per m/s of back EMF
+				float wheelMassKg{0.9f};			// Half the robot plus the gearbox inertia felt at each tyre
+				float rollingResistanceN{0.25f};	// Per wheel
+
+				float batteryCapacityMah{450.0f};
+				float batteryResistanceOhm{0.2f};	// Including wiring and the motor driver's switches
+				float idleCurrentA{0.12f};			// ESP32 with WiFi up
+
+				float servoMinPulseUs{500.0f};		// Pulse for 0 degrees
+				float servoMaxPulseUs{2500.0f};		// Pulse for servoRangeDeg
+				float servoRangeDeg{180.0f};
+				float servoSlewDegPerS{500.0f};		// Unloaded, roughly 0.12 s per 60 degrees
+				float servoBoostFactor{1.4f};		// Speed and current multiplier in boost
+				float servoCurrentA{0.6f};			// While the arm moves
+			};
+
+			struct State {
+				double xM, yM;			// Start at the origin facing +x
+				double headingRad;		// Counter-clockwise
+				float leftMps, rightMps;	// Wheel surface speed in the robot's frame (forwards is positive)
+				float leftA, rightA;	// Motor current, averaged over the last step, in the robot's frame
+				float batteryV;			// At the terminals, under load
+				float batteryCurrentA;
+				float stateOfCharge;	// 0 to 1
+				float flipperDeg;
+				float flipperTargetDeg;	// Angle of the last pulse the servo has received
+				bool isBoosted;
+			};
+
+			static constexpr int SUBSTEPS = 100; // Per Hardware step, so a 1 kHz PWM period is resolved in 10 us slices
+
+			explicit DriveModel(float stateOfCharge = 0.9f); // Default Params
+			DriveModel(float stateOfCharge, const Params& params);
+
+			// Sets the battery ADC input, so the firmware's first reading sees the battery. Call before it starts.
+			void connect(Hardware& hardware) const;
+
+			// Reads the outputs from hardware over the step that just ended, advances dtS seconds
+			// and sets the battery ADC input
+			void step(Hardware& hardware, float dtS);
+
+			inline const State& getState() const { return state; }
+			inline const Params& getParams() const { return params; }
+
+			// Open-circuit voltage of a 1S LiPo at a state of charge (0 to 1)
+			static float openCircuitVolts(float stateOfCharge);
+
+		private:
+			const Params params;
+			State state{};
+			float motorCurrentA[2]{};	// Left, right - each in the motor's own frame
+			float motorSpeedMps[2]{};
+			uint16_t latchedPulseUs{0};
+			int64_t nextFrameUs{0};
+
+			// Integrates one motor for dtS with its inputs at the given levels. Returns the current drawn from the battery.
+			float stepMotor(int motor, bool in1, bool in2, bool isDriverAwake, float dtS);
+			void stepFlipper(Hardware& hardware, float dtS, bool isPowered);
+	};
+}
+
+#endif // SIM_DRIVEMODEL_H
@@ -0,0 +1,101 @@
+#ifndef SIM_HARDWARE_H
+#define SIM_HARDWARE_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "driver/adc.h"
+#include "soc/gpio_struct.h"
+
+namespace Sim {
+	// The ESP32 as the firmware sees it in the sim env: pin modes and levels, LEDC duties, servo outputs, ADC inputs
+	// and esp_timers, all written and read through the fakes in include/sim/fakes.
+	//
+	// Time only moves when advance() is called - by the simulator's loop or by a blocking call in the firmware
+	// (delay(), delayMicroseconds()). It is cut into STEP_US steps and the step handler (the physics) runs after each,
+	// so a flip that blocks for 300 ms still sees the arm move. Timers fire at their exact due time within a step.
+	class Hardware {
+		public:
+			static constexpr uint8_t NUM_PINS = 40;
+			static constexpr uint8_t NUM_LEDC_CHANNELS = 16;
+			static constexpr int64_t STEP_US = 1000;
+
+			struct LedcChannel {
+				uint32_t duty{0};
+				uint32_t frequency{0};
+				uint8_t resolutionBits{0};
+				int8_t pin{-1}; // Not attached
+			};
+
+			struct ServoOutput {
+				bool isAttached;
+				uint16_t periodHertz;
+				uint16_t pulseUs;		// Latest pulse written - the servo only sees it at its next frame
+				int64_t attachedAtUs;	// Frames start here
+			};
+
+			using StepHandler = std::function<void(int64_t nowUs)>;
+
+			static Hardware& getInstance() {
+				static Hardware instance;
+				return instance;
+			}
+
+			// ========== Time ==========
+			inline int64_t nowUs() const { return timeUs; } // Where the physics and timers have got to
+			// The firmware's clock, behind millis(), micros() and esp_timer_get_time()
+			int64_t firmwareUs() const;
+			void advance(int64_t us);
+			inline void setStepHandler(StepHandler handler) { stepHandler = std::move(handler); }
+
+			// ========== GPIO ==========
+			uint8_t pinModes[NUM_PINS]{};
+			bool isHigh(uint8_t pin) const; // Output level set through the GPIO registers
+			void setLevel(uint8_t pin, bool isHigh);
+			// Level on the pin at atUs, following the PWM waveform if an LEDC channel drives it
+			bool isOutputHigh(uint8_t pin, int64_t atUs) const;
+
+			// ========== Peripherals ==========
+			LedcChannel ledc[NUM_LEDC_CHANNELS]{};
+			ServoOutput servos[NUM_PINS]{};	// By pin
+			float adcInputMv[ADC1_CHANNEL_MAX]{};	// Set by the model
+			adc_atten_t adcAtten[ADC1_CHANNEL_MAX]{};
+			float adcNoiseLsb{2.0f};		// Peak noise on each raw reading
+
+			// Duty as a fraction of the channel's full scale, 0 if the channel isn't driving a pin
+			float ledcDutyFraction(uint8_t channel) const;
+			int readAdcRaw(adc1_channel_t channel);
+
+			// ========== esp_timer ==========
+			// Timers are due by firmwareUs(). start and stop return false if the timer is already in that state,
+			// and deleteTimer() if it is still running.
+			esp_timer_handle_t createTimer(esp_timer_cb_t callback, void* arg);
+			bool startTimer(esp_timer_handle_t timer, uint64_t timeoutUs, uint64_t periodUs); // periodUs 0 for a one-shot
+			bool stopTimer(esp_timer_handle_t timer);
+			bool deleteTimer(esp_timer_handle_t timer);
+
+			// ========== Serial ==========
+			inline void setSerialEnabled(bool isEnabled) { serialEnabled = isEnabled; }
+			inline bool isSerialEnabled() const { return serialEnabled; }
+
+		private:
+			int64_t timeUs{0};
+			int64_t lastStepUs{0};
+			StepHandler stepHandler;
+			std::mutex timersMutex; // Held while timers are searched or changed, never across a callback
+			std::vector<esp_timer_handle_t> timers;
+			uint32_t noiseState{0x2545F491}; // xorshift, fixed seed so replays are repeatable
+			bool serialEnabled{true};
+
+			void fireDueTimers();
+
+			Hardware() = default;
+			Hardware(const Hardware&) = delete;
+			Hardware& operator=(const Hardware&) = delete;
+	};
+}
+
+#endif // SIM_HARDWARE_H
@@ -0,0 +1,30 @@
+#ifndef SIM_HOST_H
+#define SIM_HOST_H
+
+#include <cstdint>
+#include <string>
+
+namespace Sim {
+	// Where the rtos env's network and filesystem fakes live on the host. Set from the command line before the
+	// firmware starts.
+	class Host {
+		public:
+			uint16_t portOffset{8000};		// Added to the robot's privileged ports, so 80 is served on 8080
+			std::string dataDir{"data"};	// Stands in for the LittleFS partition
+
+			static Host& getInstance() {
+				static Host instance;
+				return instance;
+			}
+
+			// Ports below 1024 need root, so they're moved up by portOffset. Others are used as they are.
+			inline uint16_t port(const uint16_t robotPort) const {
+				return robotPort < 1024 ? static_cast<uint16_t>(robotPort + portOffset) : robotPort;
+			}
+
+		private:
+			Host() = default;
+	};
+}
+
+#endif // SIM_HOST_H
@@ -0,0 +1,26 @@
+#ifndef SIM_MESSAGE_H
+#define SIM_MESSAGE_H
+
+#include <map>
+#include <string>
+
+namespace Sim {
+	// Reads the top level of a JSON object: the controller's messages are flat ({"x":0.5,"y":1}, {"flip":true}),
+	// so numbers, strings and booleans are all the simulator needs. Nested values are skipped over and kept as text.
+	class Message {
+		public:
+			// Returns false if text isn't a JSON object
+			bool parse(const std::string& text);
+
+			inline bool has(const std::string& key) const { return values.count(key) > 0; }
+			double getNumber(const std::string& key, double fallback = 0) const;
+			std::string getString(const std::string& key, const std::string& fallback = "") const;
+			// true, or a non-zero number, like ArduinoJson's conversion to bool
+			bool getBool(const std::string& key) const;
+
+		private:
+			std::map<std::string, std::string> values; // Strings unescaped, everything else as written
+	};
+}
+
+#endif // SIM_MESSAGE_H
@@ -0,0 +1,128 @@
+#ifndef SIM_SIMULATOR_H
+#define SIM_SIMULATOR_H
+
+#include <PalookaBot/FlipperBot.h>
+#include <atomic>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "BoostGovernor.h"
+#include "CommandDeadline.h"
+#include "CommandRateLimiter.h"
+#include "sim/DriveModel.h"
+#include "sim/Hardware.h"
+#include "sim/WebSocketServer.h"
+
+namespace Sim {
+	// Runs the robot task's command handling against the simulated hardware, in one of two modes:
+	//  - Live: a WebSocket server stands in for the robot's (port 81 on the robot), the controller page drives it and
+	//    simulated time is paced to the wall clock. Input can be recorded for replay.
+	//  - Replay: recorded input is applied at its recorded times, as fast as the host can go.
+	// The command path is the firmware's own where it can be: FlipperBot, Motor, ServoDriver, Battery, StatusLed and
+	// CommandDeadline are linked unchanged, and the network side (parsing and rate limiting) mirrors AccessPoint.
+	class Simulator {
+		public:
+			struct Options {
+				uint16_t webSocketPort{8081};
+				std::string replayPath;		// Replay mode if set, live otherwise
+				std::string recordPath;		// Live mode: input is written here in the replay format
+				std::string trajectoryPath;	// CSV, one row per sampleMs
+				std::string reportPath;		// JSON latency and command report
+				uint32_t sampleMs{10};
+				uint32_t tailMs{2000};		// Replay mode: how long to keep going after the last input
+				float stateOfCharge{0.9f};
+				std::string driveProfile;	// DriveProfiles name, the robot's stored profile if empty
+				bool isQuiet{false};		// Leave out the firmware's Serial output
+			};
+
+			explicit Simulator(const Options& options);
+			~Simulator();
+
+			int run(); // Returns the process exit code
+			inline void requestStop() { isStopRequested = true; } // Safe from a signal handler
+
+		private:
+			static constexpr uint32_t BATTERY_UPDATE_INTERVAL_MS = 5000; // As in RobotTaskManager
+			static constexpr int LOW_BATTERY_PERCENT = 10; // As in RobotTaskManager
+			static constexpr float FULL_STICK = 0.95f;
+			static constexpr float SETTLED_ACCEL_MPS2 = 0.1f;	// Both wheels below this count as settled...
+			static constexpr int64_t SETTLED_HOLD_US = 20000;	// ...once they've stayed there this long
+
+			struct Command {
+				enum class Type : uint8_t { SLIDER, JOYSTICK, FLIP } type;
+				char limb;
+				int value;
+				float x, y;
+				uint32_t receivedMs;	// millis() on arrival, as the firmware stamps it
+				int64_t receivedUs;		// For the latency report
+
+				inline bool isStop() const { return type == Type::JOYSTICK ? (x == 0.0f && y == 0.0f) : (type == Type::SLIDER && value == 0); }
+			};
+
+			struct Input {
+				uint32_t atMs;
+				std::string text; // The controller's message
+			};
+
+			struct Latencies {
+				std::vector<float> queueMs;		// Arrival to applied - time spent behind battery reads, flips and the queue
+				std::vector<float> settleMs;	// Applied to both wheels settled, for drive input that wasn't superseded first
+				std::vector<float> flipMs;		// Arrival to the top of the arm's stroke...
+				std::vector<float> flipPeakDeg;	// ...and how far it got before being sent back
+			};
+
+			const Options options;
+			Hardware& hardware;
+			PalookaBot::FlipperBot& robot;
+			Robot::CommandDeadline deadline;
+			Robot::BoostGovernor boost;
+			DriveModel model;
+			WebSocketServer server;
+			PalookaNetwork::CommandRateLimiter rateLimiters[WebSocketServer::MAX_CLIENTS];
+			Command heldCommands[WebSocketServer::MAX_CLIENTS]{}; // As in AccessPoint
+			bool isCommandHeld[WebSocketServer::MAX_CLIENTS]{};
+			std::atomic<bool> isStopRequested{false};
+
+			std::deque<Command> queue;
+			std::vector<Input> inputs; // Replay mode
+			size_t nextInput{0};
+			int64_t wallStartUs{0}; // Live mode
+
+			int lastBatteryPercent{-1};
+			int8_t driverClient{-1};
+			uint32_t received{0}, rateLimited{0}, applied{0}, superseded{0};
+
+			Latencies latencies;
+			int64_t settleStartUs{-1};
+			int64_t settledForUs{0};
+			float previousSpeeds[2]{};
+			int64_t flipArrivalUs{-1};
+			float flipPeakDeg{0};
+			double distanceM{0};
+
+			FILE* trajectory{nullptr};
+			FILE* record{nullptr};
+			int64_t nextSampleUs{0};
+
+			bool loadReplay();
+			bool isFinished() const;
+			void onStep(int64_t nowUs);
+			void receiveInputs(int64_t nowUs);
+			void sendHeldCommands();
+			void onMessage(uint8_t client, const std::string& text);
+			void onConnection(uint8_t client, bool isConnected);
+
+			void handleCommand();
+			void handleSliderCommand(char limb, int value);
+			void applyBoost();
+			void sendBatteryUpdate();
+			void startSettling();
+			void trackResponses(int64_t nowUs);
+			void writeSample(int64_t nowUs);
+			void writeReports() const;
+	};
+}
+
+#endif // SIM_SIMULATOR_H
@@ -0,0 +1,21 @@
+#ifndef SIM_SOCTRACE_H
+#define SIM_SOCTRACE_H
+
+#include <cstdint>
+#include <string>
+
+namespace Sim {
+	// Replays a recorded trace through PalookaBot::SocEstimator, the way the robot task drives it: update() on every
+	// row and correct() every correctionMs. Reads the CSV from dev_scripts/blackbox_decode.py (time_ms, battery_mv,
+	// left_velocity and right_velocity are used), so real recordings can be checked on the host.
+	// Writes one row per input row with the estimate next to the voltage-only percentage Battery::readPercent() gives.
+	struct SocTraceOptions {
+		std::string tracePath;
+		std::string outputPath;		// CSV, stdout if empty
+		uint32_t correctionMs{5000};	// RobotTaskManager's battery update interval
+	};
+
+	int replaySocTrace(const SocTraceOptions& options); // Returns the process exit code
+}
+
+#endif // SIM_SOCTRACE_H
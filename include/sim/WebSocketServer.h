@@ -0,0 +1,56 @@
+#ifndef SIM_WEBSOCKETSERVER_H
+#define SIM_WEBSOCKETSERVER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace Sim {
+	// Just enough of RFC 6455 for the controller page to drive the simulator: the upgrade handshake, text frames
+	// (fragmented or not), ping/pong and close. Single-threaded - everything happens inside poll().
+	class WebSocketServer {
+		public:
+			static constexpr uint8_t MAX_CLIENTS = 5; // Same as arduinoWebSockets on the robot
+
+			using MessageHandler = std::function<void(uint8_t client, const std::string& text)>;
+			using ConnectionHandler = std::function<void(uint8_t client, bool isConnected)>;
+
+			WebSocketServer() = default;
+			~WebSocketServer();
+			WebSocketServer(const WebSocketServer&) = delete;
+			WebSocketServer& operator=(const WebSocketServer&) = delete;
+
+			bool begin(uint16_t port);
+			inline void onMessage(MessageHandler handler) { messageHandler = std::move(handler); }
+			inline void onConnection(ConnectionHandler handler) { connectionHandler = std::move(handler); }
+
+			// Waits up to timeoutMs for network activity and handles it
+			void poll(int timeoutMs);
+
+			void sendText(uint8_t client, const std::string& text);
+			void broadcastText(const std::string& text);
+			uint8_t connectedClients() const;
+
+		private:
+			struct Client {
+				int fd{-1};
+				bool isOpen{false};		// Handshake done
+				std::string received;	// Bytes not yet parsed
+				std::string fragments;	// Text of a fragmented message so far
+			};
+
+			int listenFd{-1};
+			Client clients[MAX_CLIENTS];
+			MessageHandler messageHandler;
+			ConnectionHandler connectionHandler;
+
+			void accept();
+			void read(uint8_t client);
+			bool handshake(Client& client);
+			bool readFrames(uint8_t client);
+			void sendFrame(Client& client, uint8_t opcode, const std::string& payload);
+			void close(uint8_t client);
+	};
+}
+
+#endif // SIM_WEBSOCKETSERVER_H
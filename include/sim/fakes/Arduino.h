@@ -0,0 +1,160 @@
+#ifndef SIM_FAKES_ARDUINO_H
+#define SIM_FAKES_ARDUINO_H
+
+// Host stand-in for the parts of the Arduino-ESP32 core the robot code uses.
+// Pins, LEDC channels and time are backed by Sim::Hardware, so the real PalookaBot code drives the simulated robot.
+// In the sim env delay() and delayMicroseconds() advance the simulated clock rather than sleeping, and physics runs
+// while they block.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <math.h>
+#include <string>
+
+#include "esp_err.h"
+
+#define IRAM_ATTR
+
+#define LOW 0x0
+#define HIGH 0x1
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define PULLUP 0x04
+#define INPUT_PULLUP 0x05
+#define PULLDOWN 0x08
+#define INPUT_PULLDOWN 0x09
+
+#define CHANGE 0x03
+#define FALLING 0x02
+#define RISING 0x01
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+typedef uint8_t byte;
+
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+// ========== Time ==========
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+// ========== GPIO ==========
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+// ========== Interrupts ==========
+// Nothing on the host changes a pin from outside, so no interrupt ever fires
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode);
+void detachInterrupt(uint8_t pin);
+
+// ========== LEDC ==========
+double ledcSetup(uint8_t channel, double freq, uint8_t resolution_bits);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcDetachPin(uint8_t pin);
+void ledcWrite(uint8_t channel, uint32_t duty);
+
+// ========== String ==========
+// Enough of Arduino's String for the robot code and ArduinoJson: construction, c_str(), comparison and concatenation
+class String {
+	public:
+		String(const char* text = "") : text(text ? text : "") {}
+		String(const std::string& text) : text(text) {}
+		explicit String(int value) : text(std::to_string(value)) {}
+		explicit String(unsigned int value) : text(std::to_string(value)) {}
+		explicit String(long value) : text(std::to_string(value)) {}
+		explicit String(unsigned long value) : text(std::to_string(value)) {}
+
+		inline const char* c_str() const { return text.c_str(); }
+		inline unsigned int length() const { return text.length(); }
+		inline void clear() { text.clear(); }
+		inline bool equals(const String& other) const { return text == other.text; }
+		inline bool startsWith(const String& prefix) const { return text.compare(0, prefix.text.size(), prefix.text) == 0; }
+		inline bool endsWith(const String& suffix) const {
+			return text.size() >= suffix.text.size() && text.compare(text.size() - suffix.text.size(), suffix.text.size(), suffix.text) == 0;
+		}
+		inline long toInt() const { return strtol(text.c_str(), nullptr, 10); }
+		inline bool operator==(const String& other) const { return text == other.text; }
+		inline bool operator!=(const String& other) const { return text != other.text; }
+		inline String operator+(const String& other) const { return String(text + other.text); }
+		inline String& operator+=(const String& other) { text += other.text; return *this; }
+		inline bool concat(const char* other) { text += other ? other : ""; return true; } // ArduinoJson's String writer
+
+	private:
+		std::string text;
+};
+
+// ArduinoJson recognises this as a string type alongside String
+class StringSumHelper : public String {
+	public:
+		using String::String;
+};
+
+// glibc only has it from 2.38
+#if defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38))
+size_t strlcpy(char* destination, const char* source, size_t size);
+#endif
+
+// ========== Serial ==========
+// Writes to stderr, so stdout is left for the simulator's reports. Silenced by Sim::Hardware::setSerialEnabled().
+class HardwareSerial {
+	public:
+		void begin(unsigned long /* baud */) {}
+
+		size_t print(const char* text);
+		size_t print(const String& text) { return print(text.c_str()); }
+		size_t print(char c) { const char text[2]{c, '\0'}; return print(text); }
+		size_t print(long value) { return printf("%ld", value); }
+		size_t print(int value) { return print(static_cast<long>(value)); }
+		size_t print(unsigned long value) { return printf("%lu", value); }
+		size_t print(unsigned int value) { return print(static_cast<unsigned long>(value)); }
+		size_t print(double value, int digits = 2) { return printf("%.*f", digits, value); }
+
+		template<typename T>
+		size_t println(const T& value) { return print(value) + print("\n"); }
+		size_t println() { return print("\n"); }
+
+		size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern HardwareSerial Serial;
+
+// ========== ESP ==========
+// There's nothing to restart into on the host, so restart() ends the process
+class EspClass {
+	public:
+		[[noreturn]] void restart();
+};
+
+extern EspClass ESP;
+
+uint32_t getCpuFrequencyMhz();
+bool setCpuFrequencyMhz(uint32_t cpuFreqMhz);
+
+// ========== FreeRTOS ==========
+// There are no tasks in the sim env: creating one fails, and code that has a task for background work (Log) is
+// driven from the simulator's step instead.
+typedef void* TaskHandle_t;
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void*);
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdFAIL pdFALSE
+#define pdPASS pdTRUE
+#define portMAX_DELAY 0xffffffffUL
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char* name, uint32_t stackDepth, void* parameters,
+		unsigned int priority, TaskHandle_t* createdTask);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait);
+
+#endif // SIM_FAKES_ARDUINO_H
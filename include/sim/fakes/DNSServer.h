@@ -0,0 +1,14 @@
+#ifndef SIM_FAKES_DNSSERVER_H
+#define SIM_FAKES_DNSSERVER_H
+
+#include <WiFi.h>
+
+// Host stand-in for the core's DNSServer. The host's own resolver is left alone, so this answers nothing.
+class DNSServer {
+	public:
+		bool start(uint16_t /* port */, const String& /* domainName */, const IPAddress& /* resolvedIP */) { return true; }
+		void stop() {}
+		void processNextRequest() {}
+};
+
+#endif // SIM_FAKES_DNSSERVER_H
@@ -0,0 +1,36 @@
+#ifndef SIM_FAKES_ESP32SERVO_H
+#define SIM_FAKES_ESP32SERVO_H
+
+#include <cstdint>
+
+// Host stand-in for the ESP32Servo library. Each attached Servo publishes its pulse and frame rate on its pin
+// in Sim::Hardware, where the flipper model picks them up at the next frame.
+class ESP32PWM {
+	public:
+		static void allocateTimer(int /* timerNumber */) {}
+};
+
+class Servo {
+	public:
+		static constexpr int DEFAULT_MIN_PULSE_US = 544;
+		static constexpr int DEFAULT_MAX_PULSE_US = 2400;
+		static constexpr int MIN_PULSE_WIDTH_US = 500; // write() takes anything below this as an angle
+
+		int attach(int pin, int minPulseUs = DEFAULT_MIN_PULSE_US, int maxPulseUs = DEFAULT_MAX_PULSE_US);
+		void detach();
+		bool attached() const { return pin >= 0; }
+
+		void setPeriodHertz(int hertz) { periodHertz = hertz; }
+		void write(int angle);
+		void writeMicroseconds(int pulseUs);
+		int readMicroseconds() const { return pulseUs; }
+
+	private:
+		int pin{-1};
+		int minPulseUs{DEFAULT_MIN_PULSE_US};
+		int maxPulseUs{DEFAULT_MAX_PULSE_US};
+		int periodHertz{50};
+		int pulseUs{0};
+};
+
+#endif // SIM_FAKES_ESP32SERVO_H
@@ -0,0 +1,45 @@
+#ifndef SIM_FAKES_LITTLEFS_H
+#define SIM_FAKES_LITTLEFS_H
+
+#include <Arduino.h>
+#include <cstdio>
+#include <memory>
+
+// Host stand-in for LittleFS, rooted at Sim::Host's dataDir - the same data/ folder uploadfs writes to the
+// partition, so the controller pages are served from the working tree. Read-only: nothing in the firmware writes
+// files.
+namespace fs {
+	class File {
+		public:
+			File() = default;
+			File(FILE* file, bool isDirectory, size_t size);
+
+			explicit operator bool() const { return file || directory; }
+			inline bool isDirectory() const { return directory; }
+			inline size_t size() const { return fileSize; }
+			size_t read(uint8_t* buffer, size_t size);
+			void close();
+
+		private:
+			std::shared_ptr<FILE> file; // Shared, so copies close it once
+			bool directory{false};
+			size_t fileSize{0};
+	};
+
+	class FS {
+		public:
+			bool begin(bool /* formatOnFail */ = false) { return true; }
+			void end() {}
+
+			File open(const char* path, const char* mode = "r");
+			File open(const String& path, const char* mode = "r") { return open(path.c_str(), mode); }
+			bool exists(const char* path);
+			bool exists(const String& path) { return exists(path.c_str()); }
+	};
+}
+
+using fs::File;
+
+extern fs::FS LittleFS;
+
+#endif // SIM_FAKES_LITTLEFS_H
@@ -0,0 +1,41 @@
+#ifndef SIM_FAKES_PREFERENCES_H
+#define SIM_FAKES_PREFERENCES_H
+
+#include <Arduino.h>
+
+// Host stand-in for NVS-backed Preferences. Values live in memory for one simulator run,
+// so every run starts from the firmware defaults.
+class Preferences {
+	public:
+		bool begin(const char* name, bool readOnly = false);
+		void end() { isOpen = false; }
+
+		bool isKey(const char* key);
+		bool remove(const char* key);
+		bool clear(); // This namespace's keys only
+
+		uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+		size_t putUInt(const char* key, uint32_t value);
+		uint16_t getUShort(const char* key, uint16_t defaultValue = 0);
+		size_t putUShort(const char* key, uint16_t value);
+		uint8_t getUChar(const char* key, uint8_t defaultValue = 0);
+		size_t putUChar(const char* key, uint8_t value);
+		int8_t getChar(const char* key, int8_t defaultValue = 0);
+		size_t putChar(const char* key, int8_t value);
+		bool getBool(const char* key, bool defaultValue = false);
+		size_t putBool(const char* key, bool value);
+		float getFloat(const char* key, float defaultValue = NAN);
+		size_t putFloat(const char* key, float value);
+		String getString(const char* key, const String& defaultValue = String());
+		size_t putString(const char* key, const String& value);
+
+	private:
+		std::string space;
+		bool isOpen{false};
+		bool readOnly{true};
+
+		std::string fullKey(const char* key) const { return space + '/' + key; }
+		bool canWrite() const { return isOpen && !readOnly; }
+};
+
+#endif // SIM_FAKES_PREFERENCES_H
@@ -0,0 +1,24 @@
+#ifndef SIM_FAKES_UPDATE_H
+#define SIM_FAKES_UPDATE_H
+
+#include <Arduino.h>
+
+// Host stand-in for the core's Update. There's no partition to write an image to, so every update fails at begin()
+// and the OTA routes report the error like any other failed update.
+#define U_FLASH 0
+#define U_SPIFFS 100
+#define UPDATE_SIZE_UNKNOWN 0xFFFFFFFF
+
+class UpdateClass {
+	public:
+		bool begin(size_t /* size */ = UPDATE_SIZE_UNKNOWN, int /* command */ = U_FLASH) { return false; }
+		bool setMD5(const char* /* expectedMD5 */) { return true; }
+		size_t write(uint8_t* /* data */, size_t /* len */) { return 0; }
+		bool end(bool /* evenIfRemaining */ = false) { return false; }
+		void abort() {}
+		const char* errorString() const { return "OTA isn't available on the host"; }
+};
+
+extern UpdateClass Update;
+
+#endif // SIM_FAKES_UPDATE_H
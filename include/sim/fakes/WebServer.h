@@ -0,0 +1,111 @@
+#ifndef SIM_FAKES_WEBSERVER_H
+#define SIM_FAKES_WEBSERVER_H
+
+#include <LittleFS.h>
+#include <WiFi.h>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Host stand-in for the core's WebServer: HTTP/1.1 on a POSIX socket bound to Sim::Host::port(), one request per
+// connection. The first handler that can take a request gets it, and onNotFound runs if it doesn't handle it, as on
+// the robot. Multipart uploads aren't parsed - upload routes see UPLOAD_FILE_START and UPLOAD_FILE_END with no data
+// in between.
+typedef enum { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS } HTTPMethod;
+typedef enum { UPLOAD_FILE_START, UPLOAD_FILE_WRITE, UPLOAD_FILE_END, UPLOAD_FILE_ABORTED } HTTPUploadStatus;
+
+#define HTTP_UPLOAD_BUFLEN 1436
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+
+struct HTTPUpload {
+	HTTPUploadStatus status;
+	String filename;
+	String name;
+	String type;
+	size_t totalSize;
+	size_t currentSize;
+	uint8_t buf[HTTP_UPLOAD_BUFLEN];
+};
+
+class WebServer;
+
+class RequestHandler {
+	public:
+		virtual ~RequestHandler() = default;
+		virtual bool canHandle(HTTPMethod /* method */, String /* uri */) { return false; }
+		virtual bool canUpload(String /* uri */) { return false; }
+		virtual bool handle(WebServer& /* server */, HTTPMethod /* requestMethod */, String /* requestUri */) { return false; }
+		virtual void upload(WebServer& /* server */, String /* requestUri */, HTTPUpload& /* upload */) {}
+
+		inline RequestHandler* next() const { return nextHandler; }
+		inline void next(RequestHandler* handler) { nextHandler = handler; }
+
+	private:
+		RequestHandler* nextHandler{nullptr};
+};
+
+class WebServer {
+	public:
+		using THandlerFunction = std::function<void()>;
+
+		static constexpr size_t MAX_BODY_BYTES = 64 * 1024; // Longer bodies are read and dropped past this
+		static constexpr int REQUEST_TIMEOUT_MS = 1000;
+
+		explicit WebServer(int port = 80) : robotPort(static_cast<uint16_t>(port)) {}
+		~WebServer();
+		WebServer(const WebServer&) = delete;
+		WebServer& operator=(const WebServer&) = delete;
+
+		void begin();
+		void handleClient(); // Serves at most one waiting connection
+
+		void on(const String& uri, HTTPMethod method, THandlerFunction fn);
+		void on(const String& uri, HTTPMethod method, THandlerFunction fn, THandlerFunction ufn);
+		void addHandler(RequestHandler* handler); // Not owned
+		void serveStatic(const char* uri, fs::FS& fs, const char* path);
+		inline void onNotFound(THandlerFunction fn) { notFoundHandler = std::move(fn); }
+
+		// The request being handled. "plain" is the body of anything but a urlencoded form.
+		String arg(const String& name) const;
+		bool hasArg(const String& name) const;
+		inline HTTPUpload& upload() { return currentUpload; }
+		inline WiFiClient client() const { return WiFiClient(clientAddress); }
+
+		void sendHeader(const String& name, const String& value, bool first = false);
+		// CONTENT_LENGTH_UNKNOWN makes the next send() start a chunked response, continued with sendContent()
+		// and ended by sendContent("")
+		inline void setContentLength(size_t length) { contentLength = length; }
+		void send(int code, const char* contentType = nullptr, const String& content = String());
+		void send(int code, const String& contentType, const String& content) { send(code, contentType.c_str(), content); }
+		void send_P(int code, const char* contentType, const char* content, size_t length);
+		void sendContent(const char* content, size_t length);
+		void sendContent(const String& content) { sendContent(content.c_str(), content.length()); }
+		size_t streamFile(fs::File& file, const String& contentType);
+
+	private:
+		const uint16_t robotPort;
+		int listenFd{-1};
+		RequestHandler* firstHandler{nullptr};
+		RequestHandler* lastHandler{nullptr};
+		std::vector<RequestHandler*> ownedHandlers; // From on() and serveStatic()
+		THandlerFunction notFoundHandler;
+
+		int clientFd{-1};
+		IPAddress clientAddress;
+		std::vector<std::pair<std::string, std::string>> args;
+		std::string responseHeaders;
+		size_t contentLength{CONTENT_LENGTH_NOT_SET};
+		bool isChunked{false};
+		bool hasResponded{false};
+		HTTPUpload currentUpload{};
+
+		void addOwnedHandler(RequestHandler* handler);
+		bool readRequest(HTTPMethod& method, std::string& uri, std::string& contentType, std::string& body);
+		void dispatch(HTTPMethod method, const std::string& uri, bool isMultipart);
+		void writeHead(int code, const char* contentType, size_t length);
+		bool writeAll(const char* data, size_t length);
+};
+
+#endif // SIM_FAKES_WEBSERVER_H
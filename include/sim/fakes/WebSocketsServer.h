@@ -0,0 +1,55 @@
+#ifndef SIM_FAKES_WEBSOCKETSSERVER_H
+#define SIM_FAKES_WEBSOCKETSSERVER_H
+
+#include <WiFi.h>
+#include <functional>
+#include <mutex>
+
+#include "sim/WebSocketServer.h"
+
+// Host stand-in for arduinoWebSockets' server, on the simulator's Sim::WebSocketServer bound to
+// Sim::Host::port(). Every client is on the loopback interface.
+#define WEBSOCKETS_SERVER_CLIENT_MAX Sim::WebSocketServer::MAX_CLIENTS
+
+typedef enum {
+	WStype_ERROR,
+	WStype_DISCONNECTED,
+	WStype_CONNECTED,
+	WStype_TEXT,
+	WStype_BIN,
+	WStype_FRAGMENT_TEXT_START,
+	WStype_FRAGMENT_BIN_START,
+	WStype_FRAGMENT,
+	WStype_FRAGMENT_FIN,
+	WStype_PING,
+	WStype_PONG
+} WStype_t;
+
+class WebSocketsServer {
+	public:
+		using WebSocketServerEvent = std::function<void(uint8_t num, WStype_t type, uint8_t* payload, size_t length)>;
+
+		explicit WebSocketsServer(uint16_t port) : robotPort(port) {}
+
+		void begin();
+		void loop();
+		void onEvent(WebSocketServerEvent event) { eventHandler = std::move(event); }
+		// Pings are answered by Sim::WebSocketServer and it notices closed sockets itself
+		void enableHeartbeat(uint32_t /* pingIntervalMs */, uint32_t /* pongTimeoutMs */, uint8_t /* disconnectTimeoutCount */) {}
+
+		bool sendTXT(uint8_t num, const char* payload);
+		bool sendTXT(uint8_t num, const String& payload) { return sendTXT(num, payload.c_str()); }
+		bool broadcastTXT(const char* payload);
+		bool broadcastTXT(const String& payload) { return broadcastTXT(payload.c_str()); }
+
+		uint8_t connectedClients();
+		IPAddress remoteIP(uint8_t /* num */) const { return IPAddress(127, 0, 0, 1); }
+
+	private:
+		const uint16_t robotPort;
+		std::recursive_mutex serverMutex; // Event handlers reply from inside loop()
+		Sim::WebSocketServer server;
+		WebSocketServerEvent eventHandler;
+};
+
+#endif // SIM_FAKES_WEBSOCKETSSERVER_H
@@ -0,0 +1,130 @@
+#ifndef SIM_FAKES_WIFI_H
+#define SIM_FAKES_WIFI_H
+
+#include <Arduino.h>
+#include <functional>
+
+#include "esp_wifi.h"
+
+// Host stand-in for the core's WiFi. There's no radio: the robot is always "up" on the loopback interface, the AP
+// and the arena network both report 127.0.0.1, and scans find nothing, so AUTO_CHANNEL falls back to its default.
+// Station events never fire - nothing joins a network that doesn't exist.
+class IPAddress {
+	public:
+		IPAddress() = default;
+		IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : bytes{a, b, c, d} {}
+		IPAddress(uint32_t address) { memcpy(bytes, &address, sizeof(bytes)); } // Network order, like the core's
+
+		inline operator uint32_t() const {
+			uint32_t address;
+			memcpy(&address, bytes, sizeof(address));
+			return address;
+		}
+		inline bool operator==(const IPAddress& other) const { return memcmp(bytes, other.bytes, sizeof(bytes)) == 0; }
+		inline bool operator!=(const IPAddress& other) const { return !(*this == other); }
+		inline uint8_t operator[](int index) const { return bytes[index]; }
+		inline uint8_t& operator[](int index) { return bytes[index]; }
+
+		String toString() const;
+
+	private:
+		uint8_t bytes[4]{};
+};
+
+class WiFiClient {
+	public:
+		WiFiClient() = default;
+		explicit WiFiClient(const IPAddress& ip) : ip(ip) {}
+
+		inline IPAddress remoteIP() const { return ip; }
+
+	private:
+		IPAddress ip;
+};
+
+#define WIFI_OFF WIFI_MODE_NULL
+#define WIFI_STA WIFI_MODE_STA
+#define WIFI_AP WIFI_MODE_AP
+#define WIFI_AP_STA WIFI_MODE_APSTA
+
+typedef enum {
+	WL_IDLE_STATUS = 0,
+	WL_NO_SSID_AVAIL,
+	WL_SCAN_COMPLETED,
+	WL_CONNECTED,
+	WL_CONNECT_FAILED,
+	WL_CONNECTION_LOST,
+	WL_DISCONNECTED
+} wl_status_t;
+
+typedef enum {
+	WIFI_POWER_19_5dBm = 78,
+	WIFI_POWER_19dBm = 76,
+	WIFI_POWER_18_5dBm = 74,
+	WIFI_POWER_17dBm = 68,
+	WIFI_POWER_15dBm = 60,
+	WIFI_POWER_13dBm = 52,
+	WIFI_POWER_11dBm = 44,
+	WIFI_POWER_8_5dBm = 34,
+	WIFI_POWER_7dBm = 28,
+	WIFI_POWER_5dBm = 20,
+	WIFI_POWER_2dBm = 8,
+	WIFI_POWER_MINUS_1dBm = -4
+} wifi_power_t;
+
+typedef enum {
+	ARDUINO_EVENT_WIFI_READY = 0,
+	ARDUINO_EVENT_WIFI_STA_CONNECTED = 4,
+	ARDUINO_EVENT_WIFI_STA_DISCONNECTED = 5,
+	ARDUINO_EVENT_WIFI_STA_GOT_IP = 7,
+	ARDUINO_EVENT_WIFI_AP_STACONNECTED = 12,
+	ARDUINO_EVENT_WIFI_AP_STADISCONNECTED = 13,
+	ARDUINO_EVENT_WIFI_AP_STAIPASSIGNED = 14
+} arduino_event_id_t;
+
+typedef union {
+	struct {
+		struct {
+			uint32_t addr;
+		} ip;
+		uint8_t mac[6];
+	} wifi_ap_staipassigned;
+} arduino_event_info_t;
+
+class WiFiClass {
+	public:
+		using EventHandler = std::function<void(arduino_event_id_t event, arduino_event_info_t info)>;
+
+		bool mode(wifi_mode_t newMode) { currentMode = newMode; return true; }
+		inline wifi_mode_t getMode() const { return currentMode; }
+
+		bool softAP(const String& ssid, const String& passphrase = "", int channel = 1);
+		IPAddress softAPIP() const { return IPAddress(127, 0, 0, 1); }
+		IPAddress localIP() const { return IPAddress(127, 0, 0, 1); }
+		IPAddress broadcastIP() const { return IPAddress(255, 255, 255, 255); }
+		uint8_t* macAddress(uint8_t* mac) const;
+
+		int16_t scanNetworks(bool /* async */ = false, bool /* showHidden */ = false) { return 0; }
+		void scanDelete() {}
+		uint8_t channel(uint8_t /* networkItem */) const { return apChannel; }
+		int32_t channel() const { return apChannel; }
+		int32_t RSSI(uint8_t /* networkItem */) const { return 0; }
+
+		bool setAutoReconnect(bool /* autoReconnect */) { return true; }
+		wl_status_t begin(const char* ssid, const char* passphrase = nullptr);
+		wl_status_t status() const { return WL_CONNECTED; }
+		bool disconnect(bool /* wifioff */ = false) { return true; }
+		bool setSleep(bool /* enabled */) { return true; }
+		bool setTxPower(wifi_power_t /* power */) { return true; }
+
+		void onEvent(EventHandler handler, arduino_event_id_t event);
+
+	private:
+		wifi_mode_t currentMode{WIFI_MODE_NULL};
+		uint8_t apChannel{1};
+		EventHandler eventHandler; // Kept, never called
+};
+
+extern WiFiClass WiFi;
+
+#endif // SIM_FAKES_WIFI_H
@@ -0,0 +1,43 @@
+#ifndef SIM_FAKES_WIFIUDP_H
+#define SIM_FAKES_WIFIUDP_H
+
+#include <WiFi.h>
+
+// Host stand-in for the core's WiFiUDP, on a non-blocking POSIX socket. Ports are used as they are (they're all
+// above 1024), and broadcasts go out on the host's network, so robots on the same machine see each other's beacons.
+class WiFiUDP {
+	public:
+		WiFiUDP() = default;
+		~WiFiUDP() { stop(); }
+		WiFiUDP(const WiFiUDP&) = delete;
+		WiFiUDP& operator=(const WiFiUDP&) = delete;
+
+		uint8_t begin(uint16_t port); // 1 on success
+		void stop();
+
+		// Receives the next datagram and returns its size, or 0 if none is waiting
+		int parsePacket();
+		int read(uint8_t* buffer, size_t length);
+		int read(char* buffer, size_t length) { return read(reinterpret_cast<uint8_t*>(buffer), length); }
+		inline IPAddress remoteIP() const { return remoteAddress; }
+		inline uint16_t remotePort() const { return remotePortNumber; }
+
+		int beginPacket(IPAddress ip, uint16_t port);
+		size_t write(const uint8_t* buffer, size_t size);
+		size_t print(const String& text) { return write(reinterpret_cast<const uint8_t*>(text.c_str()), text.length()); }
+		int endPacket(); // 1 if the datagram was sent
+
+	private:
+		int fd{-1};
+		std::string received;	// The datagram parsePacket() took
+		size_t readOffset{0};
+		IPAddress remoteAddress;
+		uint16_t remotePortNumber{0};
+
+		std::string sending;
+		IPAddress sendAddress;
+		uint16_t sendPort{0};
+		bool isSending{false};
+};
+
+#endif // SIM_FAKES_WIFIUDP_H
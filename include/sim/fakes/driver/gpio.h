@@ -0,0 +1,16 @@
+#ifndef SIM_FAKES_DRIVER_GPIO_H
+#define SIM_FAKES_DRIVER_GPIO_H
+
+#include "esp_err.h"
+
+// Host stand-in for the GPIO driver - only what the firmware calls
+typedef enum { GPIO_NUM_NC = -1, GPIO_NUM_0 = 0, GPIO_NUM_MAX = 40 } gpio_num_t;
+
+typedef enum { GPIO_MODE_DISABLE, GPIO_MODE_INPUT, GPIO_MODE_OUTPUT, GPIO_MODE_INPUT_OUTPUT } gpio_mode_t;
+
+typedef enum { GPIO_PULLUP_ONLY, GPIO_PULLDOWN_ONLY, GPIO_PULLUP_PULLDOWN, GPIO_FLOATING } gpio_pull_mode_t;
+
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode);
+esp_err_t gpio_set_pull_mode(gpio_num_t gpio_num, gpio_pull_mode_t pull);
+
+#endif // SIM_FAKES_DRIVER_GPIO_H
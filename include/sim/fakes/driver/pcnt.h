@@ -0,0 +1,35 @@
+#ifndef SIM_FAKES_DRIVER_PCNT_H
+#define SIM_FAKES_DRIVER_PCNT_H
+
+#include <cstdint>
+#include "esp_err.h"
+
+// Host stand-in for the legacy pulse counter driver. A unit counts the frames of the simulated servo on its pin.
+#define PCNT_PIN_NOT_USED (-1)
+
+typedef enum { PCNT_UNIT_0, PCNT_UNIT_1, PCNT_UNIT_2, PCNT_UNIT_3, PCNT_UNIT_MAX } pcnt_unit_t;
+typedef enum { PCNT_CHANNEL_0, PCNT_CHANNEL_1 } pcnt_channel_t;
+typedef enum { PCNT_COUNT_DIS, PCNT_COUNT_INC, PCNT_COUNT_DEC } pcnt_count_mode_t;
+typedef enum { PCNT_MODE_KEEP, PCNT_MODE_REVERSE, PCNT_MODE_DISABLE } pcnt_ctrl_mode_t;
+
+typedef struct {
+	int pulse_gpio_num;
+	int ctrl_gpio_num;
+	pcnt_ctrl_mode_t lctrl_mode;
+	pcnt_ctrl_mode_t hctrl_mode;
+	pcnt_count_mode_t pos_mode;
+	pcnt_count_mode_t neg_mode;
+	int16_t counter_h_lim;
+	int16_t counter_l_lim;
+	pcnt_unit_t unit;
+	pcnt_channel_t channel;
+} pcnt_config_t;
+
+esp_err_t pcnt_unit_config(const pcnt_config_t* pcnt_config);
+esp_err_t pcnt_set_pin(pcnt_unit_t unit, pcnt_channel_t channel, int pulse_io, int ctrl_io);
+esp_err_t pcnt_counter_pause(pcnt_unit_t pcnt_unit);
+esp_err_t pcnt_counter_resume(pcnt_unit_t pcnt_unit);
+esp_err_t pcnt_counter_clear(pcnt_unit_t pcnt_unit);
+esp_err_t pcnt_get_counter_value(pcnt_unit_t pcnt_unit, int16_t* count);
+
+#endif // SIM_FAKES_DRIVER_PCNT_H
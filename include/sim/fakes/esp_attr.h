@@ -0,0 +1,12 @@
+#ifndef SIM_FAKES_ESP_ATTR_H
+#define SIM_FAKES_ESP_ATTR_H
+
+// Host stand-in for esp_attr.h. There are no memory regions to place things in, and no RTC memory to survive a
+// reset in - the host never resets.
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+#define DRAM_ATTR
+#define RTC_NOINIT_ATTR
+
+#endif // SIM_FAKES_ESP_ATTR_H
@@ -0,0 +1,18 @@
+#ifndef SIM_FAKES_ESP_ERR_H
+#define SIM_FAKES_ESP_ERR_H
+
+#include <cstdint>
+
+// Host stand-in for esp_err.h. The headers in include/sim/fakes replace the Arduino core and ESP-IDF for the sim env.
+typedef int esp_err_t;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_STATE 0x103
+#define ESP_ERR_NVS_NO_FREE_PAGES 0x110d
+#define ESP_ERR_NVS_NEW_VERSION_FOUND 0x1110
+
+const char* esp_err_to_name(esp_err_t code);
+
+#endif // SIM_FAKES_ESP_ERR_H
@@ -0,0 +1,11 @@
+#ifndef SIM_FAKES_ESP_IPC_H
+#define SIM_FAKES_ESP_IPC_H
+
+#include "esp_err.h"
+
+// Host stand-in for esp_ipc.h. The host has one core, so the function runs on the calling task.
+typedef void (*esp_ipc_func_t)(void* arg);
+
+esp_err_t esp_ipc_call_blocking(uint32_t cpu_id, esp_ipc_func_t func, void* arg);
+
+#endif // SIM_FAKES_ESP_IPC_H
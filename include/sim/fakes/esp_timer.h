@@ -0,0 +1,36 @@
+#ifndef SIM_FAKES_ESP_TIMER_H
+#define SIM_FAKES_ESP_TIMER_H
+
+#include "esp_err.h"
+
+// Host stand-in for esp_timer. Timers run on the simulated clock: callbacks are made from Sim::Hardware::advance(),
+// on the thread that advanced the clock.
+typedef void (*esp_timer_cb_t)(void* arg);
+
+typedef enum { ESP_TIMER_TASK, ESP_TIMER_ISR } esp_timer_dispatch_t;
+
+typedef struct {
+	esp_timer_cb_t callback;
+	void* arg;
+	esp_timer_dispatch_t dispatch_method;
+	const char* name;
+	bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+struct esp_timer {
+	esp_timer_cb_t callback;
+	void* arg;
+	int64_t dueUs;
+	uint64_t periodUs; // 0 for a one-shot
+	bool isArmed;
+};
+typedef struct esp_timer* esp_timer_handle_t;
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* create_args, esp_timer_handle_t* out_handle);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+int64_t esp_timer_get_time();
+
+#endif // SIM_FAKES_ESP_TIMER_H
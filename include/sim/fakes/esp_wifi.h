@@ -0,0 +1,16 @@
+#ifndef SIM_FAKES_ESP_WIFI_H
+#define SIM_FAKES_ESP_WIFI_H
+
+#include "esp_err.h"
+
+// Host stand-in for esp_wifi.h. There is no radio: settings are accepted and have no effect.
+typedef enum { WIFI_MODE_NULL, WIFI_MODE_STA, WIFI_MODE_AP, WIFI_MODE_APSTA } wifi_mode_t;
+typedef enum { WIFI_IF_STA, WIFI_IF_AP } wifi_interface_t;
+typedef enum { WIFI_PS_NONE, WIFI_PS_MIN_MODEM, WIFI_PS_MAX_MODEM } wifi_ps_type_t;
+typedef enum { WIFI_BW_HT20 = 1, WIFI_BW_HT40 } wifi_bandwidth_t;
+
+esp_err_t esp_wifi_set_ps(wifi_ps_type_t type);
+esp_err_t esp_wifi_set_bandwidth(wifi_interface_t ifx, wifi_bandwidth_t bw);
+esp_err_t esp_wifi_set_max_tx_power(int8_t power);
+
+#endif // SIM_FAKES_ESP_WIFI_H
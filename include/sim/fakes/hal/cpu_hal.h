@@ -0,0 +1,10 @@
+#ifndef SIM_FAKES_HAL_CPU_HAL_H
+#define SIM_FAKES_HAL_CPU_HAL_H
+
+#include <cstdint>
+
+// Host stand-in for hal/cpu_hal.h. The cycle counter is the firmware's clock times getCpuFrequencyMhz(), wrapping
+// as the robot's does.
+uint32_t cpu_hal_get_cycle_count();
+
+#endif // SIM_FAKES_HAL_CPU_HAL_H
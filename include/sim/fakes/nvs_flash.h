@@ -0,0 +1,10 @@
+#ifndef SIM_FAKES_NVS_FLASH_H
+#define SIM_FAKES_NVS_FLASH_H
+
+#include "esp_err.h"
+
+// Host stand-in for nvs_flash.h. The partition is the in-memory Preferences store, so erasing it clears every namespace.
+esp_err_t nvs_flash_init();
+esp_err_t nvs_flash_erase();
+
+#endif // SIM_FAKES_NVS_FLASH_H
@@ -0,0 +1,42 @@
+#ifndef SIM_FAKES_SOC_GPIO_STRUCT_H
+#define SIM_FAKES_SOC_GPIO_STRUCT_H
+
+#include <cstdint>
+
+// Host stand-in for the GPIO register block, so PalookaBot::GpioPin compiles unchanged.
+// Writes to the set/clear registers update the output registers, which Sim::Hardware reads pin levels from.
+namespace Sim {
+	class WriteOneToSet {
+		public:
+			explicit WriteOneToSet(volatile uint32_t* bits) : bits(bits) {}
+			WriteOneToSet& operator=(const uint32_t mask) { *bits |= mask; return *this; }
+		private:
+			volatile uint32_t* const bits;
+	};
+
+	class WriteOneToClear {
+		public:
+			explicit WriteOneToClear(volatile uint32_t* bits) : bits(bits) {}
+			WriteOneToClear& operator=(const uint32_t mask) { *bits &= ~mask; return *this; }
+		private:
+			volatile uint32_t* const bits;
+	};
+}
+
+struct gpio_dev_t {
+	volatile uint32_t out{0};		// GPIO0-31
+	volatile uint32_t in{0};
+	struct { volatile uint32_t val{0}; } out1, in1;	// GPIO32-39
+	Sim::WriteOneToSet out_w1ts{&out};
+	Sim::WriteOneToClear out_w1tc{&out};
+	struct { Sim::WriteOneToSet val; } out1_w1ts{Sim::WriteOneToSet{&out1.val}};
+	struct { Sim::WriteOneToClear val; } out1_w1tc{Sim::WriteOneToClear{&out1.val}};
+
+	gpio_dev_t() = default;
+	gpio_dev_t(const gpio_dev_t&) = delete;
+	gpio_dev_t& operator=(const gpio_dev_t&) = delete;
+};
+
+extern gpio_dev_t GPIO;
+
+#endif // SIM_FAKES_SOC_GPIO_STRUCT_H
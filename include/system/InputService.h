@@ -0,0 +1,110 @@
+#ifndef SYSTEM_INPUTSERVICE_H
+#define SYSTEM_INPUTSERVICE_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <functional>
+#include <mutex>
+
+namespace System {
+	// Watches buttons, switches and shorted pins without polling. A pin change interrupt starts a one-shot
+	// debounce timer, and the level is only read once the pin has been quiet for the debounce time.
+	// Long presses and multi-press sequences are timed with a second one-shot timer per pin.
+	// Callbacks run one at a time on the service's own task, so they may block briefly, print or use NVS.
+	// Nothing runs while the pins are idle.
+	class InputService {
+		public:
+			enum class EventType : uint8_t {
+				PRESS,			// Debounced press
+				RELEASE,		// Debounced release
+				LONG_PRESS,		// Held for Config::longPressMs. Still followed by RELEASE.
+				MULTI_PRESS		// Config::multiPressGapMs passed after a release. count is the number of presses.
+			};
+
+			struct Event {
+				uint8_t pin;
+				EventType type;
+				uint8_t count;		// MULTI_PRESS only
+				uint32_t heldMs;	// RELEASE and LONG_PRESS only
+				uint32_t latencyUs;	// From the first edge (PRESS, RELEASE - includes the debounce time) or timer expiry to the callback
+			};
+
+			using Callback = std::function<void(const Event& event)>;
+
+			struct Config {
+				uint8_t pin;
+				bool activeLow{true};		// Pressed pulls the pin low (uses the internal pull-up)
+				uint16_t debounceMs{30};
+				uint32_t longPressMs{0};	// 0 disables LONG_PRESS
+				uint16_t multiPressGapMs{0};	// 0 disables MULTI_PRESS
+			};
+
+			struct Stats {
+				uint32_t edges;			// Raw interrupts, bounces included
+				uint32_t events;		// Callbacks made
+				uint32_t lastLatencyUs;	// PRESS and RELEASE only, debounce time included
+				uint32_t maxLatencyUs;
+			};
+
+			static constexpr size_t MAX_INPUTS = 8;
+
+			static InputService& getInstance() {
+				static InputService instance;
+				return instance;
+			}
+
+			void begin();
+
+			// A pin that is already active when added reports a PRESS straight away
+			bool add(const Config& config, Callback callback);
+			bool remove(uint8_t pin);
+			bool getStats(uint8_t pin, Stats& stats);
+
+		private:
+			enum class MessageType : uint8_t { EDGE, SETTLED, GESTURE_TIMER };
+
+			struct Message {
+				uint8_t slot;
+				MessageType type;
+				int64_t timeUs; // esp_timer time of the interrupt or timer expiry
+			};
+
+			struct Input {
+				bool isUsed;
+				Config config;
+				Callback callback;
+				esp_timer_handle_t debounceTimer;
+				esp_timer_handle_t gestureTimer; // Long press while pressed, multi-press gap after a release
+				int64_t debounceDueUs;	// Timer messages from before the timer was restarted are ignored
+				int64_t gestureDueUs;
+
+				bool isPressed;			// Debounced
+				bool longPressSent;
+				uint8_t pressCount;		// Presses in the current multi-press sequence
+				int64_t firstEdgeUs;	// First edge since the level last settled, 0 if none
+				int64_t pressedAtUs;
+				Stats stats;
+			};
+
+			Input inputs[MAX_INPUTS]{};
+			std::mutex inputsMutex;
+			static QueueHandle_t messages; // Static so the ISR can reach it without the singleton
+
+			static void IRAM_ATTR onEdge(void* arg);
+			static void onTimer(uint8_t slot, MessageType type);
+			static void inputTask(void* pvParameters);
+
+			void handleMessage(const Message& message);
+			// These fill in event and return true if a callback is due. Callers must hold inputsMutex.
+			bool onSettled(Input& input, int64_t timeUs, Event& event);
+			bool onGestureTimer(Input& input, int64_t timeUs, Event& event);
+			static void startTimer(esp_timer_handle_t timer, int64_t& dueUs, int64_t afterUs);
+			Input* find(uint8_t pin); // Callers must hold inputsMutex
+
+			InputService() = default;
+			InputService(const InputService&) = delete;
+			InputService& operator=(const InputService&) = delete;
+	};
+}
+
+#endif // SYSTEM_INPUTSERVICE_H
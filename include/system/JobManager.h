@@ -0,0 +1,61 @@
+#ifndef SYSTEM_JOBMANAGER_H
+#define SYSTEM_JOBMANAGER_H
+
+#include <Arduino.h>
+#include <functional>
+#include <mutex>
+
+namespace System {
+	// Runs slow operations (calibration, restarts...) on a background task so HTTP handlers can answer
+	// straight away with a job ID. Jobs run one at a time in submission order, so they never overlap.
+	class JobManager {
+		public:
+			enum class Status : uint8_t { UNKNOWN, QUEUED, RUNNING, SUCCEEDED, FAILED };
+
+			using JobFunction = bool (*)(); // Returns whether the job succeeded
+			using CompletionCallback = std::function<void(uint32_t id, const char* name, Status status)>;
+
+			static constexpr size_t MAX_JOBS = 8; // Oldest finished jobs are forgotten first
+
+			static JobManager& getInstance() {
+				static JobManager instance;
+				return instance;
+			}
+
+			void begin();
+
+			// Returns the job ID, or 0 if too many jobs are waiting
+			uint32_t submit(const char* name, JobFunction function);
+			Status getStatus(uint32_t id, const char** name = nullptr);
+
+			// Calls callback once for each job that finished since the last call.
+			// Call from the network loop so completion messages are sent from the task that owns the sockets.
+			void dispatchCompletions(const CompletionCallback& callback);
+
+			static const char* statusToString(Status status);
+
+		private:
+			struct Job {
+				uint32_t id; // 0 marks an unused slot
+				const char* name;
+				JobFunction function;
+				Status status;
+				bool completionPending;
+			};
+
+			Job jobs[MAX_JOBS]{};
+			std::mutex jobsMutex;
+			uint32_t nextId{1};
+			QueueHandle_t pendingJobs{nullptr}; // Job IDs waiting to run
+
+			static void workerTask(void* pvParameters);
+			void runJob(uint32_t id);
+			Job* find(uint32_t id); // Callers must hold jobsMutex
+
+			JobManager() = default;
+			JobManager(const JobManager&) = delete;
+			JobManager& operator=(const JobManager&) = delete;
+	};
+}
+
+#endif // SYSTEM_JOBMANAGER_H
@@ -3,14 +3,18 @@
 
 #include <Arduino.h>
 
+#include "system/InputService.h"
+
 namespace System {
 	class ResetService {
 		public:
-			// Initialize the service: starts background monitoring
+			// Initialize the service: watches the reset pin through InputService until the monitoring window ends.
+			// InputService must be started first.
 			static void begin(int resetPin = 5, unsigned long holdTimeMs = 3000UL, unsigned long _maxMonitorTimeMs = 10000UL);
 
 		private:
-			static void resetTask(void* pvParameters);
+			static void onResetPin(const InputService::Event& event);
+			static void onMonitorWindowExpired(void* arg);
 
 			static int _resetPin;
 			static unsigned long _holdTimeMs;
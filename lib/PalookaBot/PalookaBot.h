@@ -2,7 +2,10 @@
 #define PALOOKABOT_H
 
 #include "PalookaBot/Battery.h"
+#include "PalookaBot/Board.h"
 #include "PalookaBot/FlipperBot.h"
+#include "PalookaBot/Gpio.h"
 #include "PalookaBot/Motor.h"
+#include "PalookaBot/ServoDriver.h"
 
 #endif
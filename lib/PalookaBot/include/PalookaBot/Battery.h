@@ -24,6 +24,7 @@ namespace PalookaBot {
 			float readVoltage();		// battery voltage in volts (smoothed)
 			uint32_t readMilliVolts();	// battery voltage in mV (smoothed)
 			int readPercent();			// estimated battery % from voltage
+			uint32_t readInstantMilliVolts(uint8_t samples = 4);	// fast, unsmoothed, calibrated - shows sag under load
 
 			bool isCharging(bool disregardCalibration = false);
 			inline bool isLow() { return readMilliVolts() <= FLAT_MV; }
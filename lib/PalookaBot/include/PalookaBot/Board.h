@@ -0,0 +1,50 @@
+#ifndef PALOOKABOT_BOARD_H
+#define PALOOKABOT_BOARD_H
+
+#include <Arduino.h>
+#include "driver/adc.h"
+
+namespace PalookaBot {
+	namespace Boards {
+		// Compile-time description of a board variant. Pins are constants so drivers templated on them
+		// (see Gpio.h and Motor.h) compile down to direct register access and fixed LEDC channels.
+		//
+		// LEDC channels are assigned from the top because ESP32Servo allocates its channels from 0 upwards.
+		// Pairs of channels (14/15, 12/13, 10/11) share a timer, so each pair runs at one frequency.
+		struct Mootbotv1 {
+			static constexpr const char* NAME = "Mootbotv1_241122";
+
+			// Both motor driver inputs are PWM outputs (see Motor.h)
+			struct RightWheel { // Motor A
+				static constexpr uint8_t PWM_PIN = 32;			// AIN1
+				static constexpr uint8_t DIRECTION_PIN = 33;	// AIN2
+				static constexpr uint8_t PWM_CHANNEL = 15;
+				static constexpr uint8_t DIRECTION_CHANNEL = 11;
+			};
+
+			struct LeftWheel { // Motor B
+				static constexpr uint8_t PWM_PIN = 25;			// BIN1
+				static constexpr uint8_t DIRECTION_PIN = 26;	// BIN2
+				static constexpr uint8_t PWM_CHANNEL = 14;
+				static constexpr uint8_t DIRECTION_CHANNEL = 10;
+			};
+
+			static constexpr uint8_t FLIPPER_PIN = 27;
+			static constexpr uint8_t BOOST_PIN = 15;
+			static constexpr uint8_t LED_PIN = 2;
+			static constexpr uint8_t LED_PWM_CHANNEL = 13; // StatusLed
+			static constexpr uint8_t EN5V_PIN = 17; // Servo
+			static constexpr uint8_t DVR_SLEEP_PIN = 12; // Motors use for charging - switch to low when charging
+
+			static constexpr uint8_t BATTERY_PIN = 36;
+			static constexpr adc1_channel_t BATTERY_CHANNEL = ADC1_CHANNEL_0;
+			static constexpr float BATTERY_R_TOP = 6800.0f; // ohms
+			static constexpr float BATTERY_R_BOT = 470.0f; // ohms
+		};
+	}
+
+	// Board the firmware is built for. Add a struct above and select it here (or with a build flag) for a new variant.
+	using Board = Boards::Mootbotv1;
+}
+
+#endif
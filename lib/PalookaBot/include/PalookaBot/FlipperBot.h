@@ -2,18 +2,24 @@
 #define PALOOKABOT_FLIPPERBOT_H
 
 #include <Arduino.h>
-#include <ESP32Servo.h>
+#include <atomic>
 #include <mutex>
 #include "esp_adc_cal.h"
+#include <PalookaTrace/Trace.h>
 
+#include "Board.h"
+#include "Gpio.h"
 #include "Motor.h"
 #include "Battery.h"
+#include "SocEstimator.h"
+#include "ServoDriver.h"
+#include "StatusLed.h"
 
 // TODO: Reset function on IO5, when LOW, factory reset
 // TODO: Show a warning before users enable the boost button
 namespace PalookaBot
 {
-	// FlipperBot represents a two-wheeled battlebot based on the Mootbotv1_241122 hardware.
+	// FlipperBot represents a two-wheeled battlebot based on the Mootbotv1_241122 hardware (Board).
 	// It uses two Motor objects to control the left and right wheels.
 	// Implemented as a thread-safe singleton.
 	class FlipperBot
@@ -24,44 +30,51 @@ namespace PalookaBot
 			static std::mutex instanceMutex;
 
 			// ========== GPIO Pins ==========
-			const byte EN5V_PIN; // Servo
-			const byte DVR_SLEEP_PIN;   // Motors use for charging - switch to low when charging
+			// Fixed per board (see Board.h) so the hot paths compile to direct register writes
+			using En5vPin = GpioPin<Board::EN5V_PIN>; // Servo
+			using DvrSleepPin = GpioPin<Board::DVR_SLEEP_PIN>; // Motors use for charging - switch to low when charging
+			static constexpr byte BOOST_PIN = Board::BOOST_PIN;
 
 			// ========== Battery ==========
 			Battery battery;
+			SocEstimator socEstimator;
+			static constexpr uint8_t BATTERY_CORRECTION_SAMPLES = 8; // Per getBatteryPercentage() - the estimator does the smoothing
+
+			// ========== Status LED ==========
+			StatusLed statusLed;
+
+			// ========== Power ==========
+			bool actuatorsAsleep;
 
 			// ========== Flipper/Arm ==========
-			const byte FLIPPER_PIN; // See flipper below
-			Servo flipper; // The arm on the robot that flips other robots
+			ServoDriver flipper; // The arm on the robot that flips other robots
 			const byte FLIPPER_MAX_ANGLE;
 			const byte FLIPPER_MIN_ANGLE;
 
 			// ========== Wheels ==========
 			// Each Motor instance controls one wheel.
-			const byte BOOST_PIN;
 			static bool isBoosted;
-			const Motor wheelRight; // Motor A
-			const Motor wheelLeft; // Motor B (configured as inverted to match the physical layout of the robot)
-
-			// ========== LED ==========
-			const byte LED_PIN;
-
-			// ========== BATTERY ==========
-			const byte BATTERY_PIN;
+			// Turning boost off holds the pin for BOOST_SETTLE_MS first. updateBoost() lets it go, so nothing blocks.
+			static constexpr uint32_t BOOST_SETTLE_MS = 50;
+			bool isBoostReleasePending{false};
+			uint32_t boostOffMs{0};
+			Motor<Board::RightWheel> wheelRight; // Motor A
+			Motor<Board::LeftWheel> wheelLeft; // Motor B (configured as inverted to match the physical layout of the robot)
+			std::atomic<const DriveProfile*> driveProfile{&DriveProfiles::COAST};
+
+			// ========== Servo and drive profile persistence ==========
+			static constexpr const char *PREFS_NAMESPACE = "PalookaBot";
+			static constexpr const char *PREFS_SERVO_PROFILE = "Servo::profile";
+			static constexpr const char *PREFS_DRIVE_PROFILE = "Drive::profile";
+			const ServoProfile& loadFlipperProfileFromPrefs() const;
+			const DriveProfile& loadDriveProfileFromPrefs() const;
 
 			// ========== ADC Calibration ==========
 			esp_adc_cal_characteristics_t* adc_chars;  // ADC calibration characteristics pointer
 
 			// ========== Private constructor for singleton pattern ==========
-			// The default parameters correspond to the recommended hardware configuration.
-			FlipperBot(const byte FLIPPER_PIN = 27,
-					const adc1_channel_t batteryChannel = ADC1_CHANNEL_0, const float rTop = 6800.0f, const float rBot = 470.0f,
-					const byte LEFT_PWM_PIN = 25, const byte LEFT_DIRECTION_PIN = 26,
-					const byte RIGHT_PWM_PIN = 32, const byte RIGHT_DIRECTION_PIN = 33,
-					const byte BOOST_PIN = 15,
-					const byte LED_PIN = 2,
-					const byte EN5V_PIN = 17, const byte DVR_SLEEP_PIN = 12,
-					const byte BATTERY_PIN = 36);
+			// The hardware configuration comes from Board (see Board.h).
+			FlipperBot();
 
 			// Prevent copying and assignment
 			FlipperBot(const FlipperBot&) = delete;
@@ -74,9 +87,16 @@ namespace PalookaBot
 			// ========== Initialization ==========
 			void begin();
 
+			// ========== Power functions ==========
+			// Stops the wheels, puts the motor driver to sleep, releases the servo and turns off the 5V rail.
+			void sleepActuators();
+			// Reverses sleepActuators() and waits for the motor driver to be ready. Does nothing if awake.
+			void wakeActuators();
+			inline bool areActuatorsAsleep() const { return actuatorsAsleep; }
+
 			// ========== LED functions ==========
-			void setLedOn(const bool isOn = true) const;
-			void toggleLed() const;
+			// Boost is reported by the robot itself, everything else by the caller
+			inline StatusLed& getStatusLed() { return statusLed; }
 
 			// ========== Tone functions ==========
 			void playTone(int frequency, int duration_ms) const;
@@ -85,9 +105,17 @@ namespace PalookaBot
 			// ========== Flipper Movement functions ==========
 			void setBoostMode(const bool isInBoostMode);	// Careful - causes servo (flipper damage)
 			void toggleBoost();							// Careful - causes servo (flipper damage)
+			void updateBoost();							// Finishes turning boost off. Call from the robot task loop.
 			void moveFlipper(byte angle);
 			void flip();
 
+			// ========== Flipper servo profile functions ==========
+			// Applies the profile immediately and remembers it across restarts
+			bool setFlipperProfile(const ServoProfile& profile);
+			inline const ServoProfile& getFlipperProfile() const { return flipper.getProfile(); }
+			// Blocks for windowMs while the PWM frames on the flipper pin are counted
+			inline float measureFlipperFrameHertz(uint32_t windowMs = 250) { return flipper.measureFrameHertz(windowMs); }
+
 			// ========== Wheel movement functions ==========
 			// move() allows for driving the robot using x (lateral/turning) and y (forward/backward) values.
 			// Inputs are expected to be within [-1, 1] and will be normalized if necessary.
@@ -101,8 +129,31 @@ namespace PalookaBot
 			// stopMoving() halts all movement by stopping both wheels.
 			void stopMoving() const;
 
-			inline int getBatteryPercentage() { return battery.readPercent(); }
-			inline bool calibrateBattery() { return battery.calibrate(); }
+			// Ends a reversal brake once it has run its time (see DriveProfile). Call from the robot task loop.
+			inline void updateWheels() const
+			{
+				const uint32_t nowMs = millis();
+				wheelLeft.update(nowMs);
+				wheelRight.update(nowMs);
+			}
+
+			// ========== Drive profile functions ==========
+			// Decay mode and braking for both wheels. Applies from the next wheel command and is remembered across restarts.
+			void setDriveProfile(const DriveProfile& profile);
+			inline const DriveProfile& getDriveProfile() const { return *driveProfile; }
+
+			// ========== State accessors (telemetry) ==========
+			inline short getLeftWheelVelocity() const { return wheelLeft.getVelocity(); }
+			inline short getRightWheelVelocity() const { return wheelRight.getVelocity(); }
+			inline byte getFlipperAngle() const { return flipper.getAngle(); }
+			inline bool isBoostEnabled() const { return isBoosted; }
+
+			// Estimated state of charge, corrected by a quick voltage reading. Cheap enough for the robot task.
+			int getBatteryPercentage();
+			// Counts the charge used at the current wheel duty. Call from the robot task loop.
+			inline void updateBatteryEstimate() { socEstimator.update(millis(), getLeftWheelVelocity(), getRightWheelVelocity()); }
+			inline uint32_t readInstantBatteryMilliVolts() { return battery.readInstantMilliVolts(); }
+			inline bool calibrateBattery() { TRACE_SCOPE(BOT_BATTERY_CALIBRATE); return battery.calibrate(); }
 
 			// ========== Cleanup ==========
 			static void destroyInstance();
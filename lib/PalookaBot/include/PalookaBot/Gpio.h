@@ -0,0 +1,55 @@
+#ifndef PALOOKABOT_GPIO_H
+#define PALOOKABOT_GPIO_H
+
+#include <Arduino.h>
+#include "soc/gpio_struct.h"
+
+namespace PalookaBot {
+	// A GPIO whose number is known at compile time. Reads and writes go straight to the
+	// set/clear registers, so each one is a single load or store with no pin lookup or bounds check.
+	// Use pinMode()/makeOutput() once for setup - only the hot path is specialised.
+	template<uint8_t PIN>
+	struct GpioPin {
+		static_assert(PIN < 40, "ESP32 GPIOs are numbered 0-39");
+
+		static constexpr uint8_t NUMBER = PIN;
+		static constexpr bool IS_HIGH_BANK = PIN >= 32; // GPIO32-39 live in the second set of registers
+		static constexpr uint32_t MASK = 1UL << (IS_HIGH_BANK ? PIN - 32 : PIN);
+
+		static inline void makeOutput() {
+			static_assert(PIN < 34, "GPIO34-39 are input only");
+			pinMode(PIN, OUTPUT);
+		}
+
+		static inline void high() {
+			if constexpr (IS_HIGH_BANK) { GPIO.out1_w1ts.val = MASK; }
+			else { GPIO.out_w1ts = MASK; }
+		}
+
+		static inline void low() {
+			if constexpr (IS_HIGH_BANK) { GPIO.out1_w1tc.val = MASK; }
+			else { GPIO.out_w1tc = MASK; }
+		}
+
+		static inline void write(const bool isHigh) {
+			if (isHigh) { high(); }
+			else { low(); }
+		}
+
+		// Level on the pin
+		static inline bool read() {
+			if constexpr (IS_HIGH_BANK) { return GPIO.in1.val & MASK; }
+			else { return GPIO.in & MASK; }
+		}
+
+		// Level the pin is being driven to - doesn't need the input buffer to be enabled
+		static inline bool readOutput() {
+			if constexpr (IS_HIGH_BANK) { return GPIO.out1.val & MASK; }
+			else { return GPIO.out & MASK; }
+		}
+
+		static inline void toggle() { write(!readOutput()); }
+	};
+}
+
+#endif
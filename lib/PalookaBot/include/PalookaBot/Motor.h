@@ -1,29 +1,188 @@
 #ifndef PALOOKABOT_MOTOR_H
 #define PALOOKABOT_MOTOR_H
 
+#include <Arduino.h>
+#include <atomic>
+
 namespace PalookaBot
 {
+	// What the DRV8833 does in the off part of each PWM period. It has one input per half-bridge: IN1 high drives
+	// forwards, IN2 high backwards, both high brakes (the winding is shorted) and both low coasts.
+	enum class DecayMode : uint8_t
+	{
+		FAST, // Off-time coasts: the winding current drains back to the battery and the wheel freewheels
+		SLOW  // Off-time brakes: speed follows the duty closely and easing off the stick slows the wheel down
+	};
+
+	// How the wheels drive and stop. Chosen per robot and remembered (see FlipperBot::setDriveProfile()).
+	struct DriveProfile
+	{
+		const char* name;
+		DecayMode decayMode;
+		bool brakeOnRelease;		// rotate(0) shorts the windings instead of letting the wheel coast
+		uint16_t reversalBrakeMs;	// Brake this long before driving the other way, 0 to reverse straight away
+	};
+
+	namespace DriveProfiles
+	{
+		constexpr DriveProfile COAST{"coast", DecayMode::FAST, false, 0}; // Rolls to a stop, easiest on the gearbox
+		constexpr DriveProfile BRAKE{"brake", DecayMode::SLOW, true, 0};
+		// Reversing at speed puts the battery and the back EMF in series across the winding, and the current spike
+		// can trip the driver's overcurrent shutdown. Braking first takes most of the speed off at half the current.
+		constexpr DriveProfile SHARP{"sharp", DecayMode::SLOW, true, 40};
+
+		constexpr DriveProfile ALL[]{COAST, BRAKE, SHARP};
+		constexpr size_t COUNT{sizeof(ALL) / sizeof(ALL[0])};
+
+		// Returns nullptr if no preset has that name
+		const DriveProfile* findByName(const char* name);
+	}
+
+	// Pins is a wheel description from Board.h (PWM_PIN and DIRECTION_PIN with their LEDC channels).
+	// Both driver inputs are LEDC outputs on fixed channels, so every drive, brake and coast state is
+	// two duty writes, and the decay mode is chosen by which input carries the PWM.
+	template<typename Pins>
 	class Motor
 	{
 		private:
 			// ========== GPIO Pins ==========
-			const byte PWM_OUT_PIN; // Data Pin - controls speed
-			const byte DIRECTION_PIN; // Sets forwards/backwards
+			static constexpr uint8_t IN1_PIN = Pins::PWM_PIN;			// High drives forwards
+			static constexpr uint8_t IN1_CHANNEL = Pins::PWM_CHANNEL;
+			static constexpr uint8_t IN2_PIN = Pins::DIRECTION_PIN;	// High drives backwards
+			static constexpr uint8_t IN2_CHANNEL = Pins::DIRECTION_CHANNEL;
+
+			static constexpr uint32_t PWM_FREQUENCY = 1000; // Same as analogWrite()
+			static constexpr uint8_t PWM_RESOLUTION_BITS = 8;
+			// Full duty holds a pin high (the pins belong to LEDC channels, so digitalWrite won't reach them)
+			static constexpr uint32_t FULL_DUTY = 1UL << PWM_RESOLUTION_BITS;
 
 			bool isInverted; // Flag to track whether the rotation direction is inverted
+			mutable short lastVelocity{0}; // As passed to rotate() (after constraining), for telemetry
+
+			// Written by whichever task changes the profile, read by the robot task on every command
+			std::atomic<DecayMode> decayMode{DecayMode::FAST};
+			std::atomic<bool> brakeOnRelease{false};
+			std::atomic<uint16_t> reversalBrakeMs{0};
+
+			mutable bool isReversing{false}; // Braking before driving lastVelocity - see update()
+			mutable uint32_t reversalStartMs{0};
+
+			inline void writeInputs(const uint32_t in1Duty, const uint32_t in2Duty) const
+			{
+				ledcWrite(IN1_CHANNEL, in1Duty);
+				ledcWrite(IN2_CHANNEL, in2Duty);
+			}
+
+			void drive(short velocity) const
+			{
+				// Flip the direction if the motor is inverted
+				velocity = (isInverted) ? (velocity * -1 /* Invert velocity back to normalise it */) : velocity;
+				const bool isForwardDirection = velocity > 0;
+				const uint32_t duty = abs(velocity); // Share of each period spent driving
+
+				if(decayMode.load(std::memory_order_relaxed) == DecayMode::SLOW)
+				{
+					// One input held high, the other low for the drive part of the period and high (braking) for the rest
+					if(isForwardDirection) { writeInputs(FULL_DUTY, FULL_DUTY - duty); }
+					else { writeInputs(FULL_DUTY - duty, FULL_DUTY); }
+				}
+				else
+				{
+					// One input low, the other high for the drive part of the period and low (coasting) for the rest
+					if(isForwardDirection) { writeInputs(duty, 0); }
+					else { writeInputs(0, duty); }
+				}
+			}
 
 		public:
+			static constexpr short MAX_MOTOR_SPEED = 255;
+
 			// ========== Contructor function ==========
 			// Assumes the motor travels in the default motor direction using the isInverted flag
-			Motor(const byte PWM_OUT_PIN, const byte DIRECTION_PIN, const bool isInverted = false);
+			explicit Motor(const bool isInverted = false) : isInverted(isInverted) {}
+
+			// Set up required GPIO pins and the PWM channels
+			void begin() const
+			{
+				ledcSetup(IN1_CHANNEL, PWM_FREQUENCY, PWM_RESOLUTION_BITS);
+				ledcSetup(IN2_CHANNEL, PWM_FREQUENCY, PWM_RESOLUTION_BITS);
+				ledcAttachPin(IN1_PIN, IN1_CHANNEL);
+				ledcAttachPin(IN2_PIN, IN2_CHANNEL);
+				stop();
+			}
+
+			// ========== Drive profile functions ==========
+			// Take effect from the next rotate()
+			inline void setDecayMode(const DecayMode mode) { decayMode = mode; }
+			inline DecayMode getDecayMode() const { return decayMode; }
+			void setProfile(const DriveProfile& profile)
+			{
+				decayMode = profile.decayMode;
+				brakeOnRelease = profile.brakeOnRelease;
+				reversalBrakeMs = profile.reversalBrakeMs;
+			}
 
 			// ========== Movement functions ==========
 			// Expects a signed short between -255 and 255.
 			// If speed is positive, it moves the motor in the default direction.
 			// If speed is negative, it moves the motor in the reverse direction.
-			void rotate(short speed) const;
-			// Completely halts the motion of the motor
-			void stop() const;
+			// Normalises velocity if it isn't within the bounds.
+			// 0 brakes or coasts, and a change of direction may brake first, as set by the profile.
+			void rotate(short velocity) const
+			{
+				if(velocity == 0) // Early return if stop is needed
+				{
+					if(brakeOnRelease.load(std::memory_order_relaxed)) { brake(); }
+					else { stop(); }
+					return;
+				}
+
+				// Limit velocity to the required bounds
+				velocity = constrain(velocity, -MAX_MOTOR_SPEED, MAX_MOTOR_SPEED);  // Limit to valid speed range
+				const bool isReversal = (lastVelocity < 0) != (velocity < 0) && lastVelocity != 0;
+				lastVelocity = velocity;
+
+				const uint16_t brakeMs = reversalBrakeMs.load(std::memory_order_relaxed);
+				if(isReversal && brakeMs > 0)
+				{
+					isReversing = true;
+					reversalStartMs = millis();
+					writeInputs(FULL_DUTY, FULL_DUTY);
+					return;
+				}
+				// Later commands in the same direction only change the speed the brake hands over to
+				if(isReversing && (millis() - reversalStartMs) < brakeMs) { return; }
+
+				isReversing = false;
+				drive(velocity);
+			}
+
+			// Ends a reversal brake once it has run its time. Call regularly (the robot task loop does).
+			void update(const uint32_t nowMs) const
+			{
+				if(!isReversing || (nowMs - reversalStartMs) < reversalBrakeMs.load(std::memory_order_relaxed)) { return; }
+				isReversing = false;
+				drive(lastVelocity);
+			}
+
+			// Lets the wheel coast to a halt
+			void stop() const
+			{
+				writeInputs(0, 0);
+				isReversing = false;
+				lastVelocity = 0;
+			}
+
+			// Shorts the windings, so the wheel's own back EMF stops it quickly and then holds it
+			void brake() const
+			{
+				writeInputs(FULL_DUTY, FULL_DUTY);
+				isReversing = false;
+				lastVelocity = 0;
+			}
+
+			// Signed speed last requested, in the robot's frame (inversion not applied)
+			inline short getVelocity() const { return lastVelocity; }
 
 			// ========== Direction inversion functions ==========
 			// Changes the default direction of the motor by inverting the isInverted flag.
@@ -33,7 +192,25 @@ namespace PalookaBot
 			inline bool getInversionState() const { return isInverted; }
 
 			// Play a tone (vibration) using the motor pins
-            void playTone(int frequency, int duration_ms) const;
+			void playTone(int frequency, int duration_ms) const
+			{
+				// Calculate the delay for half a wave (in microseconds)
+				int halfPeriod_us = 1000000 / (2 * frequency);
+				unsigned long endTime = millis() + duration_ms;
+
+				while (millis() < endTime)
+				{
+					// Alternate outputs to generate the tone/vibration effect
+					writeInputs(FULL_DUTY, 0);
+					delayMicroseconds(halfPeriod_us);
+
+					writeInputs(0, FULL_DUTY);
+					delayMicroseconds(halfPeriod_us);
+				}
+
+				// Ensure the motor is stopped after playing the tone
+				stop();
+			}
 	};
 }
 
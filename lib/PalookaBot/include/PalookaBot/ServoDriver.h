@@ -0,0 +1,80 @@
+#ifndef PALOOKABOT_SERVODRIVER_H
+#define PALOOKABOT_SERVODRIVER_H
+
+#include <Arduino.h>
+#include <ESP32Servo.h>
+#include <mutex>
+#include "driver/pcnt.h"
+
+namespace PalookaBot {
+	// Describes the servo that is physically fitted.
+	// Analog servos only accept 50 Hz frames, digital servos will usually take 200-333 Hz,
+	// which cuts the time a new angle waits for the next frame from 20 ms down to 3-5 ms.
+	struct ServoProfile {
+		const char* name;
+		uint16_t periodHertz;	// Frame rate of the PWM signal
+		uint16_t minPulseUs;	// Pulse width at minAngle
+		uint16_t maxPulseUs;	// Pulse width at maxAngle
+		uint8_t minAngle;
+		uint8_t maxAngle;
+
+		// A frame must be longer than the widest pulse it carries
+		constexpr bool isValid() const {
+			return periodHertz > 0 && minPulseUs < maxPulseUs && minAngle < maxAngle
+				&& maxPulseUs < (1000000UL / periodHertz);
+		}
+		// Worst-case wait before a new angle starts reaching the servo
+		constexpr uint32_t framePeriodUs() const { return 1000000UL / periodHertz; }
+	};
+
+	namespace ServoProfiles {
+		// The broad 500-2500 μs range the flipper has always used
+		constexpr ServoProfile ANALOG_50HZ{"analog50", 50, 500, 2500, 0, 180};
+		constexpr ServoProfile DIGITAL_200HZ{"digital200", 200, 500, 2500, 0, 180};
+		constexpr ServoProfile DIGITAL_333HZ{"digital333", 333, 500, 2500, 0, 180};
+
+		constexpr ServoProfile ALL[]{ANALOG_50HZ, DIGITAL_200HZ, DIGITAL_333HZ};
+		constexpr size_t COUNT{sizeof(ALL) / sizeof(ALL[0])};
+
+		// Returns nullptr if no preset has that name
+		const ServoProfile* findByName(const char* name);
+	}
+
+	// Drives a hobby servo at the frame rate of its profile and lets that rate be checked on the pin.
+	// Thread-safe: the profile may be changed from another task.
+	class ServoDriver {
+		public:
+			// The PCNT unit is only used by measureFrameHertz()
+			ServoDriver(const byte pin, const ServoProfile& initialProfile = ServoProfiles::ANALOG_50HZ,
+					const pcnt_unit_t counterUnit = PCNT_UNIT_0);
+
+			bool begin();	// Attach using the current profile
+			void detach();
+			inline bool isAttached() { return servo.attached(); }
+
+			// Re-attaches with the new profile if already attached. Invalid profiles are rejected.
+			bool setProfile(const ServoProfile& newProfile);
+			inline const ServoProfile& getProfile() const { return profile; }
+
+			// Angle is constrained to the profile's angle range
+			void write(byte angle);
+			inline byte getAngle() const { return angle; }
+
+			// Counts the rising edges on the servo pin for windowMs and returns the frame rate actually output.
+			// Blocks for windowMs, so don't call it from the control loop. The pin is left as a plain output afterwards.
+			float measureFrameHertz(uint32_t windowMs = 250);
+
+		private:
+			const byte PIN;
+			const pcnt_unit_t COUNTER_UNIT;
+			ServoProfile profile;
+			Servo servo;
+			std::mutex servoMutex; // Profiles can be changed from the web server while the robot task writes angles
+			byte angle;
+
+			bool attach();	// Callers must hold servoMutex
+			uint16_t angleToPulseUs(byte angle) const;
+	};
+}
+
+#endif
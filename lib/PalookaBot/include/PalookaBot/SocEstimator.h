@@ -0,0 +1,66 @@
+#ifndef PALOOKABOT_SOCESTIMATOR_H
+#define PALOOKABOT_SOCESTIMATOR_H
+
+#include <cstdint>
+
+namespace PalookaBot {
+	// State of charge of a 1S LiPo by charge counting, corrected against the battery voltage.
+	// The board can't measure current, so the load is estimated from the commanded motor duty: idle draw plus
+	// a per-motor current that scales with |duty|. Voltage readings pull the estimate towards the state of charge
+	// the discharge curve gives - strongly once the motors have been off long enough for the sag to recover,
+	// weakly under load (after adding back the estimated sag). A few unsmoothed ADC samples per correction are
+	// enough, as the noise is averaged by the small gains rather than by oversampling.
+	//
+	// Times and readings are passed in and nothing touches hardware, so recorded data can be replayed through it
+	// on the host (see the sim env's --soc-trace).
+	class SocEstimator {
+		public:
+			struct Params {
+				float capacityMah{450.0f};
+				float idleCurrentA{0.12f};			// ESP32 with WiFi up
+				float motorCurrentA{0.5f};			// Average per motor at full duty
+				float resistanceOhm{0.2f};			// Battery, wiring and motor driver
+				uint32_t restMs{2000};				// Motors off for this long counts as rested
+				float restedGain{0.3f};				// Share of the gap to the voltage's state of charge closed per reading...
+				float loadedGain{0.03f};			// ...when rested, and under load
+			};
+
+			static constexpr int16_t MAX_DUTY = 255;
+
+			SocEstimator(); // Default Params
+			explicit SocEstimator(const Params& params);
+
+			// Starts from a voltage measured with the motors off. correct() seeds too if this wasn't called.
+			void seed(uint32_t nowMs, uint32_t batteryMv);
+
+			// Counts the charge used since the last call at the previous duty, then takes these duties (-255 to 255)
+			// from now on. Call whenever the duty may have changed, or at least every few hundred ms.
+			void update(uint32_t nowMs, int16_t leftDuty, int16_t rightDuty);
+
+			// Pulls the estimate towards a terminal voltage measured now. Call update() first.
+			void correct(uint32_t nowMs, uint32_t batteryMv);
+
+			inline bool isSeeded() const { return hasSeed; }
+			inline float getStateOfCharge() const { return stateOfCharge; } // 0 to 1
+			int getPercent() const;
+			inline float getLoadA() const { return loadA; }
+			bool isRested(uint32_t nowMs) const;
+
+			// Typical 1S LiPo discharge curve, at rest
+			static uint32_t openCircuitMvAt(float stateOfCharge);
+			static float stateOfChargeAt(uint32_t openCircuitMv);
+
+		private:
+			const Params params;
+			bool hasSeed{false};
+			float stateOfCharge{0.0f};
+			float loadA;
+			uint32_t lastUpdateMs{0};
+			uint32_t lastActiveMs{0};	// Last time either motor had a non-zero duty
+			bool isActive{false};		// Either motor has a non-zero duty now
+
+			float loadFor(int16_t leftDuty, int16_t rightDuty) const;
+	};
+}
+
+#endif
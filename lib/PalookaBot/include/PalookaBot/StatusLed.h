@@ -0,0 +1,56 @@
+#ifndef PALOOKABOT_STATUSLED_H
+#define PALOOKABOT_STATUSLED_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <esp_timer.h>
+#include <mutex>
+
+#include "Board.h"
+
+namespace PalookaBot {
+	// Shows the robot's state on the status LED. The LED is driven by an LEDC channel and patterns are played
+	// back by a one-shot esp_timer that only fires at each step, so no task polls or toggles it.
+	//
+	// Callers report conditions and the highest priority one picks the pattern:
+	//   ERROR > LOW_BATTERY > BOOST > CLIENT_CONNECTED > (nothing: waiting for a client)
+	// Setting a condition is one call from any task, and costs an atomic update if the pattern doesn't change.
+	class StatusLed {
+		public:
+			enum class Condition : uint8_t { CLIENT_CONNECTED, BOOST, LOW_BATTERY, ERROR };
+			enum class Pattern : uint8_t { OFF, WAITING_FOR_CLIENT, CONNECTED, BOOST, LOW_BATTERY, ERROR };
+
+			static constexpr uint8_t PWM_CHANNEL = Board::LED_PWM_CHANNEL;
+			static constexpr uint32_t PWM_FREQUENCY = 1000;
+			static constexpr uint8_t PWM_RESOLUTION_BITS = 8;
+
+			StatusLed() = default;
+
+			void begin(); // Safe to call more than once
+			void setCondition(Condition condition, bool isActive);
+			inline Pattern getPattern() const { return pattern.load(); }
+
+		private:
+			struct Step {
+				uint8_t duty;
+				uint16_t ms; // How long the step lasts. 0 holds it until the pattern changes.
+			};
+
+			std::atomic<uint8_t> conditions{0}; // Bit per Condition
+			std::atomic<Pattern> pattern{Pattern::OFF};
+			std::mutex playbackMutex;
+			esp_timer_handle_t stepTimer{nullptr};
+			const Step* steps{nullptr};
+			size_t numSteps{0};
+			size_t stepIndex{0};
+			int64_t stepDueUs{0}; // Timer expiries from an earlier pattern are ignored
+
+			static Pattern patternFor(uint8_t conditions);
+			static const Step* stepsFor(Pattern pattern, size_t& numSteps);
+			void refresh(); // Starts the pattern for the current conditions if it isn't already playing
+			void playStep(); // Callers must hold playbackMutex
+			static void onStepTimer(void* arg);
+	};
+}
+
+#endif
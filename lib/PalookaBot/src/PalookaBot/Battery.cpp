@@ -48,6 +48,17 @@ namespace PalookaBot {
 		return (uint32_t)roundf(v * 1000.0f);
 	}
 
+	// No delay between samples, so it is cheap enough to call from the robot task loop
+	uint32_t Battery::readInstantMilliVolts(uint8_t samples) {
+		if (samples == 0) samples = 1;
+		uint32_t sum = 0;
+		for (uint8_t i = 0; i < samples; ++i) {
+			sum += adc1_get_raw(channel);
+		}
+		const float battMv = rawToMv(sum / samples) / DIV_RATIO;
+		return (uint32_t)roundf(battMv * calibrationFactor);
+	}
+
 	// Map voltage to percent using thresholds
 	int Battery::readPercent() {
 		const uint32_t v = readMilliVolts();
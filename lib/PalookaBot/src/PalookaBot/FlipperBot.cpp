@@ -1,4 +1,6 @@
 #include "PalookaBot/FlipperBot.h"
+#include <PalookaLog/Log.h>
+#include <Preferences.h>
 #include <algorithm>
 
 namespace PalookaBot
@@ -13,7 +15,6 @@ namespace PalookaBot
 	{
 		std::lock_guard<std::mutex> lock(instanceMutex);
 		if (instance == nullptr) {
-			// Using default constructor parameters
 			instance = new FlipperBot();
 		}
 		return *instance;
@@ -40,23 +41,13 @@ namespace PalookaBot
 	}
 
 	// Private constructor
-	FlipperBot::FlipperBot(const byte FLIPPER_PIN,
-			const adc1_channel_t batteryChannel, const float rTop, const float rBot,
-			const byte LEFT_PWM_PIN, const byte LEFT_DIRECTION_PIN,
-			const byte RIGHT_PWM_PIN, const byte RIGHT_DIRECTION_PIN,
-			const byte BOOST_PIN,
-			const byte LED_PIN,
-			const byte EN5V_PIN, const byte DVR_SLEEP_PIN,
-			const byte BATTERY_PIN)
-		: EN5V_PIN(EN5V_PIN), DVR_SLEEP_PIN(DVR_SLEEP_PIN),
-		battery(batteryChannel, rTop, rBot),
-		FLIPPER_PIN(FLIPPER_PIN),
+	FlipperBot::FlipperBot()
+		: battery(Board::BATTERY_CHANNEL, Board::BATTERY_R_TOP, Board::BATTERY_R_BOT),
+		actuatorsAsleep(false),
+		flipper(Board::FLIPPER_PIN),
 		FLIPPER_MAX_ANGLE(180), FLIPPER_MIN_ANGLE(0),
-		wheelRight(RIGHT_PWM_PIN, RIGHT_DIRECTION_PIN),
-		wheelLeft(LEFT_PWM_PIN, LEFT_DIRECTION_PIN, true /* Inverted */),
-		BOOST_PIN(BOOST_PIN),
-		LED_PIN(LED_PIN),
-		BATTERY_PIN(BATTERY_PIN),
+		wheelRight(),
+		wheelLeft(true /* Inverted */),
 		adc_chars(nullptr)
 	{
 		// No initialization in constructor body - all done in begin()
@@ -72,44 +63,67 @@ namespace PalookaBot
 
 		// ========== Power up robot ==========
 		// Configure the power and sleep control pins as outputs.
-		pinMode(EN5V_PIN, OUTPUT);
-		pinMode(DVR_SLEEP_PIN, OUTPUT);
+		En5vPin::makeOutput();
+		DvrSleepPin::makeOutput();
 
+		statusLed.begin();
 		setBoostMode(false);	// Safety - protect servo
-		pinMode(LED_PIN, OUTPUT);
 
 		// Activate the power rails and wake the motor driver.
-		digitalWrite(EN5V_PIN, HIGH);
-		digitalWrite(DVR_SLEEP_PIN, HIGH);
+		En5vPin::high();
+		DvrSleepPin::high();
+
+		// ========== Initialize wheels ==========
+		// Coast unless the robot has stored a braking profile (see setDriveProfile())
+		const DriveProfile& storedDriveProfile = loadDriveProfileFromPrefs();
+		driveProfile = &storedDriveProfile;
+		wheelRight.setProfile(storedDriveProfile);
+		wheelLeft.setProfile(storedDriveProfile);
+		wheelRight.begin();
+		wheelLeft.begin();
 
 		adc_chars = (esp_adc_cal_characteristics_t *)calloc(1, sizeof(esp_adc_cal_characteristics_t));
 		esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_0, ADC_WIDTH_BIT_12, 1100, adc_chars);
 
 		// ========== Initialize flipper ==========
-		flipper.setPeriodHertz(50);
-
-		// Using a broader pulse width range for better compatibility
-		// with a variety of servos (500-2500 μs)
-		flipper.attach(FLIPPER_PIN, 500, 2500);
+		// Defaults to 50 Hz with a broad 500-2500 μs pulse range for compatibility with a variety of servos.
+		// Robots fitted with a digital servo can store a faster profile (see setFlipperProfile()).
+		flipper.setProfile(loadFlipperProfileFromPrefs());
+		flipper.begin();
 
 		battery.begin();
+		socEstimator.seed(millis(), battery.readMilliVolts()); // Oversampled, and the motors haven't run yet
 	}
 
-	void FlipperBot::setLedOn(const bool isOn) const
+	void FlipperBot::sleepActuators()
 	{
-		digitalWrite(LED_PIN, isOn ? HIGH : LOW);
+		if(actuatorsAsleep) { return; }
+		TRACE_SCOPE(BOT_SLEEP);
+
+		stopMoving();
+		setBoostMode(false);
+		flipper.detach(); // Stops holding torque on the servo
+		DvrSleepPin::low();
+		En5vPin::low();
+		actuatorsAsleep = true;
 	}
 
-	void FlipperBot::toggleLed() const
+	void FlipperBot::wakeActuators()
 	{
-		static bool isOn;
-		isOn = digitalRead(LED_PIN); // Get LED status
-		isOn = !isOn; // Toggle the status
-		setLedOn(isOn); // Set the status
+		if(!actuatorsAsleep) { return; }
+		TRACE_SCOPE(BOT_WAKE);
+
+		En5vPin::high();
+		DvrSleepPin::high();
+		flipper.begin(); // Re-attaches at the last angle
+		// The motor driver ignores its inputs for up to 1 ms after leaving sleep (DRV8833 tWAKE)
+		delayMicroseconds(1000);
+		actuatorsAsleep = false;
 	}
 
 	void FlipperBot::playTone(const int frequency, const int duration_ms) const
 	{
+		TRACE_SCOPE(BOT_TONE);
 		static bool rightIsLastWheelUsed{true};
 
 		if(rightIsLastWheelUsed)
@@ -136,44 +150,109 @@ namespace PalookaBot
 
 	void FlipperBot::setBoostMode(const bool newBoostState) {
 		if (isBoosted == newBoostState) return;
+		TRACE_SCOPE(BOT_BOOST);
 
 		isBoosted = newBoostState;
+		statusLed.setCondition(StatusLed::Condition::BOOST, isBoosted);
 
-		Serial.print("Boost mode: ");
-		Serial.println(isBoosted ? "ENABLED" : "DISABLED");
+		LOG_INFO("Boost mode: %s", isBoosted ? "ENABLED" : "DISABLED");
 
 		if (isBoosted) {
+			isBoostReleasePending = false;
 			pinMode(BOOST_PIN, OUTPUT);
 			digitalWrite(BOOST_PIN, LOW); // Enable boost
 			return;
 		}
 
-		delay(50); // Give circuit time to settle
-		pinMode(BOOST_PIN, INPUT);    // Disable boost
+		// Give circuit time to settle - updateBoost() disables boost once it has
+		isBoostReleasePending = true;
+		boostOffMs = millis();
+	}
+
+	void FlipperBot::updateBoost() {
+		if (!isBoostReleasePending || (millis() - boostOffMs) < BOOST_SETTLE_MS) return;
+
+		isBoostReleasePending = false;
+		pinMode(BOOST_PIN, INPUT); // Disable boost
 	}
 
 	void FlipperBot::toggleBoost() {
-		isBoosted = !isBoosted;
-		setBoostMode(isBoosted);
+		setBoostMode(!isBoosted);
 	}
 
 	void FlipperBot::moveFlipper(byte angle)
 	{
+		TRACE_SCOPE(BOT_MOVE_FLIPPER);
 		// Ensure the angle is within the angle limits
 		angle = constrain(angle, FLIPPER_MIN_ANGLE, FLIPPER_MAX_ANGLE);
 		flipper.write(angle); // Set the flipper to the angle
 	}
 
+	bool FlipperBot::setFlipperProfile(const ServoProfile& profile)
+	{
+		if(!flipper.setProfile(profile)) { return false; }
+
+		Preferences prefs;
+		prefs.begin(PREFS_NAMESPACE, false);
+		prefs.putString(PREFS_SERVO_PROFILE, profile.name);
+		prefs.end();
+		return true;
+	}
+
+	const ServoProfile& FlipperBot::loadFlipperProfileFromPrefs() const
+	{
+		Preferences prefs;
+		prefs.begin(PREFS_NAMESPACE, true); // read-only
+		String name = prefs.getString(PREFS_SERVO_PROFILE, ServoProfiles::ANALOG_50HZ.name);
+		prefs.end();
+
+		const ServoProfile* stored = ServoProfiles::findByName(name.c_str());
+		return stored ? *stored : ServoProfiles::ANALOG_50HZ;
+	}
+
+	void FlipperBot::setDriveProfile(const DriveProfile& profile)
+	{
+		wheelRight.setProfile(profile);
+		wheelLeft.setProfile(profile);
+		driveProfile = &profile;
+
+		Preferences prefs;
+		prefs.begin(PREFS_NAMESPACE, false);
+		prefs.putString(PREFS_DRIVE_PROFILE, profile.name);
+		prefs.end();
+	}
+
+	const DriveProfile& FlipperBot::loadDriveProfileFromPrefs() const
+	{
+		Preferences prefs;
+		prefs.begin(PREFS_NAMESPACE, true); // read-only
+		String name = prefs.getString(PREFS_DRIVE_PROFILE, DriveProfiles::COAST.name);
+		prefs.end();
+
+		const DriveProfile* stored = DriveProfiles::findByName(name.c_str());
+		return stored ? *stored : DriveProfiles::COAST;
+	}
+
 	void FlipperBot::flip()
 	{
+		TRACE_SCOPE(BOT_FLIP);
 		// Add delays to make the flipping action more effective
 		moveFlipper(FLIPPER_MAX_ANGLE); // Quickly lift flipper
 		delay(300);                     // Wait for servo to reach position
 		moveFlipper(FLIPPER_MIN_ANGLE); // Put flipper back against the ground
 	}
 
+	int FlipperBot::getBatteryPercentage()
+	{
+		TRACE_SCOPE(BOT_BATTERY_READ);
+		updateBatteryEstimate();
+		socEstimator.correct(millis(), battery.readInstantMilliVolts(BATTERY_CORRECTION_SAMPLES));
+		return socEstimator.getPercent();
+	}
+
 	void FlipperBot::move(const float x, const float y) const
 	{
+		TRACE_SCOPE(BOT_MOVE);
 		// Compute preliminary speed values for each wheel.
 		float left = y + x;
 		float right = y - x;
@@ -0,0 +1,102 @@
+#include "PalookaBot/ServoDriver.h"
+
+#include <cstring>
+#include "driver/gpio.h"
+
+namespace PalookaBot {
+	const ServoProfile* ServoProfiles::findByName(const char* name) {
+		if (!name) return nullptr;
+		for (size_t i{0}; i < COUNT; ++i) {
+			if (strcmp(ALL[i].name, name) == 0) return &ALL[i];
+		}
+		return nullptr;
+	}
+
+	ServoDriver::ServoDriver(const byte pin, const ServoProfile& initialProfile, const pcnt_unit_t counterUnit)
+		: PIN(pin),
+		COUNTER_UNIT(counterUnit),
+		profile(initialProfile.isValid() ? initialProfile : ServoProfiles::ANALOG_50HZ),
+		angle(0)
+	{ }
+
+	bool ServoDriver::begin() {
+		std::lock_guard<std::mutex> lock(servoMutex);
+		return attach();
+	}
+
+	void ServoDriver::detach() {
+		std::lock_guard<std::mutex> lock(servoMutex);
+		if (servo.attached()) servo.detach();
+	}
+
+	bool ServoDriver::setProfile(const ServoProfile& newProfile) {
+		if (!newProfile.isValid()) return false;
+
+		std::lock_guard<std::mutex> lock(servoMutex);
+		const bool wasAttached = servo.attached();
+		if (wasAttached) servo.detach();
+		profile = newProfile;
+		angle = constrain(angle, profile.minAngle, profile.maxAngle);
+
+		return wasAttached ? attach() : true;
+	}
+
+	void ServoDriver::write(byte newAngle) {
+		std::lock_guard<std::mutex> lock(servoMutex);
+		angle = constrain(newAngle, profile.minAngle, profile.maxAngle);
+		servo.writeMicroseconds(angleToPulseUs(angle));
+	}
+
+	float ServoDriver::measureFrameHertz(uint32_t windowMs) {
+		if (!servo.attached() || windowMs == 0) return 0.0f;
+
+		pcnt_config_t config{};
+		config.pulse_gpio_num = PIN;
+		config.ctrl_gpio_num = PCNT_PIN_NOT_USED;
+		config.channel = PCNT_CHANNEL_0;
+		config.unit = COUNTER_UNIT;
+		config.pos_mode = PCNT_COUNT_INC;	// One count per frame
+		config.neg_mode = PCNT_COUNT_DIS;
+		config.lctrl_mode = PCNT_MODE_KEEP;
+		config.hctrl_mode = PCNT_MODE_KEEP;
+		config.counter_h_lim = INT16_MAX;
+		config.counter_l_lim = 0;
+		if (pcnt_unit_config(&config) != ESP_OK) return 0.0f;
+
+		// pcnt_unit_config() turns the pin into an input - keep the PWM output routed while we listen to it
+		gpio_set_direction(static_cast<gpio_num_t>(PIN), GPIO_MODE_INPUT_OUTPUT);
+
+		pcnt_counter_pause(COUNTER_UNIT);
+		pcnt_counter_clear(COUNTER_UNIT);
+		const uint32_t startUs = micros();
+		pcnt_counter_resume(COUNTER_UNIT);
+		delay(windowMs);
+		pcnt_counter_pause(COUNTER_UNIT);
+		const uint32_t elapsedUs = micros() - startUs;
+
+		int16_t edges{0};
+		pcnt_get_counter_value(COUNTER_UNIT, &edges);
+
+		// Hand the pin back as the plain output ESP32Servo left it: unhook the counter and drop the pull-up it enabled
+		pcnt_counter_clear(COUNTER_UNIT);
+		pcnt_set_pin(COUNTER_UNIT, PCNT_CHANNEL_0, PCNT_PIN_NOT_USED, PCNT_PIN_NOT_USED);
+		gpio_set_pull_mode(static_cast<gpio_num_t>(PIN), GPIO_FLOATING);
+		gpio_set_direction(static_cast<gpio_num_t>(PIN), GPIO_MODE_OUTPUT);
+
+		return elapsedUs ? (edges * 1000000.0f) / elapsedUs : 0.0f;
+	}
+
+	// Private
+	// Callers must hold servoMutex
+	bool ServoDriver::attach() {
+		servo.setPeriodHertz(profile.periodHertz);
+		// ESP32Servo uses these limits to clamp writeMicroseconds()
+		const bool attached = servo.attach(PIN, profile.minPulseUs, profile.maxPulseUs) != 0;
+		if (attached) servo.writeMicroseconds(angleToPulseUs(angle)); // Restore the last angle so re-attaching doesn't jolt the arm
+		return attached;
+	}
+
+	uint16_t ServoDriver::angleToPulseUs(byte angle) const {
+		return map(angle, profile.minAngle, profile.maxAngle, profile.minPulseUs, profile.maxPulseUs);
+	}
+}
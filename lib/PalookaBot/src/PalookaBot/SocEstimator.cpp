@@ -0,0 +1,85 @@
+#include "PalookaBot/SocEstimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace PalookaBot {
+	namespace {
+		// Resting voltage from empty to full in 5% steps
+		constexpr uint16_t OPEN_CIRCUIT_MV[]{
+			3270, 3610, 3690, 3710, 3730, 3750, 3770, 3790, 3800, 3820, 3840,
+			3850, 3870, 3910, 3950, 3980, 4020, 4080, 4110, 4150, 4200
+		};
+		constexpr int LAST_STEP = sizeof(OPEN_CIRCUIT_MV) / sizeof(OPEN_CIRCUIT_MV[0]) - 1;
+	}
+
+	SocEstimator::SocEstimator() : SocEstimator(Params{}) { }
+
+	SocEstimator::SocEstimator(const Params& params) : params(params), loadA(params.idleCurrentA) { }
+
+	void SocEstimator::seed(const uint32_t nowMs, const uint32_t batteryMv) {
+		lastUpdateMs = nowMs;
+		const float openCircuitMv = batteryMv + loadA * params.resistanceOhm * 1000.0f;
+		stateOfCharge = stateOfChargeAt(static_cast<uint32_t>(std::lround(openCircuitMv)));
+		hasSeed = true;
+	}
+
+	void SocEstimator::update(const uint32_t nowMs, const int16_t leftDuty, const int16_t rightDuty) {
+		if (hasSeed) {
+			const float elapsedH = (nowMs - lastUpdateMs) / 3600000.0f;
+			stateOfCharge = std::max(0.0f, stateOfCharge - loadA * 1000.0f * elapsedH / params.capacityMah);
+		}
+		if (isActive) lastActiveMs = nowMs; // Active until now
+
+		lastUpdateMs = nowMs;
+		loadA = loadFor(leftDuty, rightDuty);
+		isActive = leftDuty != 0 || rightDuty != 0;
+		if (isActive) lastActiveMs = nowMs;
+	}
+
+	void SocEstimator::correct(const uint32_t nowMs, const uint32_t batteryMv) {
+		if (!hasSeed) {
+			seed(nowMs, batteryMv);
+			return;
+		}
+
+		const bool rested = isRested(nowMs);
+		const float openCircuitMv = batteryMv + loadA * params.resistanceOhm * 1000.0f;
+		const float measured = stateOfChargeAt(static_cast<uint32_t>(std::lround(openCircuitMv)));
+		const float gain = rested ? params.restedGain : params.loadedGain;
+		stateOfCharge = std::clamp(stateOfCharge + gain * (measured - stateOfCharge), 0.0f, 1.0f);
+	}
+
+	int SocEstimator::getPercent() const {
+		return static_cast<int>(std::lround(stateOfCharge * 100.0f));
+	}
+
+	bool SocEstimator::isRested(const uint32_t nowMs) const {
+		return !isActive && (nowMs - lastActiveMs) >= params.restMs;
+	}
+
+	uint32_t SocEstimator::openCircuitMvAt(const float stateOfCharge) {
+		const float position = std::clamp(stateOfCharge, 0.0f, 1.0f) * LAST_STEP;
+		const int step = std::min(static_cast<int>(position), LAST_STEP - 1);
+		const float mv = OPEN_CIRCUIT_MV[step] + (OPEN_CIRCUIT_MV[step + 1] - OPEN_CIRCUIT_MV[step]) * (position - step);
+		return static_cast<uint32_t>(std::lround(mv));
+	}
+
+	float SocEstimator::stateOfChargeAt(const uint32_t openCircuitMv) {
+		if (openCircuitMv <= OPEN_CIRCUIT_MV[0]) return 0.0f;
+		if (openCircuitMv >= OPEN_CIRCUIT_MV[LAST_STEP]) return 1.0f;
+
+		const uint16_t* upper = std::upper_bound(OPEN_CIRCUIT_MV, OPEN_CIRCUIT_MV + LAST_STEP + 1, openCircuitMv);
+		const int step = static_cast<int>(upper - OPEN_CIRCUIT_MV) - 1;
+		const float within = static_cast<float>(openCircuitMv - OPEN_CIRCUIT_MV[step])
+				/ (OPEN_CIRCUIT_MV[step + 1] - OPEN_CIRCUIT_MV[step]);
+		return (step + within) / LAST_STEP;
+	}
+
+	// Private
+	float SocEstimator::loadFor(const int16_t leftDuty, const int16_t rightDuty) const {
+		const float duty = static_cast<float>(std::abs(leftDuty) + std::abs(rightDuty)) / MAX_DUTY;
+		return params.idleCurrentA + params.motorCurrentA * duty;
+	}
+}
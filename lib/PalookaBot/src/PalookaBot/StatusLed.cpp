@@ -0,0 +1,105 @@
+#include "PalookaBot/StatusLed.h"
+
+#include <climits>
+
+namespace PalookaBot {
+	void StatusLed::begin()
+	{
+		{
+			std::lock_guard<std::mutex> lock(playbackMutex);
+			if(stepTimer) { return; }
+
+			ledcSetup(PWM_CHANNEL, PWM_FREQUENCY, PWM_RESOLUTION_BITS);
+			ledcAttachPin(Board::LED_PIN, PWM_CHANNEL);
+
+			const esp_timer_create_args_t timerArgs{StatusLed::onStepTimer, this, ESP_TIMER_TASK, "StatusLed", false};
+			if(esp_timer_create(&timerArgs, &stepTimer) != ESP_OK)
+			{
+				stepTimer = nullptr;
+				return;
+			}
+		}
+		refresh(); // Conditions may have been set before begin()
+	}
+
+	void StatusLed::setCondition(const Condition condition, const bool isActive)
+	{
+		const uint8_t bit = 1 << static_cast<uint8_t>(condition);
+		const uint8_t updated = isActive ? (conditions.fetch_or(bit) | bit) : (conditions.fetch_and(~bit) & ~bit);
+		if(patternFor(updated) != pattern.load()) { refresh(); }
+	}
+
+	// Private
+	StatusLed::Pattern StatusLed::patternFor(const uint8_t conditions)
+	{
+		const auto isSet = [conditions](Condition condition) { return conditions & (1 << static_cast<uint8_t>(condition)); };
+		if(isSet(Condition::ERROR)) { return Pattern::ERROR; }
+		if(isSet(Condition::LOW_BATTERY)) { return Pattern::LOW_BATTERY; }
+		if(isSet(Condition::BOOST)) { return Pattern::BOOST; }
+		if(isSet(Condition::CLIENT_CONNECTED)) { return Pattern::CONNECTED; }
+		return Pattern::WAITING_FOR_CLIENT;
+	}
+
+	const StatusLed::Step* StatusLed::stepsFor(const Pattern pattern, size_t& numSteps)
+	{
+		static constexpr uint8_t DIM{24};
+		static constexpr uint8_t BRIGHT{255};
+
+		// Each pattern repeats. A step lasting 0 ms is held.
+		static constexpr Step OFF[]{{0, 0}};
+		static constexpr Step WAITING_FOR_CLIENT[]{{BRIGHT, 500}, {0, 1500}};				// Slow blink
+		static constexpr Step CONNECTED[]{{DIM, 0}};										// Steady glow
+		static constexpr Step BOOST[]{{BRIGHT, 100}, {0, 100}};							// Fast blink
+		static constexpr Step LOW_BATTERY[]{{BRIGHT, 150}, {0, 150}, {BRIGHT, 150}, {0, 1550}};	// Double blink
+		static constexpr Step ERROR[]{{BRIGHT, 50}, {0, 50}};								// Flicker
+
+		switch(pattern)
+		{
+			case Pattern::WAITING_FOR_CLIENT: numSteps = sizeof(WAITING_FOR_CLIENT) / sizeof(Step); return WAITING_FOR_CLIENT;
+			case Pattern::CONNECTED: numSteps = sizeof(CONNECTED) / sizeof(Step); return CONNECTED;
+			case Pattern::BOOST: numSteps = sizeof(BOOST) / sizeof(Step); return BOOST;
+			case Pattern::LOW_BATTERY: numSteps = sizeof(LOW_BATTERY) / sizeof(Step); return LOW_BATTERY;
+			case Pattern::ERROR: numSteps = sizeof(ERROR) / sizeof(Step); return ERROR;
+			case Pattern::OFF: default: numSteps = sizeof(OFF) / sizeof(Step); return OFF;
+		}
+	}
+
+	void StatusLed::refresh()
+	{
+		std::lock_guard<std::mutex> lock(playbackMutex);
+		if(!stepTimer) { return; } // begin() starts the pattern
+
+		const Pattern newPattern = patternFor(conditions.load());
+		if(steps && newPattern == pattern.load()) { return; } // Another task got here first
+
+		esp_timer_stop(stepTimer); // Fails harmlessly if it isn't running
+		pattern = newPattern;
+		steps = stepsFor(newPattern, numSteps);
+		stepIndex = 0;
+		playStep();
+	}
+
+	void StatusLed::playStep()
+	{
+		const Step& step = steps[stepIndex];
+		ledcWrite(PWM_CHANNEL, step.duty);
+
+		if(step.ms == 0)
+		{
+			stepDueUs = INT64_MAX;
+			return;
+		}
+		stepDueUs = esp_timer_get_time() + step.ms * 1000LL;
+		esp_timer_start_once(stepTimer, step.ms * 1000ULL);
+	}
+
+	void StatusLed::onStepTimer(void* arg)
+	{
+		auto* self = static_cast<StatusLed*>(arg);
+		std::lock_guard<std::mutex> lock(self->playbackMutex);
+		if(esp_timer_get_time() < self->stepDueUs) { return; } // Expiry from before the pattern changed
+
+		self->stepIndex = (self->stepIndex + 1) % self->numSteps;
+		self->playStep();
+	}
+}
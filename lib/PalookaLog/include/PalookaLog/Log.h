@@ -0,0 +1,108 @@
+#ifndef PALOOKALOG_LOG_H
+#define PALOOKALOG_LOG_H
+
+// Logging that keeps UART time out of the control path. At 115200 baud a 40 character line takes ~3.5 ms to send,
+// which a control task can't afford every command.
+//
+// A LOG_* call formats its line into a fixed ring and returns: no locks, no allocation and no waiting on the UART,
+// so it is safe from any task (not from ISRs). A low priority task writes queued lines to Serial. If the ring is
+// full the line is dropped and counted, and the next line written says how many were lost.
+//
+// Levels below PALOOKA_LOG_LEVEL compile to nothing, arguments included. Dev builds keep everything, prod keeps
+// warnings and errors only (see envs/prod.ini), so hot-path lines should be LOG_DEBUG.
+//
+//   LOG_DEBUG("Joystick X: %.2f, Y: %.2f", x, y);
+//   LOG_WARN_EVERY_MS(1000, "Rate limited client %u", client); // At most once a second from this line
+
+#include <Arduino.h>
+#include <atomic>
+
+#define PALOOKA_LOG_LEVEL_NONE 0
+#define PALOOKA_LOG_LEVEL_ERROR 1
+#define PALOOKA_LOG_LEVEL_WARN 2
+#define PALOOKA_LOG_LEVEL_INFO 3
+#define PALOOKA_LOG_LEVEL_DEBUG 4
+
+#ifndef PALOOKA_LOG_LEVEL
+#define PALOOKA_LOG_LEVEL PALOOKA_LOG_LEVEL_DEBUG
+#endif
+
+namespace Log {
+	enum class Level : uint8_t {
+		ERROR = PALOOKA_LOG_LEVEL_ERROR,
+		WARN = PALOOKA_LOG_LEVEL_WARN,
+		INFO = PALOOKA_LOG_LEVEL_INFO,
+		DEBUG = PALOOKA_LOG_LEVEL_DEBUG
+	};
+
+	static constexpr size_t LINES = 32; // Power of two
+	static constexpr size_t LINE_LENGTH = 96; // Including the terminator - longer lines are cut short
+	static_assert((LINES & (LINES - 1)) == 0, "LINES must be a power of two");
+
+	// Starts the task that writes queued lines to Serial. Lines logged before this wait in the ring.
+	void begin();
+
+	// Use the LOG_* macros instead, so filtered levels cost nothing
+	void write(Level level, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+	// Writes every queued line to Serial and returns how many there were. The drain task calls this.
+	// Only call it directly where begin() hasn't been called - there must be one reader at a time.
+	size_t drain();
+
+	uint32_t getDroppedCount(); // Lines lost to a full ring since boot
+
+	// One per rate limited LOG_*_EVERY_MS call site
+	class RateLimit {
+		public:
+			// True at most once per intervalMs. Concurrent callers can't both win.
+			inline bool allow(const uint32_t intervalMs) {
+				const uint32_t now = millis();
+				uint32_t next = nextMs.load(std::memory_order_relaxed);
+				if (static_cast<int32_t>(now - next) < 0) return false;
+				return nextMs.compare_exchange_strong(next, now + intervalMs, std::memory_order_relaxed);
+			}
+
+		private:
+			std::atomic<uint32_t> nextMs{0};
+	};
+}
+
+#define PALOOKA_LOG_EVERY_MS(level, intervalMs, ...) \
+	do { \
+		static Log::RateLimit logRateLimit; \
+		if (logRateLimit.allow(intervalMs)) Log::write(level, __VA_ARGS__); \
+	} while (0)
+
+#if PALOOKA_LOG_LEVEL >= PALOOKA_LOG_LEVEL_ERROR
+#define LOG_ERROR(...) Log::write(Log::Level::ERROR, __VA_ARGS__)
+#define LOG_ERROR_EVERY_MS(intervalMs, ...) PALOOKA_LOG_EVERY_MS(Log::Level::ERROR, intervalMs, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) do {} while (0)
+#define LOG_ERROR_EVERY_MS(intervalMs, ...) do {} while (0)
+#endif
+
+#if PALOOKA_LOG_LEVEL >= PALOOKA_LOG_LEVEL_WARN
+#define LOG_WARN(...) Log::write(Log::Level::WARN, __VA_ARGS__)
+#define LOG_WARN_EVERY_MS(intervalMs, ...) PALOOKA_LOG_EVERY_MS(Log::Level::WARN, intervalMs, __VA_ARGS__)
+#else
+#define LOG_WARN(...) do {} while (0)
+#define LOG_WARN_EVERY_MS(intervalMs, ...) do {} while (0)
+#endif
+
+#if PALOOKA_LOG_LEVEL >= PALOOKA_LOG_LEVEL_INFO
+#define LOG_INFO(...) Log::write(Log::Level::INFO, __VA_ARGS__)
+#define LOG_INFO_EVERY_MS(intervalMs, ...) PALOOKA_LOG_EVERY_MS(Log::Level::INFO, intervalMs, __VA_ARGS__)
+#else
+#define LOG_INFO(...) do {} while (0)
+#define LOG_INFO_EVERY_MS(intervalMs, ...) do {} while (0)
+#endif
+
+#if PALOOKA_LOG_LEVEL >= PALOOKA_LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) Log::write(Log::Level::DEBUG, __VA_ARGS__)
+#define LOG_DEBUG_EVERY_MS(intervalMs, ...) PALOOKA_LOG_EVERY_MS(Log::Level::DEBUG, intervalMs, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) do {} while (0)
+#define LOG_DEBUG_EVERY_MS(intervalMs, ...) do {} while (0)
+#endif
+
+#endif // PALOOKALOG_LOG_H
@@ -0,0 +1,119 @@
+#include "PalookaLog/Log.h"
+
+#include <cstdarg>
+#include <cstdio>
+
+namespace Log {
+	namespace {
+		// Bounded multi-producer ring (after Dmitry Vyukov's). Each slot's sequence says whose turn it is:
+		// position when free for the producer that reserves it, position + 1 once the line is ready to drain.
+		// Sequences are stored minus the slot's index, so the zero-initialized ring is already valid and lines
+		// logged from static constructors aren't lost.
+		struct Slot {
+			std::atomic<uint32_t> sequence;
+			uint32_t timeMs;
+			Level level;
+			char text[LINE_LENGTH];
+		};
+
+		Slot slots[LINES];
+		std::atomic<uint32_t> head{0};	// Next position to write
+		uint32_t tail{0};				// Next position to drain - drain() is the only reader
+		std::atomic<uint32_t> dropped{0};
+		uint32_t reportedDropped{0};
+		std::atomic<TaskHandle_t> drainTask{nullptr};
+
+		inline uint32_t loadSequence(const uint32_t position) {
+			const uint32_t index = position & (LINES - 1);
+			return slots[index].sequence.load(std::memory_order_acquire) + index;
+		}
+
+		inline void storeSequence(const uint32_t position, const uint32_t sequence) {
+			const uint32_t index = position & (LINES - 1);
+			slots[index].sequence.store(sequence - index, std::memory_order_release);
+		}
+
+		char levelLetter(const Level level) {
+			switch (level) {
+				case Level::ERROR: return 'E';
+				case Level::WARN: return 'W';
+				case Level::INFO: return 'I';
+				default: return 'D';
+			}
+		}
+
+		void drainLoop(void* /* arg */) {
+			while (true) {
+				ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+				drain();
+			}
+		}
+	}
+
+	void begin() {
+		if (drainTask.load()) return;
+		TaskHandle_t task{nullptr};
+		xTaskCreate(
+			drainLoop,
+			"Log::drain",
+			3072,
+			nullptr,
+			1, // Below the robot task, so lines only go out when it's waiting
+			&task
+		);
+		drainTask.store(task);
+		if (task) xTaskNotifyGive(task); // Lines from before begin()
+	}
+
+	void write(const Level level, const char* format, ...) {
+		uint32_t position = head.load(std::memory_order_relaxed);
+		Slot* slot;
+		while (true) {
+			slot = &slots[position & (LINES - 1)];
+			const int32_t turn = static_cast<int32_t>(loadSequence(position) - position);
+			if (turn == 0) {
+				if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+			} else if (turn < 0) {
+				dropped.fetch_add(1, std::memory_order_relaxed); // Full - the drain task hasn't caught up
+				return;
+			} else {
+				position = head.load(std::memory_order_relaxed); // Another producer took this slot
+			}
+		}
+
+		slot->timeMs = millis();
+		slot->level = level;
+		va_list args;
+		va_start(args, format);
+		vsnprintf(slot->text, sizeof(slot->text), format, args);
+		va_end(args);
+		storeSequence(position, position + 1);
+
+		const TaskHandle_t task = drainTask.load(std::memory_order_relaxed);
+		if (task) xTaskNotifyGive(task);
+	}
+
+	size_t drain() {
+		size_t count{0};
+		while (true) {
+			Slot& slot = slots[tail & (LINES - 1)];
+			if (loadSequence(tail) != tail + 1) break; // Empty, or still being written
+
+			const uint32_t lost = dropped.load(std::memory_order_relaxed);
+			if (lost != reportedDropped) {
+				Serial.printf("[Log] %lu lines dropped\n", static_cast<unsigned long>(lost - reportedDropped));
+				reportedDropped = lost;
+			}
+
+			Serial.printf("%lu %c %s\n", static_cast<unsigned long>(slot.timeMs), levelLetter(slot.level), slot.text);
+			storeSequence(tail, tail + LINES);
+			++tail;
+			++count;
+		}
+		return count;
+	}
+
+	uint32_t getDroppedCount() {
+		return dropped.load(std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,132 @@
+#ifndef PALOOKATRACE_TRACE_H
+#define PALOOKATRACE_TRACE_H
+
+// Event tracing for one-off stalls that histograms hide, e.g. a flip overlapping a battery read.
+// Only compiled in when PALOOKA_TRACE is defined (see envs/trace.ini) - otherwise every TRACE_* macro is empty.
+//
+// Events go into a fixed ring per core. Recording one is an atomic slot reservation, a cycle counter read
+// and three stores: no locks, no allocation, and safe from any task (not from ISRs).
+// GET /trace exports the rings as Chrome trace-event JSON (open in chrome://tracing or ui.perfetto.dev).
+//
+//   void FlipperBot::flip() {
+//       TRACE_SCOPE(BOT_FLIP); // BEGIN now, END when the scope exits
+//       ...
+//   }
+
+// Every event ID with the name shown in the trace viewer
+#define PALOOKA_TRACE_EVENTS(X) \
+	X(SYNC, "Trace::sync") \
+	X(ROBOT_COMMAND, "RobotTask::command") \
+	X(ROBOT_BATTERY_UPDATE, "RobotTask::batteryUpdate") \
+	X(ROBOT_MACRO_STEP, "RobotTask::macroStep") \
+	X(ROBOT_CALIBRATION, "RobotTask::calibration") \
+	X(AP_HTTP, "AccessPoint::http") \
+	X(AP_WEBSOCKET_LOOP, "AccessPoint::webSocketLoop") \
+	X(AP_WEBSOCKET_MESSAGE, "AccessPoint::webSocketMessage") \
+	X(AP_RATE_LIMITED, "AccessPoint::rateLimited") \
+	X(AP_UDP_POLL, "AccessPoint::udpPoll") \
+	X(BOT_MOVE, "FlipperBot::move") \
+	X(BOT_FLIP, "FlipperBot::flip") \
+	X(BOT_MOVE_FLIPPER, "FlipperBot::moveFlipper") \
+	X(BOT_BOOST, "FlipperBot::setBoostMode") \
+	X(BOT_BATTERY_READ, "FlipperBot::readBattery") \
+	X(BOT_BATTERY_CALIBRATE, "FlipperBot::calibrateBattery") \
+	X(BOT_SLEEP, "FlipperBot::sleepActuators") \
+	X(BOT_WAKE, "FlipperBot::wakeActuators") \
+	X(BOT_TONE, "FlipperBot::playTone")
+
+#ifdef PALOOKA_TRACE
+
+#include <Arduino.h>
+#include <atomic>
+#include <functional>
+#include "hal/cpu_hal.h"
+
+namespace Trace {
+	enum Id : uint16_t {
+#define PALOOKA_TRACE_ENUM(id, name) id,
+		PALOOKA_TRACE_EVENTS(PALOOKA_TRACE_ENUM)
+#undef PALOOKA_TRACE_ENUM
+		ID_COUNT
+	};
+
+	enum class Phase : uint8_t { BEGIN = 'B', END = 'E', INSTANT = 'i' };
+
+	struct Event {
+		uint32_t cycles;	// CPU cycle counter of the recording core
+		uint32_t value;		// Task handle, or the esp_timer time in us for SYNC
+		uint16_t id;
+		uint8_t phase;
+		uint8_t reserved;
+	};
+
+	static constexpr size_t EVENTS_PER_CORE = 1024; // Power of two
+	static_assert((EVENTS_PER_CORE & (EVENTS_PER_CORE - 1)) == 0, "EVENTS_PER_CORE must be a power of two");
+
+	namespace detail {
+		struct Ring {
+			std::atomic<uint32_t> head{0}; // Total events ever recorded; the slot is head % EVENTS_PER_CORE
+			Event events[EVENTS_PER_CORE];
+		};
+
+		extern Ring rings[portNUM_PROCESSORS];
+		extern std::atomic<bool> paused; // Set while exporting so slots aren't overwritten mid-read
+
+		inline void record(const Phase phase, const uint16_t id, const uint32_t value) {
+			if (paused.load(std::memory_order_relaxed)) return;
+
+			Ring& ring = rings[xPortGetCoreID()];
+			Event& event = ring.events[ring.head.fetch_add(1, std::memory_order_relaxed) & (EVENTS_PER_CORE - 1)];
+			event.cycles = cpu_hal_get_cycle_count();
+			event.value = value;
+			event.id = id;
+			event.phase = static_cast<uint8_t>(phase);
+		}
+
+		inline uint32_t currentTask() { return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(xTaskGetCurrentTaskHandle())); }
+	}
+
+	inline void begin(const Id id) { detail::record(Phase::BEGIN, id, detail::currentTask()); }
+	inline void end(const Id id) { detail::record(Phase::END, id, detail::currentTask()); }
+	inline void instant(const Id id) { detail::record(Phase::INSTANT, id, detail::currentTask()); }
+
+	// Records the esp_timer time against each core's cycle counter, which is how cycles become timestamps.
+	// The counters aren't shared between cores, wrap every ~18 s at 240 MHz and change rate with the CPU clock,
+	// so call this about once a second and right before and after changing the CPU frequency.
+	void sync();
+
+	// Writes the rings as Chrome trace-event JSON in small pieces (the whole trace doesn't fit in RAM as text).
+	// Recording is paused while this runs.
+	void writeChromeJson(const std::function<void(const char* data, size_t length)>& write);
+
+	class Scope {
+		public:
+			explicit Scope(const Id id) : id(id) { begin(id); }
+			~Scope() { end(id); }
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+		private:
+			const Id id;
+	};
+}
+
+#define PALOOKA_TRACE_CONCAT_INNER(a, b) a##b
+#define PALOOKA_TRACE_CONCAT(a, b) PALOOKA_TRACE_CONCAT_INNER(a, b)
+
+#define TRACE_BEGIN(id) Trace::begin(Trace::id)
+#define TRACE_END(id) Trace::end(Trace::id)
+#define TRACE_INSTANT(id) Trace::instant(Trace::id)
+#define TRACE_SCOPE(id) const Trace::Scope PALOOKA_TRACE_CONCAT(traceScope_, __LINE__){Trace::id}
+#define TRACE_SYNC() Trace::sync()
+
+#else
+
+#define TRACE_BEGIN(id) do {} while (0)
+#define TRACE_END(id) do {} while (0)
+#define TRACE_INSTANT(id) do {} while (0)
+#define TRACE_SCOPE(id) do {} while (0)
+#define TRACE_SYNC() do {} while (0)
+
+#endif // PALOOKA_TRACE
+
+#endif // PALOOKATRACE_TRACE_H
@@ -0,0 +1,171 @@
+#include "PalookaTrace/Trace.h"
+
+#ifdef PALOOKA_TRACE
+
+#include <esp_ipc.h>
+#include <esp_timer.h>
+#include <algorithm>
+#include <cstdarg>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace Trace {
+	namespace detail {
+		Ring rings[portNUM_PROCESSORS];
+		std::atomic<bool> paused{false};
+	}
+
+	namespace {
+		const char* const NAMES[] = {
+#define PALOOKA_TRACE_NAME(id, name) name,
+			PALOOKA_TRACE_EVENTS(PALOOKA_TRACE_NAME)
+#undef PALOOKA_TRACE_NAME
+		};
+		static_assert(sizeof(NAMES) / sizeof(NAMES[0]) == ID_COUNT, "Every event needs a name");
+
+		void syncThisCore(void* /* arg */) {
+			detail::record(Phase::INSTANT, SYNC, static_cast<uint32_t>(esp_timer_get_time()));
+		}
+
+		// Batches small writes so the HTTP response isn't sent a few bytes at a time
+		class Writer {
+			public:
+				explicit Writer(const std::function<void(const char*, size_t)>& write) : write(write) {}
+				~Writer() { flush(); }
+
+				void printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+					char line[192];
+					va_list args;
+					va_start(args, format);
+					const int length = vsnprintf(line, sizeof(line), format, args);
+					va_end(args);
+					if (length <= 0) return;
+
+					const size_t size = std::min<size_t>(length, sizeof(line) - 1);
+					if (used + size > sizeof(buffer)) flush();
+					memcpy(buffer + used, line, size);
+					used += size;
+				}
+
+				// Separates array elements
+				const char* separator() {
+					const char* result = first ? "" : ",";
+					first = false;
+					return result;
+				}
+
+				void flush() {
+					if (used == 0) return;
+					write(buffer, used);
+					used = 0;
+				}
+
+			private:
+				const std::function<void(const char*, size_t)>& write;
+				char buffer[1024];
+				size_t used{0};
+				bool first{true};
+		};
+
+		// Turns one core's cycle counts into esp_timer microseconds using the SYNC events around each event.
+		// Between two syncs the clock rate is taken from the syncs themselves, so frequency changes are handled
+		// as long as sync() is called around them.
+		class Clock {
+			public:
+				Clock(const detail::Ring& ring, uint32_t start, uint32_t end) : ring(ring) {
+					for (uint32_t i = start; i != end; ++i) {
+						if (at(i).id == SYNC) syncs.push_back(i);
+					}
+				}
+
+				double toMicros(const uint32_t index) {
+					const Event& event = at(index);
+					while (nextSync < syncs.size() && syncs[nextSync] < index) ++nextSync; // Events are visited in order
+
+					const Event* before = nextSync > 0 ? &at(syncs[nextSync - 1]) : nullptr;
+					const Event* after = nextSync < syncs.size() ? &at(syncs[nextSync]) : nullptr;
+
+					if (after) {
+						const double cyclesPerUs = before ? rate(*before, *after) : getCpuFrequencyMhz();
+						return after->value - (after->cycles - event.cycles) / cyclesPerUs;
+					}
+					if (before) {
+						return before->value + (event.cycles - before->cycles) / static_cast<double>(getCpuFrequencyMhz());
+					}
+					return event.cycles / static_cast<double>(getCpuFrequencyMhz()); // No syncs - relative times only
+				}
+
+			private:
+				const detail::Ring& ring;
+				std::vector<uint32_t> syncs; // Ring positions of SYNC events
+				size_t nextSync{0};
+
+				const Event& at(const uint32_t position) const { return ring.events[position & (EVENTS_PER_CORE - 1)]; }
+
+				static double rate(const Event& before, const Event& after) {
+					const uint32_t us = after.value - before.value;
+					if (us == 0) return getCpuFrequencyMhz();
+					return (after.cycles - before.cycles) / static_cast<double>(us);
+				}
+		};
+	}
+
+	void sync() {
+		syncThisCore(nullptr);
+#if portNUM_PROCESSORS > 1
+		esp_ipc_call_blocking(xPortGetCoreID() == 0 ? 1 : 0, syncThisCore, nullptr);
+#endif
+	}
+
+	void writeChromeJson(const std::function<void(const char* data, size_t length)>& write) {
+		sync(); // So the newest events lie between two syncs
+		detail::paused.store(true);
+		vTaskDelay(1); // Let any event that got past the paused check finish
+
+		{
+			Writer out(write);
+			out.printf("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+			for (int core = 0; core < portNUM_PROCESSORS; ++core) {
+				out.printf("%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"Core %d\"}}",
+						out.separator(), core, core);
+			}
+
+			// Name the tasks that still exist - events from deleted tasks show their handle instead
+			const UBaseType_t maxTasks = uxTaskGetNumberOfTasks() + 4;
+			std::unique_ptr<TaskStatus_t[]> tasks(new (std::nothrow) TaskStatus_t[maxTasks]);
+			const UBaseType_t numTasks = tasks ? uxTaskGetSystemState(tasks.get(), maxTasks, nullptr) : 0;
+			for (UBaseType_t i = 0; i < numTasks; ++i) {
+				for (int core = 0; core < portNUM_PROCESSORS; ++core) {
+					out.printf("%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%lu,\"args\":{\"name\":\"%s\"}}",
+							out.separator(), core, (unsigned long)static_cast<uint32_t>(reinterpret_cast<uintptr_t>(tasks[i].xHandle)), tasks[i].pcTaskName);
+				}
+			}
+
+			for (int core = 0; core < portNUM_PROCESSORS; ++core) {
+				const detail::Ring& ring = detail::rings[core];
+				const uint32_t end = ring.head.load();
+				const uint32_t start = end > EVENTS_PER_CORE ? end - EVENTS_PER_CORE : 0;
+
+				Clock clock(ring, start, end);
+				for (uint32_t i = start; i != end; ++i) {
+					const Event& event = ring.events[i & (EVENTS_PER_CORE - 1)];
+					if (event.id == SYNC || event.id >= ID_COUNT) continue;
+
+					const char phase = static_cast<char>(event.phase);
+					out.printf("%s{\"name\":\"%s\",\"cat\":\"palooka\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%lu%s}",
+							out.separator(), NAMES[event.id], phase, clock.toMicros(i), core, (unsigned long)event.value,
+							phase == static_cast<char>(Phase::INSTANT) ? ",\"s\":\"t\"" : "");
+				}
+			}
+
+			out.printf("]}");
+		}
+
+		detail::paused.store(false);
+	}
+}
+
+#endif // PALOOKA_TRACE
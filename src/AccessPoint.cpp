@@ -1,10 +1,75 @@
 #include <Preferences.h>
+#include <esp_wifi.h>
+#include <algorithm>
 
 #include "AccessPoint.h"
+#include "ChannelScorer.h"
+#include <PalookaLog/Log.h>
+#include <PalookaTrace/Trace.h>
 #include "RobotTaskManager.h"
 
 namespace PalookaNetwork
 {
+	bool RadioConfig::isValid() const
+	{
+		return channel <= 13
+			&& txPowerQuarterDbm >= MIN_TX_POWER && txPowerQuarterDbm <= MAX_TX_POWER
+			&& (bandwidthMhz == 20 || bandwidthMhz == 40);
+	}
+
+	RadioConfig RadioConfig::load()
+	{
+		Preferences preferences;
+		preferences.begin("Palooka", true); // Read-only mode
+
+		RadioConfig config;
+		config.channel = preferences.getUChar("AP_Channel", AUTO_CHANNEL);
+		config.txPowerQuarterDbm = preferences.getChar("AP_TxPower", MAX_TX_POWER);
+		config.bandwidthMhz = preferences.getUChar("AP_Bandwidth", 20);
+
+		preferences.end();
+		return config.isValid() ? config : RadioConfig{};
+	}
+
+	void RadioConfig::save() const
+	{
+		Preferences preferences;
+		preferences.begin("Palooka", false);
+		preferences.putUChar("AP_Channel", channel);
+		preferences.putChar("AP_TxPower", txPowerQuarterDbm);
+		preferences.putUChar("AP_Bandwidth", bandwidthMhz);
+		preferences.end();
+	}
+
+	bool ArenaConfig::isValid() const
+	{
+		return !enabled || (ssid.length() > 0 && ssid.length() <= 32 && (password.length() == 0 || (password.length() >= 8 && password.length() <= 64)));
+	}
+
+	ArenaConfig ArenaConfig::load()
+	{
+		Preferences preferences;
+		preferences.begin("Palooka", true); // Read-only mode
+
+		ArenaConfig config;
+		config.enabled = preferences.getBool("Arena_Enabled", false);
+		config.ssid = preferences.getString("Arena_SSID", "");
+		config.password = preferences.getString("Arena_Password", "");
+
+		preferences.end();
+		return config.isValid() ? config : ArenaConfig{};
+	}
+
+	void ArenaConfig::save() const
+	{
+		Preferences preferences;
+		preferences.begin("Palooka", false);
+		preferences.putBool("Arena_Enabled", enabled);
+		preferences.putString("Arena_SSID", ssid);
+		preferences.putString("Arena_Password", password);
+		preferences.end();
+	}
+
 	// Public
 	AccessPoint::AccessPoint(const Route* routes, const size_t num_routes,
 			uint16_t webServerPort, uint16_t webSocketPort,
@@ -13,7 +78,7 @@ namespace PalookaNetwork
 		: SSID(generateSSID(SSID_BASE)),
 		ROUTES(routes), NUM_ROUTES(num_routes),
 		server(webServerPort), webSocket(webSocketPort),
-		DNS_SERVER_PORT(dnsServerPort)
+		DNS_SERVER_PORT(dnsServerPort), WEB_SOCKET_PORT(webSocketPort)
 	{}
 
 	bool AccessPoint::begin()
@@ -26,37 +91,84 @@ namespace PalookaNetwork
 		Preferences preferences;
 		preferences.begin("Palooka", false);  // Read-write mode
 
-		String AP_Name = preferences.getString("AP_Name", SSID.c_str()); // SSID is default SSID for the AP
+		name = preferences.getString("AP_Name", SSID.c_str()); // SSID is default SSID for the AP
 		String AP_Password = preferences.getString("AP_Password", ""); // No password as the default
+		maxCommandRate = preferences.getUShort("WS_MaxRate", DEFAULT_MAX_COMMAND_RATE);
 
 		preferences.end(); // Close the preferences
 
-		if(!WiFi.softAP(AP_Name, AP_Password)) // Start the ESP32 as an access point
+		const RadioConfig radioConfig = RadioConfig::load();
+		const ArenaConfig arenaConfig = ArenaConfig::load();
+
+		arenaMode = arenaConfig.enabled && joinArena(arenaConfig, radioConfig);
+		if(!arenaMode && !beginAccessPoint(AP_Password, radioConfig))
 		{
-			Serial.println("Failed to start Access Point");
 			return false;
 		}
 
-		// Start the DNS server to redirect all domain requests to the AP's IP.
-		dnsServer.start(DNS_SERVER_PORT, "*", WiFi.softAPIP());
-
 		registerServerRoutes();
+		if(!arenaMode) { captivePortal->begin(); } // On an arena network the checks go to the real internet
 
 		server.begin(); // Start the web server
 
 		webSocket.begin(); // Start the WebSocket server
+		// Drops connections that went silent (e.g. a phone that lost WiFi) within ~3 s instead of at the TCP timeout,
+		// so a reconnecting controller doesn't compete with its own dead connection. Browsers answer pings themselves.
+		webSocket.enableHeartbeat(1000, 1000, 2);
+		for(CommandRateLimiter& limiter : rateLimiters) { limiter.setMaxRate(maxCommandRate); }
 		webSocket.onEvent([this](uint8_t num, WStype_t type, uint8_t *payload, size_t length) {
-			if(type == WStype_TEXT) { handleWebSocketMessage(payload, length); }
+			if((type == WStype_CONNECTED || type == WStype_DISCONNECTED) && num < WEBSOCKETS_SERVER_CLIENT_MAX)
+			{
+				rateLimiters[num].reset();
+				isCommandHeld[num] = false;
+			}
+			if(type == WStype_CONNECTED)
+			{
+				sendSnapshot(num); // First, so a reconnecting controller is up to date straight away
+				captivePortal->noteControllerConnected(webSocket.remoteIP(num));
+			}
+			if(type == WStype_DISCONNECTED && num == driverClient) { driverClient = -1; }
+			if(type == WStype_DISCONNECTED) { udpControl.closeSession(num); } // Its UDP frames stop driving with it
+			if(type == WStype_CONNECTED || type == WStype_DISCONNECTED)
+			{
+				PalookaBot::FlipperBot::getInstance().getStatusLed()
+					.setCondition(PalookaBot::StatusLed::Condition::CLIENT_CONNECTED, webSocket.connectedClients() > 0);
+			}
+			if(type == WStype_TEXT) { handleWebSocketMessage(num, payload, length); }
 		});
 
+		if(!udpControl.begin())
+		{
+			Serial.println("Failed to start UDP control channel"); // WebSocket control still works
+		}
+
+		if(arenaMode && !beacon.begin(name, WEB_SOCKET_PORT, udpControl.getPort()))
+		{
+			Serial.println("Failed to start arena beacon"); // Robots can still be reached by IP
+		}
+
 		return true;
 	}
 
 	void AccessPoint::handleClients()
 	{
-		dnsServer.processNextRequest();
+		if(!arenaMode) { dnsServer.processNextRequest(); }
+
+		TRACE_BEGIN(AP_HTTP);
 		server.handleClient();
+		TRACE_END(AP_HTTP);
+
+		TRACE_BEGIN(AP_WEBSOCKET_LOOP);
 		webSocket.loop();
+		TRACE_END(AP_WEBSOCKET_LOOP);
+
+		TRACE_BEGIN(AP_UDP_POLL);
+		pollUdpControl();
+		TRACE_END(AP_UDP_POLL);
+
+		sendHeldCommands();
+
+		beacon.poll();
 	}
 
 	void AccessPoint::sendWebSocketMessage(const String& message) {
@@ -64,6 +176,32 @@ namespace PalookaNetwork
 		webSocket.broadcastTXT(mutableMessage);
 	}
 
+	void AccessPoint::setMaxCommandRate(uint16_t perSecond)
+	{
+		maxCommandRate = perSecond;
+		for(CommandRateLimiter& limiter : rateLimiters) { limiter.setMaxRate(perSecond); }
+
+		Preferences preferences;
+		preferences.begin("Palooka", false);
+		preferences.putUShort("WS_MaxRate", perSecond);
+		preferences.end();
+	}
+
+	IPAddress AccessPoint::getIP() const
+	{
+		return arenaMode ? WiFi.localIP() : WiFi.softAPIP();
+	}
+
+	ControlStats AccessPoint::getControlStats() const
+	{
+		return ControlStats{
+			continuousReceived,
+			rateLimited,
+			udpAccepted,
+			udpControl.getDroppedCount() + udpQueueFull
+		};
+	}
+
 
 	// Private
 	const String AccessPoint::generateSSID(const String& SSID_BASE)
@@ -75,12 +213,102 @@ namespace PalookaNetwork
 		return SSID_BASE + macStr;
 	}
 
+	// Scanning needs station mode, so this must run before the AP is started
+	uint8_t AccessPoint::scanForLeastCongestedChannel()
+	{
+		constexpr size_t MAX_SCAN_RESULTS = 64;
+
+		WiFi.mode(WIFI_STA);
+		const int16_t found = WiFi.scanNetworks(false, true); // Blocking, include hidden networks
+		if(found <= 0)
+		{
+			WiFi.scanDelete();
+			return ChannelScorer::DEFAULT_CANDIDATES[0];
+		}
+
+		ChannelScorer::ScanResult results[MAX_SCAN_RESULTS];
+		const size_t numResults = std::min<size_t>(found, MAX_SCAN_RESULTS);
+		for(size_t i{0}; i < numResults; i++)
+		{
+			results[i] = {static_cast<uint8_t>(WiFi.channel(i)), static_cast<int8_t>(WiFi.RSSI(i))};
+			// Same format for every line so scans can be copied off the serial monitor and replayed on a host
+			Serial.printf("[AP] scan channel=%u rssi=%d\n", results[i].channel, results[i].rssi);
+		}
+		WiFi.scanDelete();
+
+		const uint8_t best = ChannelScorer::pickChannel(results, numResults);
+		for(const uint8_t candidate : ChannelScorer::DEFAULT_CANDIDATES)
+		{
+			Serial.printf("[AP] channel %u score %.2f\n", candidate, ChannelScorer::scoreChannel(candidate, results, numResults));
+		}
+		Serial.printf("[AP] Using channel %u\n", best);
+		return best;
+	}
+
+	bool AccessPoint::beginAccessPoint(const String& password, const RadioConfig& radioConfig)
+	{
+		channel = (radioConfig.channel == RadioConfig::AUTO_CHANNEL) ? scanForLeastCongestedChannel() : radioConfig.channel;
+
+		WiFi.mode(WIFI_AP);
+		if(!WiFi.softAP(name, password, channel)) // Start the ESP32 as an access point
+		{
+			Serial.println("Failed to start Access Point");
+			return false;
+		}
+		applyRadioConfig(radioConfig, WIFI_IF_AP);
+
+		// Start the DNS server to redirect all domain requests to the AP's IP.
+		dnsServer.start(DNS_SERVER_PORT, "*", WiFi.softAPIP());
+		return true;
+	}
+
+	// The arena's AP picks the channel, so RadioConfig::channel doesn't apply here
+	bool AccessPoint::joinArena(const ArenaConfig& arenaConfig, const RadioConfig& radioConfig)
+	{
+		WiFi.mode(WIFI_STA);
+		WiFi.setAutoReconnect(true);
+		WiFi.begin(arenaConfig.ssid.c_str(), arenaConfig.password.length() ? arenaConfig.password.c_str() : nullptr);
+
+		const uint32_t startMs = millis();
+		while(WiFi.status() != WL_CONNECTED && millis() - startMs < ArenaConfig::CONNECT_TIMEOUT_MS)
+		{
+			delay(100);
+		}
+
+		if(WiFi.status() != WL_CONNECTED)
+		{
+			Serial.printf("[AP] Could not join arena \"%s\", starting own AP\n", arenaConfig.ssid.c_str());
+			WiFi.disconnect(true);
+			return false;
+		}
+
+		applyRadioConfig(radioConfig, WIFI_IF_STA);
+		channel = WiFi.channel();
+		Serial.printf("[AP] Joined arena \"%s\" as %s on channel %u\n",
+				arenaConfig.ssid.c_str(), WiFi.localIP().toString().c_str(), channel);
+		return true;
+	}
+
+	void AccessPoint::applyRadioConfig(const RadioConfig& config, const wifi_interface_t interface)
+	{
+		// Modem power-save delays frames to line up with beacons - never worth it for a control link
+		WiFi.setSleep(false);
+		esp_wifi_set_ps(WIFI_PS_NONE);
+
+		WiFi.setTxPower(static_cast<wifi_power_t>(config.txPowerQuarterDbm));
+		esp_wifi_set_bandwidth(interface, config.bandwidthMhz == 40 ? WIFI_BW_HT40 : WIFI_BW_HT20);
+	}
+
 	void AccessPoint::registerServerRoutes() {
+		// OS connectivity checks - first, so they never wait on a route or file lookup
+		captivePortal = new CaptivePortal();
+		server.addHandler(captivePortal);
+
 		// Custom routes
 		for(size_t i{0}; i < NUM_ROUTES; i++)
 		{
-			const auto& [endpoint, filePath, contentType, method, handler] = ROUTES[i];
-			server.on(endpoint, static_cast<HTTPMethod>(method), [this, filePath, contentType, handler]() {
+			const auto& [endpoint, filePath, contentType, method, handler, uploadHandler] = ROUTES[i];
+			auto requestHandler = [this, filePath, contentType, handler]() {
 				if(handler)
 				{
 					handler(&server);
@@ -88,7 +316,15 @@ namespace PalookaNetwork
 				}
 
 				serveFile(filePath, contentType);
-			});
+			};
+
+			if(uploadHandler)
+			{
+				server.on(endpoint, static_cast<HTTPMethod>(method), requestHandler, [this, uploadHandler]() { uploadHandler(&server); });
+				continue;
+			}
+
+			server.on(endpoint, static_cast<HTTPMethod>(method), requestHandler);
 		}
 
 		// Fallback static file serving
@@ -114,18 +350,25 @@ namespace PalookaNetwork
 		fileToServe.close();
 	}
 
-	void AccessPoint::handleWebSocketMessage(uint8_t *payload, size_t length)
+	void AccessPoint::handleWebSocketMessage(uint8_t clientNum, uint8_t *payload, size_t length)
 	{
+		TRACE_SCOPE(AP_WEBSOCKET_MESSAGE);
 		StaticJsonDocument<200> doc;
 		DeserializationError error = deserializeJson(doc, payload, length);
+		if(error == DeserializationError::NoMemory)
+		{
+			// Only macro uploads are too big for the control message document
+			handleMacroUpload(payload, length);
+			return;
+		}
 		if(error)
 		{
-			Serial.print("JSON parse error: ");
-			Serial.println(error.c_str());
+			LOG_WARN_EVERY_MS(1000, "JSON parse error: %s", error.c_str()); // A broken client sends nothing else
 			return;
 		}
 
 		CommandData cmdData = {0}; // Initialize the struct
+		cmdData.receivedMs = millis();
 
 		// Extract slider control data
 		if(doc.containsKey("sliderName") && doc.containsKey("value"))
@@ -146,12 +389,207 @@ namespace PalookaNetwork
 		{
 			cmdData.flip = true;
 		}
+		// Arming is saved to flash, so it's done here rather than stalling the robot task
 		else if(doc.containsKey("toggleBoost") && doc["toggleBoost"])
 		{
-			cmdData.toggleBoost = true;
+			Robot::RobotTaskManager::getInstance().getBoostGovernor().toggleArmed();
+			return;
+		}
+		else if(doc.containsKey("runMacro"))
+		{
+			strlcpy(cmdData.macroName, doc["runMacro"] | "", sizeof(cmdData.macroName));
+			cmdData.runMacro = true;
+		}
+		// Small macro uploads fit the control message document too
+		else if(doc.containsKey("macro"))
+		{
+			handleMacroUpload(payload, length);
+			return;
+		}
+		else if(doc.containsKey("udpHello") && doc["udpHello"])
+		{
+			openUdpSession(clientNum);
+			return;
+		}
+		// Latency probe - answered straight from the network task, without touching the robot
+		else if(doc.containsKey("ping"))
+		{
+			replyToPing(clientNum, doc["ping"]);
+			return;
 		}
 
+		if((cmdData.hasSlider || cmdData.hasJoystick) && !admitContinuous(clientNum, cmdData)) { return; }
+
 		// Enqueue the compact command data for processing by the robotControlTask.
 		xQueueSend(Robot::RobotTaskManager::getInstance().getQueue(), &cmdData, portMAX_DELAY);
 	}
+
+	// Replies with the port and token the client must put in its UDP control frames
+	void AccessPoint::openUdpSession(uint8_t clientNum)
+	{
+		StaticJsonDocument<64> reply;
+		reply["udpPort"] = udpControl.getPort();
+		reply["udpToken"] = udpControl.openSession(clientNum);
+
+		String replyJson;
+		serializeJson(reply, replyJson);
+		webSocket.sendTXT(clientNum, replyJson);
+	}
+
+	// Forwards the newest UDP frame as if its session's owner had sent it over the WebSocket
+	void AccessPoint::pollUdpControl()
+	{
+		ControlFrame::Frame frame;
+		if(!udpControl.poll(frame)) { return; }
+
+		CommandData cmdData = {0};
+		cmdData.x = frame.x;
+		cmdData.y = frame.y;
+		cmdData.hasJoystick = true;
+		cmdData.receivedMs = millis();
+		if(!admitContinuous(udpControl.getSessionClient(), cmdData)) { return; }
+
+		// A move never waits: if the queue is full it is already stale, and the next frame will replace it.
+		// A stop waits for room like every WebSocket command, since there may be no later frame to repeat it.
+		const TickType_t wait = cmdData.isStop() ? portMAX_DELAY : 0;
+		if(xQueueSend(Robot::RobotTaskManager::getInstance().getQueue(), &cmdData, wait) == pdPASS) { ++udpAccepted; }
+		else { ++udpQueueFull; }
+	}
+
+	// Joystick and slider messages can arrive far faster than they are worth applying, so each client is capped.
+	// A stop is always let through so releasing the stick is never lost. Returns false if the command shouldn't be
+	// sent now: the newest limited command is held and sent by sendHeldCommands() when the limiter next allows.
+	bool AccessPoint::admitContinuous(uint8_t clientNum, const CommandData& cmdData)
+	{
+		++continuousReceived;
+		if(clientNum >= WEBSOCKETS_SERVER_CLIENT_MAX) { return true; }
+
+		// A held command is dropped either way, as this one is newer
+		if(isCommandHeld[clientNum]) { ++rateLimited; }
+
+		if(!cmdData.isStop() && !rateLimiters[clientNum].allow(millis()))
+		{
+			TRACE_INSTANT(AP_RATE_LIMITED);
+			heldCommands[clientNum] = cmdData;
+			isCommandHeld[clientNum] = true;
+			return false;
+		}
+		isCommandHeld[clientNum] = false;
+		driverClient = clientNum;
+		return true;
+	}
+
+	void AccessPoint::sendHeldCommands()
+	{
+		for(uint8_t clientNum = 0; clientNum < WEBSOCKETS_SERVER_CLIENT_MAX; ++clientNum)
+		{
+			if(!isCommandHeld[clientNum] || !rateLimiters[clientNum].allow(millis())) { continue; }
+
+			// Never a stop, so it doesn't wait for room - if the queue is full, the robot is behind and it's stale
+			if(xQueueSend(Robot::RobotTaskManager::getInstance().getQueue(), &heldCommands[clientNum], 0) != pdPASS) { continue; }
+			isCommandHeld[clientNum] = false;
+			driverClient = clientNum;
+		}
+	}
+
+	void AccessPoint::replyToPing(uint8_t clientNum, uint32_t id)
+	{
+		char reply[32];
+		snprintf(reply, sizeof(reply), "{\"pong\":%lu}", (unsigned long)id);
+		webSocket.sendTXT(clientNum, reply);
+	}
+
+	// Sent to each client as it connects, so a controller that reconnects after a WiFi blip doesn't have to wait
+	// for the next broadcast: {"snapshot":1,"boost":false,"autoBoost":true,"flipper":0,"battery":87,"driver":-1,"client":0}
+	// driver is the client whose input is driving the robot (-1 if none). battery is left out until it has been read.
+	// autoBoost is whether the boost button has the governor armed; boost is whether boost is on right now.
+	void AccessPoint::sendSnapshot(uint8_t clientNum)
+	{
+		const PalookaBot::FlipperBot& robot = PalookaBot::FlipperBot::getInstance();
+		Robot::RobotTaskManager& robotManager = Robot::RobotTaskManager::getInstance();
+		const int batteryPercent = robotManager.getLastBatteryPercent();
+
+		StaticJsonDocument<192> doc;
+		doc["snapshot"] = 1;
+		doc["boost"] = robot.isBoostEnabled();
+		doc["autoBoost"] = robotManager.getBoostGovernor().isArmed();
+		doc["flipper"] = robot.getFlipperAngle();
+		if(batteryPercent >= 0) { doc["battery"] = batteryPercent; }
+		doc["driver"] = driverClient;
+		doc["client"] = clientNum;
+
+		String message;
+		serializeJson(doc, message);
+		webSocket.sendTXT(clientNum, message);
+	}
+
+	// Expects {"macro": "name", "steps": [{"move": [x, y], "ms": 150}, {"flipper": 180, "ms": 300}, {"boost": true, "ms": 0}]}
+	// An empty steps array deletes the macro.
+	void AccessPoint::handleMacroUpload(uint8_t *payload, size_t length)
+	{
+		DynamicJsonDocument doc(2048);
+		DeserializationError error = deserializeJson(doc, payload, length);
+		if(error)
+		{
+			LOG_WARN("Macro JSON parse error: %s", error.c_str());
+			return;
+		}
+
+		const char* name = doc["macro"];
+		JsonArrayConst stepsJson = doc["steps"];
+		if(!name || stepsJson.isNull())
+		{
+			LOG_WARN("Macro upload needs a name and steps.");
+			return;
+		}
+
+		Robot::MacroEngine& macros = Robot::RobotTaskManager::getInstance().getMacroEngine();
+		if(stepsJson.size() == 0)
+		{
+			macros.remove(name);
+			return;
+		}
+
+		Robot::MacroStep steps[Robot::MacroEngine::MAX_STEPS];
+		size_t numSteps{0};
+		for(JsonObjectConst stepJson : stepsJson)
+		{
+			if(numSteps >= Robot::MacroEngine::MAX_STEPS)
+			{
+				LOG_WARN("Macro has too many steps.");
+				return;
+			}
+
+			Robot::MacroStep& step = steps[numSteps++];
+			step = Robot::MacroStep{};
+			step.durationMs = stepJson["ms"] | 0;
+
+			if(stepJson.containsKey("move"))
+			{
+				step.type = Robot::MacroStep::Type::MOVE;
+				step.x = stepJson["move"][0] | 0.0f;
+				step.y = stepJson["move"][1] | 0.0f;
+			}
+			else if(stepJson.containsKey("flipper"))
+			{
+				step.type = Robot::MacroStep::Type::FLIPPER;
+				step.angle = stepJson["flipper"] | 0;
+			}
+			else if(stepJson.containsKey("boost"))
+			{
+				step.type = Robot::MacroStep::Type::BOOST;
+				step.boost = stepJson["boost"] | false;
+			}
+			else
+			{
+				LOG_WARN("Unknown macro step.");
+				return;
+			}
+		}
+
+		if(!macros.define(name, steps, numSteps))
+		{
+			LOG_WARN("Macro could not be stored.");
+		}
+	}
 }
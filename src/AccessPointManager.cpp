@@ -1,9 +1,12 @@
 #include <Preferences.h>
 #include <ArduinoJson.h>
+#include <Update.h>
 
 #include "AccessPointManager.h"
 #include "RobotTaskManager.h"
+#include "system/JobManager.h"
 #include "system/NVSUtils.h"
+#include <PalookaTrace/Trace.h>
 
 namespace PalookaNetwork {
 	namespace {
@@ -128,37 +131,606 @@ namespace PalookaNetwork {
 			server->send(200, "application/json", jsonResponse);
 		}
 
-		void handleRestart(WebServer* server) {
-			server->send(200, "application/json", "{\"status\":\"ok\"}");
+		// ========== Jobs ==========
+		// Slow operations run on the JobManager task. Handlers reply at once with the job ID,
+		// and the client polls /jobs?id= or waits for the {"job": id, ...} WebSocket message.
+		bool restartJob() {
 			delay(1000); // Ensure there is enough time to send & read response in browser
 			ESP.restart();
+			return true;
+		}
+
+		bool calibrateBatteryJob() {
+			return Robot::RobotTaskManager::getInstance().requestBatteryCalibration();
+		}
+
+		bool factoryResetJob() {
+			System::Utils::wipeNVSPartition();
+			delay(1000); // Give the response time to send
+			ESP.restart(); // Restart the device
+			return true;
+		}
+
+		// Returns the job ID, or 0 after sending a 503
+		uint32_t submitJob(WebServer* server, const char* name, System::JobManager::JobFunction function) {
+			const uint32_t id = System::JobManager::getInstance().submit(name, function);
+			if (!id) {
+				server->send(503, "application/json", "{\"status\":\"error\",\"message\":\"Too many jobs in progress\"}");
+			}
+			return id;
+		}
+
+		void handleJobStatus(WebServer* server) {
+			const uint32_t id = server->arg("id").toInt();
+			const char* name{nullptr};
+			const System::JobManager::Status status = System::JobManager::getInstance().getStatus(id, &name);
+			if (status == System::JobManager::Status::UNKNOWN) {
+				server->send(404, "application/json", "{\"status\":\"unknown\"}");
+				return;
+			}
+
+			StaticJsonDocument<128> doc;
+			doc["job"] = id;
+			doc["name"] = name;
+			doc["status"] = System::JobManager::statusToString(status);
+
+			String response;
+			serializeJson(doc, response);
+			server->send(200, "application/json", response);
+		}
+
+		void handleRestart(WebServer* server) {
+			const uint32_t id = submitJob(server, "restart", restartJob);
+			if (!id) return;
+
+			char response[48];
+			snprintf(response, sizeof(response), "{\"status\":\"ok\",\"job\":%lu}", (unsigned long)id);
+			server->send(200, "application/json", response);
 		}
 
 		void handleCalibrateBattery(WebServer* server) {
-			const char* success = Robot::RobotTaskManager::getInstance().requestBatteryCalibration() ? "true" : "false";
-			const char responseTemplate[] = "{\"success\": %s}";
-			size_t responseSize = sizeof(responseTemplate) + strlen(success);
+			const uint32_t id = submitJob(server, "calibrateBattery", calibrateBatteryJob);
+			if (!id) return;
+
+			char response[32];
+			snprintf(response, sizeof(response), "{\"job\":%lu}", (unsigned long)id);
+			server->send(202, "application/json", response);
+		}
+
+		void handleServoProfileGet(WebServer* server) {
+			PalookaBot::FlipperBot& robot = PalookaBot::FlipperBot::getInstance();
+			const PalookaBot::ServoProfile& profile = robot.getFlipperProfile();
+
+			StaticJsonDocument<256> doc;
+			doc["profile"] = profile.name;
+			doc["periodHertz"] = profile.periodHertz;
+			doc["minPulseUs"] = profile.minPulseUs;
+			doc["maxPulseUs"] = profile.maxPulseUs;
+			// Counting frames on the pin holds up the network loop for a quarter of a second, so only on request
+			if (server->arg("measure") == "1") {
+				doc["measuredHertz"] = robot.measureFlipperFrameHertz();
+			}
+			JsonArray available = doc.createNestedArray("available");
+			for (const PalookaBot::ServoProfile& preset : PalookaBot::ServoProfiles::ALL) {
+				available.add(preset.name);
+			}
+
+			String response;
+			serializeJson(doc, response);
+			server->send(200, "application/json", response);
+		}
+
+		void handleServoProfilePost(WebServer* server) {
+			if (!server->hasArg("plain")) {
+				server->send(400, "text/plain", "Bad Request: no data received");
+				return;
+			}
+
+			StaticJsonDocument<100> doc;
+			if (deserializeJson(doc, server->arg("plain"))) {
+				server->send(400, "text/plain", "Invalid JSON");
+				return;
+			}
+
+			const PalookaBot::ServoProfile* profile = PalookaBot::ServoProfiles::findByName(doc["profile"].as<const char*>());
+			if (!profile || !PalookaBot::FlipperBot::getInstance().setFlipperProfile(*profile)) {
+				server->send(400, "application/json", "{\"status\":\"Bad Request\",\"message\":\"Unknown servo profile\"}");
+				return;
+			}
+
+			server->send(200, "application/json", "{\"status\":\"ok\"}");
+		}
+
+		void handleDriveProfileGet(WebServer* server) {
+			const PalookaBot::DriveProfile& profile = PalookaBot::FlipperBot::getInstance().getDriveProfile();
+
+			StaticJsonDocument<256> doc;
+			doc["profile"] = profile.name;
+			doc["decay"] = profile.decayMode == PalookaBot::DecayMode::SLOW ? "slow" : "fast";
+			doc["brakeOnRelease"] = profile.brakeOnRelease;
+			doc["reversalBrakeMs"] = profile.reversalBrakeMs;
+			JsonArray available = doc.createNestedArray("available");
+			for (const PalookaBot::DriveProfile& preset : PalookaBot::DriveProfiles::ALL) {
+				available.add(preset.name);
+			}
+
+			String response;
+			serializeJson(doc, response);
+			server->send(200, "application/json", response);
+		}
+
+		void handleDriveProfilePost(WebServer* server) {
+			if (!server->hasArg("plain")) {
+				server->send(400, "text/plain", "Bad Request: no data received");
+				return;
+			}
+
+			StaticJsonDocument<100> doc;
+			if (deserializeJson(doc, server->arg("plain"))) {
+				server->send(400, "text/plain", "Invalid JSON");
+				return;
+			}
+
+			const PalookaBot::DriveProfile* profile = PalookaBot::DriveProfiles::findByName(doc["profile"].as<const char*>());
+			if (!profile) {
+				server->send(400, "application/json", "{\"status\":\"Bad Request\",\"message\":\"Unknown drive profile\"}");
+				return;
+			}
+			PalookaBot::FlipperBot::getInstance().setDriveProfile(*profile);
+
+			server->send(200, "application/json", "{\"status\":\"ok\"}");
+		}
+
+		void handlePowerGet(WebServer* server) {
+			const Robot::PowerManager& power = Robot::RobotTaskManager::getInstance().getPowerManager();
+			const Robot::PowerManager::Report report = power.getReport();
+			const Robot::FrequencyGovernor::Report frequency = power.getFrequencyReport();
+
+			StaticJsonDocument<512> doc;
+			doc["idle"] = report.isIdle;
+			doc["idleTimeoutMs"] = report.idleTimeoutMs;
+			doc["lastWakeLatencyUs"] = report.lastWakeLatencyUs;
+			doc["maxWakeLatencyUs"] = report.maxWakeLatencyUs;
+			doc["wakeCount"] = report.wakeCount;
+			doc["totalIdleMs"] = report.totalIdleMs;
+			doc["estimatedIdleSavingMa"] = report.estimatedSavingMa;
+			doc["estimatedSavedMah"] = report.estimatedSavedMah;
+
+			doc["cpuMhz"] = frequency.currentMhz;
+			JsonObject timeAtMhz = doc.createNestedObject("msAtMhz");
+			for (const Robot::FrequencyGovernor::TimeAt& entry : frequency.timeAt) {
+				if (entry.mhz != 0) timeAtMhz[String(entry.mhz)] = entry.ms;
+			}
+			doc["rampUps"] = frequency.rampUps;
+			doc["lastRampUpUs"] = frequency.lastRampUpUs;
+			doc["maxRampUpUs"] = frequency.maxRampUpUs;
+
+			String response;
+			serializeJson(doc, response);
+			server->send(200, "application/json", response);
+		}
+
+		void handlePowerPost(WebServer* server) {
+			if (!server->hasArg("plain")) {
+				server->send(400, "text/plain", "Bad Request: no data received");
+				return;
+			}
+
+			StaticJsonDocument<100> doc;
+			if (deserializeJson(doc, server->arg("plain")) || !doc.containsKey("idleTimeoutMs")) {
+				server->send(400, "text/plain", "Invalid JSON");
+				return;
+			}
+
+			// A negative or non-numeric timeout would read as 0 and silently turn idling off
+			if (!doc["idleTimeoutMs"].is<uint32_t>()
+					|| !Robot::RobotTaskManager::getInstance().getPowerManager().setIdleTimeout(doc["idleTimeoutMs"])) {
+				server->send(400, "application/json", "{\"status\":\"Bad Request\",\"message\":\"Idle timeout must be 0 or at least 5000 ms\"}");
+				return;
+			}
+
+			server->send(200, "application/json", "{\"status\":\"ok\"}");
+		}
+
+		void handleRadioGet(WebServer* server) {
+			const RadioConfig config = RadioConfig::load();
+
+			StaticJsonDocument<128> doc;
+			doc["channel"] = AccessPointManager::getInstance().getChannel(); // In use right now
+			doc["configuredChannel"] = config.channel; // 0 means automatic
+			doc["txPowerQuarterDbm"] = config.txPowerQuarterDbm;
+			doc["bandwidthMhz"] = config.bandwidthMhz;
+
+			String response;
+			serializeJson(doc, response);
+			server->send(200, "application/json", response);
+		}
+
+		// Changes take effect after a restart
+		void handleRadioPost(WebServer* server) {
+			if (!server->hasArg("plain")) {
+				server->send(400, "text/plain", "Bad Request: no data received");
+				return;
+			}
+
+			StaticJsonDocument<128> doc;
+			if (deserializeJson(doc, server->arg("plain"))) {
+				server->send(400, "text/plain", "Invalid JSON");
+				return;
+			}
+
+			RadioConfig config = RadioConfig::load();
+			config.channel = doc["channel"] | config.channel;
+			config.txPowerQuarterDbm = doc["txPowerQuarterDbm"] | config.txPowerQuarterDbm;
+			config.bandwidthMhz = doc["bandwidthMhz"] | config.bandwidthMhz;
+
+			if (!config.isValid()) {
+				server->send(400, "application/json", "{\"status\":\"Bad Request\",\"message\":\"Invalid radio settings\"}");
+				return;
+			}
+
+			config.save();
+			server->send(200, "application/json", "{\"status\":\"ok\"}");
+		}
+
+		void handleBoostGet(WebServer* server) {
+			const Robot::BoostGovernor::Report report = Robot::RobotTaskManager::getInstance().getBoostGovernor().getReport();
+
+			StaticJsonDocument<256> doc;
+			doc["armed"] = report.isArmed;
+			doc["boosted"] = report.isBoosted;
+			doc["reason"] = Robot::BoostGovernor::reasonName(report.reason);
+			doc["heat"] = report.heat;
+			doc["dutyCreditMs"] = report.dutyCreditMs;
+			doc["boostCount"] = report.boostCount;
+			doc["cutoffCount"] = report.cutoffCount;
+			doc["totalBoostedMs"] = report.totalBoostedMs;
+
+			String response;
+			serializeJson(doc, response);
+			server->send(200, "application/json", response);
+		}
+
+		// {"armed": true} lets the governor turn boost on. Off until the driver opts in, and remembered across restarts.
+		void handleBoostPost(WebServer* server) {
+			if (!server->hasArg("plain")) {
+				server->send(400, "text/plain", "Bad Request: no data received");
+				return;
+			}
+
+			StaticJsonDocument<64> doc;
+			if (deserializeJson(doc, server->arg("plain"))) {
+				server->send(400, "text/plain", "Invalid JSON");
+				return;
+			}
+			if (!doc["armed"].is<bool>()) {
+				server->send(400, "application/json", "{\"status\":\"Bad Request\",\"message\":\"Expected armed: true or false\"}");
+				return;
+			}
+
+			Robot::RobotTaskManager::getInstance().getBoostGovernor().setArmed(doc["armed"].as<bool>());
+			server->send(200, "application/json", "{\"status\":\"ok\"}");
+		}
+
+		void handleControlGet(WebServer* server) {
+			AccessPointManager& manager = AccessPointManager::getInstance();
+			const ControlStats stats = manager.getControlStats();
+
+			StaticJsonDocument<256> doc;
+			doc["maxCommandRateHz"] = manager.getMaxCommandRate();
+			doc["received"] = stats.continuousReceived;
+			doc["rateLimited"] = stats.rateLimited;
+			doc["udpAccepted"] = stats.udpAccepted;
+			doc["udpDropped"] = stats.udpDropped;
+			doc["applied"] = Robot::RobotTaskManager::getInstance().getAppliedCommandCount();
+
+			const Robot::CommandDeadline::Report deadline = Robot::RobotTaskManager::getInstance().getCommandDeadline().getReport();
+			doc["maxCommandAgeMs"] = deadline.maxAgeMs;
+			doc["silenceStopMs"] = deadline.silenceStopMs;
+			doc["expired"] = deadline.expired;
+			doc["silenceStops"] = deadline.silenceStops;
+
+			String response;
+			serializeJson(doc, response);
+			server->send(200, "application/json", response);
+		}
+
+		void handleControlPost(WebServer* server) {
+			if (!server->hasArg("plain")) {
+				server->send(400, "text/plain", "Bad Request: no data received");
+				return;
+			}
+
+			StaticJsonDocument<128> doc;
+			if (deserializeJson(doc, server->arg("plain"))) {
+				server->send(400, "text/plain", "Invalid JSON");
+				return;
+			}
 
-			char response[responseSize];
-			snprintf(response, responseSize, responseTemplate, success);
+			Robot::CommandDeadline& deadline = Robot::RobotTaskManager::getInstance().getCommandDeadline();
+			// A negative or non-numeric value would read as 0 and silently turn the stop or the check off
+			if (doc.containsKey("silenceStopMs")
+					&& (!doc["silenceStopMs"].is<uint32_t>() || !deadline.setSilenceStop(doc["silenceStopMs"]))) {
+				server->send(400, "application/json", "{\"status\":\"Bad Request\",\"message\":\"Silence stop must be 0 or at least 300 ms\"}");
+				return;
+			}
+			if (doc.containsKey("maxCommandAgeMs")
+					&& (!doc["maxCommandAgeMs"].is<uint32_t>() || !deadline.setMaxAge(doc["maxCommandAgeMs"]))) {
+				server->send(400, "application/json", "{\"status\":\"Bad Request\",\"message\":\"Max command age must be 0 or at least 50 ms\"}");
+				return;
+			}
+			// Same for the rate, which would turn limiting off, and anything over 65535 would be truncated
+			if (doc.containsKey("maxCommandRateHz")) {
+				if (!doc["maxCommandRateHz"].is<uint16_t>()) {
+					server->send(400, "application/json", "{\"status\":\"Bad Request\",\"message\":\"Max command rate must be 0 to 65535\"}");
+					return;
+				}
+				AccessPointManager::getInstance().setMaxCommandRate(doc["maxCommandRateHz"]);
+			}
+
+			server->send(200, "application/json", "{\"status\":\"ok\"}");
+		}
+
+		// ========== Arena mode ==========
+		void handleNetworkGet(WebServer* server) {
+			AccessPointManager& manager = AccessPointManager::getInstance();
+			const ArenaConfig config = ArenaConfig::load();
+
+			StaticJsonDocument<192> doc;
+			doc["mode"] = manager.isArenaMode() ? "arena" : "ap";
+			doc["arenaEnabled"] = config.enabled; // Differs from mode if the arena couldn't be joined
+			doc["arenaSsid"] = config.ssid;
+			doc["ip"] = manager.getIP().toString();
+			doc["channel"] = manager.getChannel();
+
+			String response;
+			serializeJson(doc, response);
 			server->send(200, "application/json", response);
 		}
 
+		// Takes effect after a restart
+		void handleNetworkPost(WebServer* server) {
+			if (!server->hasArg("plain")) {
+				server->send(400, "text/plain", "Bad Request: no data received");
+				return;
+			}
+
+			StaticJsonDocument<256> doc;
+			if (deserializeJson(doc, server->arg("plain"))) {
+				server->send(400, "text/plain", "Invalid JSON");
+				return;
+			}
+
+			ArenaConfig config = ArenaConfig::load();
+			if (doc.containsKey("arenaEnabled")) {
+				if (!doc["arenaEnabled"].is<bool>()) {
+					server->send(400, "application/json", "{\"status\":\"Bad Request\",\"message\":\"Expected arenaEnabled: true or false\"}");
+					return;
+				}
+				config.enabled = doc["arenaEnabled"].as<bool>();
+			}
+			if (doc.containsKey("arenaSsid")) config.ssid = doc["arenaSsid"] | "";
+			if (doc.containsKey("arenaPassword")) config.password = doc["arenaPassword"] | "";
+
+			if (!config.isValid()) {
+				server->send(400, "application/json", "{\"status\":\"Bad Request\",\"message\":\"Invalid arena settings\"}");
+				return;
+			}
+
+			config.save();
+			server->send(200, "application/json", "{\"status\":\"ok\"}");
+		}
+
+		// Robots heard on the arena network, plus this one. Empty apart from this robot in AP mode.
+		void handleRobotsGet(WebServer* server) {
+			AccessPointManager& manager = AccessPointManager::getInstance();
+			RobotBeacon::Robot robots[RobotBeacon::MAX_ROBOTS];
+			const size_t count = manager.getArenaRobots(robots, RobotBeacon::MAX_ROBOTS);
+
+			DynamicJsonDocument doc(256 + count * 128);
+			JsonArray list = doc.createNestedArray("robots");
+
+			JsonObject self = list.createNestedObject();
+			self["name"] = manager.getName();
+			self["ip"] = manager.getIP().toString();
+			self["ws"] = manager.getWebSocketPort();
+			self["self"] = true;
+
+			const uint32_t now = millis();
+			for (size_t i = 0; i < count; ++i) {
+				JsonObject robot = list.createNestedObject();
+				robot["name"] = robots[i].name;
+				robot["ip"] = robots[i].ip.toString();
+				robot["ws"] = robots[i].webSocketPort;
+				robot["ageMs"] = now - robots[i].lastSeenMs;
+			}
+
+			String response;
+			serializeJson(doc, response);
+			server->send(200, "application/json", response);
+		}
+
+		// ========== Captive portal ==========
+		// Per OS family: connectivity checks answered, and how long devices took from their DHCP lease to the controller
+		void handleCaptiveGet(WebServer* server) {
+			AccessPointManager& manager = AccessPointManager::getInstance();
+
+			StaticJsonDocument<512> doc;
+			for (uint8_t i = 0; i < static_cast<uint8_t>(CaptivePortal::Family::COUNT); ++i) {
+				const CaptivePortal::Family family = static_cast<CaptivePortal::Family>(i);
+				const CaptivePortal::FamilyStats stats = manager.getCaptivePortalStats(family);
+
+				JsonObject entry = doc.createNestedObject(CaptivePortal::familyToString(family));
+				entry["probes"] = stats.probes;
+				entry["controllers"] = stats.controllers;
+				entry["lastJoinToControllerMs"] = stats.lastJoinToControllerMs;
+				entry["maxJoinToControllerMs"] = stats.maxJoinToControllerMs;
+			}
+
+			String response;
+			serializeJson(doc, response);
+			server->send(200, "application/json", response);
+		}
+
+		// ========== Black box ==========
+		// ?session=previous (default) is the recording that survived the last reset, ?session=current is the live one.
+		// Decode with dev_scripts/blackbox_decode.py.
+		void handleBlackBoxGet(WebServer* server) {
+			Robot::BlackBoxRecorder& blackBox = Robot::RobotTaskManager::getInstance().getBlackBox();
+			const bool wantsCurrent = server->arg("session") == "current";
+
+			const std::vector<uint8_t> file = wantsCurrent ? blackBox.exportCurrent() : blackBox.exportPrevious();
+			if (file.empty()) {
+				server->send(404, "application/json", "{\"status\":\"error\",\"message\":\"No recording\"}");
+				return;
+			}
+
+			server->sendHeader("Content-Disposition", wantsCurrent
+					? "attachment; filename=\"blackbox-current.bin\""
+					: "attachment; filename=\"blackbox-previous.bin\"");
+			server->send_P(200, "application/octet-stream", reinterpret_cast<const char*>(file.data()), file.size());
+		}
+
+		// ========== Tracing ==========
+		// Chrome trace-event JSON of the recent events on both cores - open it in chrome://tracing or ui.perfetto.dev.
+		// Only available in firmware built with PALOOKA_TRACE (pio run -e trace).
+		void handleTraceGet(WebServer* server) {
+#ifdef PALOOKA_TRACE
+			server->sendHeader("Content-Disposition", "attachment; filename=\"palooka-trace.json\"");
+			server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+			server->send(200, "application/json", "");
+			Trace::writeChromeJson([server](const char* data, size_t length) { server->sendContent(data, length); });
+			server->sendContent(""); // Ends the chunked response
+#else
+			server->send(404, "application/json", "{\"status\":\"error\",\"message\":\"Tracing is off - build with PALOOKA_TRACE (pio run -e trace)\"}");
+#endif
+		}
+
+		// ========== OTA updates ==========
+		// Images are streamed into flash one upload chunk at a time, so an image is never held in RAM.
+		// The client must pass the image's MD5 as ?md5=, and Update refuses to finish (or switch the boot
+		// partition) if it doesn't match.
+		struct OtaSession {
+			bool started;
+			bool failed;
+			bool filesystemUnmounted;
+			int command; // U_FLASH or U_SPIFFS
+			size_t bytesWritten;
+			uint32_t startMs;
+			uint32_t durationMs;
+			String error;
+		};
+		OtaSession otaSession{};
+
+		void failOta(const char* error) {
+			otaSession.failed = true;
+			otaSession.error = error;
+			Update.abort();
+		}
+
+		void handleOtaUpload(WebServer* server, int command) {
+			HTTPUpload& upload = server->upload();
+			switch (upload.status) {
+				case UPLOAD_FILE_START: {
+					otaSession = OtaSession{};
+					otaSession.command = command;
+					otaSession.startMs = millis();
+
+					const String md5 = server->arg("md5");
+					if (md5.length() != 32) {
+						otaSession.failed = true;
+						otaSession.error = "md5 query parameter required";
+						return;
+					}
+
+					// Stop the wheels - flash writes will stall the robot task. Waits for room like every other stop.
+					PalookaNetwork::CommandData stop = {0};
+					stop.hasJoystick = true;
+					stop.receivedMs = millis();
+					xQueueSend(Robot::RobotTaskManager::getInstance().getQueue(), &stop, portMAX_DELAY);
+
+					if (command == U_SPIFFS) {
+						LittleFS.end(); // The filesystem partition is overwritten in place
+						otaSession.filesystemUnmounted = true;
+					}
+					if (!Update.begin(UPDATE_SIZE_UNKNOWN, command) || !Update.setMD5(md5.c_str())) {
+						failOta(Update.errorString());
+						return;
+					}
+					otaSession.started = true;
+					Serial.printf("[OTA] Receiving %s image\n", command == U_FLASH ? "firmware" : "filesystem");
+					break;
+				}
+				case UPLOAD_FILE_WRITE:
+					if (!otaSession.started || otaSession.failed) return;
+					if (Update.write(upload.buf, upload.currentSize) != upload.currentSize) {
+						failOta(Update.errorString());
+						return;
+					}
+					otaSession.bytesWritten += upload.currentSize;
+					break;
+				case UPLOAD_FILE_END:
+					if (!otaSession.started || otaSession.failed) return;
+					otaSession.durationMs = millis() - otaSession.startMs;
+					// Verifies the MD5 and, for firmware, makes the new partition the boot partition
+					if (!Update.end(true)) {
+						otaSession.failed = true;
+						otaSession.error = Update.errorString();
+					}
+					break;
+				case UPLOAD_FILE_ABORTED:
+					failOta("Upload aborted");
+					break;
+			}
+		}
+
+		void handleOtaComplete(WebServer* server) {
+			const bool succeeded = otaSession.started && !otaSession.failed;
+			const uint32_t durationMs = otaSession.durationMs ? otaSession.durationMs : 1;
+
+			StaticJsonDocument<256> doc;
+			doc["success"] = succeeded;
+			doc["bytes"] = otaSession.bytesWritten;
+			doc["durationMs"] = otaSession.durationMs;
+			doc["kBps"] = otaSession.bytesWritten / (float)durationMs; // Bytes per ms = kB/s
+			if (!succeeded) doc["error"] = otaSession.error.length() ? otaSession.error.c_str() : "No image received";
+
+			// The web pages are gone once the filesystem is unmounted, so restart even if that upload failed.
+			// The restart job gives the response time to send without holding up the server.
+			uint32_t restartId{0};
+			if (succeeded || otaSession.filesystemUnmounted) {
+				restartId = System::JobManager::getInstance().submit("restart", restartJob);
+				doc["job"] = restartId;
+			}
+
+			String response;
+			serializeJson(doc, response);
+			server->send(succeeded ? 200 : 400, "application/json", response);
+			Serial.printf("[OTA] %s: %u bytes in %lu ms\n", succeeded ? "Done" : "Failed",
+					(unsigned)otaSession.bytesWritten, (unsigned long)otaSession.durationMs);
+
+			if ((succeeded || otaSession.filesystemUnmounted) && !restartId) {
+				// Every job slot is taken, but the new image has to be booted
+				delay(1000);
+				ESP.restart();
+			}
+		}
+
+		void handleFirmwareUpload(WebServer* server) { handleOtaUpload(server, U_FLASH); }
+		void handleFilesystemUpload(WebServer* server) { handleOtaUpload(server, U_SPIFFS); }
+
 		void handleFactoryReset(WebServer* server) {
-			System::Utils::wipeNVSPartition();
+			if (!submitJob(server, "factoryReset", factoryResetJob)) return;
 
 			const char* jsonResponse{
 				R"delimiter(
 				{
 						"status": "ok",
-						"message": "Factory reset complete. You will need to reconnect to our device."
+						"message": "Factory reset started. You will need to reconnect to our device."
 				}
 				)delimiter"
 			};
 			server->send(200, "application/json", jsonResponse);
-
-			delay(1000); // Give the response time to send
-			ESP.restart(); // Restart the device
 		}
 	}
 
@@ -170,12 +742,46 @@ namespace PalookaNetwork {
 			{"/restart", "/setup.html", "text/html", HttpMethod::POST, handleRestart},
 			{"/calibrateBattery", "/setup.html", "text/html", HttpMethod::GET, handleCalibrateBattery},
 			{"/factoryReset", "/setup.html", "application/json", HttpMethod::POST, handleFactoryReset},
+			{"/jobs", "/setup.html", "application/json", HttpMethod::GET, handleJobStatus},
+			{"/servoProfile", "/setup.html", "application/json", HttpMethod::GET, handleServoProfileGet},
+			{"/servoProfile", "/setup.html", "application/json", HttpMethod::POST, handleServoProfilePost},
+			{"/driveProfile", "/setup.html", "application/json", HttpMethod::GET, handleDriveProfileGet},
+			{"/driveProfile", "/setup.html", "application/json", HttpMethod::POST, handleDriveProfilePost},
+			{"/power", "/setup.html", "application/json", HttpMethod::GET, handlePowerGet},
+			{"/power", "/setup.html", "application/json", HttpMethod::POST, handlePowerPost},
+			{"/boost", "/setup.html", "application/json", HttpMethod::GET, handleBoostGet},
+			{"/boost", "/setup.html", "application/json", HttpMethod::POST, handleBoostPost},
+			{"/radio", "/setup.html", "application/json", HttpMethod::GET, handleRadioGet},
+			{"/radio", "/setup.html", "application/json", HttpMethod::POST, handleRadioPost},
+			{"/control", "/setup.html", "application/json", HttpMethod::GET, handleControlGet},
+			{"/control", "/setup.html", "application/json", HttpMethod::POST, handleControlPost},
+			{"/network", "/setup.html", "application/json", HttpMethod::GET, handleNetworkGet},
+			{"/network", "/setup.html", "application/json", HttpMethod::POST, handleNetworkPost},
+			{"/robots", "/setup.html", "application/json", HttpMethod::GET, handleRobotsGet},
+			{"/captive", "/setup.html", "application/json", HttpMethod::GET, handleCaptiveGet},
+			{"/blackbox", "/setup.html", "application/octet-stream", HttpMethod::GET, handleBlackBoxGet},
+			{"/trace", "/setup.html", "application/json", HttpMethod::GET, handleTraceGet},
+			{"/update/firmware", "/setup.html", "application/json", HttpMethod::POST, handleOtaComplete, handleFirmwareUpload},
+			{"/update/filesystem", "/setup.html", "application/json", HttpMethod::POST, handleOtaComplete, handleFilesystemUpload},
 	};
 	const size_t AccessPointManager::AP_ROUTES_COUNT{sizeof(AP_ROUTES) / sizeof(AP_ROUTES[0])};
 
 	bool AccessPointManager::begin() { return ap.begin(); }
 
-	void AccessPointManager::handleClients() { ap.handleClients(); }
+	void AccessPointManager::handleClients() {
+		ap.handleClients();
+
+		System::JobManager::getInstance().dispatchCompletions([this](uint32_t id, const char* name, System::JobManager::Status status) {
+			StaticJsonDocument<128> doc;
+			doc["job"] = id;
+			doc["name"] = name;
+			doc["status"] = System::JobManager::statusToString(status);
+
+			String message;
+			serializeJson(doc, message);
+			ap.sendWebSocketMessage(message);
+		});
+	}
 
 	void AccessPointManager::sendWebSocketMessage(const String& message) { ap.sendWebSocketMessage(message); }
 }
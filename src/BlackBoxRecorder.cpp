@@ -0,0 +1,125 @@
+#include "BlackBoxRecorder.h"
+
+#include <algorithm>
+#include <cstring>
+#include "esp_attr.h"
+#include "esp_system.h"
+
+namespace Robot {
+	namespace {
+		struct Ring {
+			uint32_t magic;
+			uint32_t bootCount;
+			uint16_t head;	// Next slot to write
+			uint16_t count;
+			uint32_t check;	// Guards against garbage left by a power-on. Doesn't cover head/count, which change every sample.
+			BlackBoxRecorder::Record records[BlackBoxRecorder::CAPACITY];
+		};
+
+		// Not cleared on boot. Only a power-on (or a reset that also cuts the RTC domain) loses it.
+		RTC_NOINIT_ATTR Ring ring;
+
+		uint32_t ringCheck() {
+			return ring.magic ^ (ring.bootCount * 2654435761u) ^ 0xA5A5A5A5u;
+		}
+
+		bool isRingValid() {
+			return ring.magic == BlackBoxRecorder::MAGIC
+				&& ring.head < BlackBoxRecorder::CAPACITY
+				&& ring.count <= BlackBoxRecorder::CAPACITY
+				&& ring.check == ringCheck();
+		}
+
+		// Caller must stop the ring being written while this runs
+		std::vector<uint8_t> serializeRing(uint8_t resetReason) {
+			BlackBoxRecorder::FileHeader header{};
+			header.magic = BlackBoxRecorder::MAGIC;
+			header.version = BlackBoxRecorder::FORMAT_VERSION;
+			header.recordSize = sizeof(BlackBoxRecorder::Record);
+			header.resetReason = resetReason;
+			header.samplePeriodMs = BlackBoxRecorder::SAMPLE_PERIOD_MS;
+			header.count = ring.count;
+			header.bootCount = ring.bootCount;
+
+			std::vector<uint8_t> file(sizeof(header) + ring.count * sizeof(BlackBoxRecorder::Record));
+			memcpy(file.data(), &header, sizeof(header));
+
+			// Oldest record first
+			const size_t oldest = (ring.head + BlackBoxRecorder::CAPACITY - ring.count) % BlackBoxRecorder::CAPACITY;
+			uint8_t* out = file.data() + sizeof(header);
+			for (size_t i = 0; i < ring.count; ++i) {
+				memcpy(out, &ring.records[(oldest + i) % BlackBoxRecorder::CAPACITY], sizeof(BlackBoxRecorder::Record));
+				out += sizeof(BlackBoxRecorder::Record);
+			}
+			return file;
+		}
+	}
+
+	void BlackBoxRecorder::begin() {
+		const esp_reset_reason_t resetReason = esp_reset_reason();
+		const bool survived = resetReason != ESP_RST_POWERON && isRingValid();
+
+		std::lock_guard<std::mutex> lock(ringMutex);
+		if (survived && ring.count > 0) {
+			previousRecording = serializeRing(resetReason);
+			Serial.printf("[BlackBox] kept %u samples from before reset (reason %d)\n", ring.count, (int)resetReason);
+		}
+
+		ring.bootCount = survived ? ring.bootCount + 1 : 1;
+		ring.magic = MAGIC;
+		ring.head = 0;
+		ring.count = 0;
+		ring.check = ringCheck();
+
+		nextSampleMs = millis();
+		isStarted = true;
+	}
+
+	void BlackBoxRecorder::noteCommand() {
+		lastCommandMs = millis();
+		hasCommand = true;
+		if (commandsSinceSample < UINT8_MAX) ++commandsSinceSample;
+	}
+
+	void BlackBoxRecorder::update(const bool isMacroRunning) {
+		if (!isStarted) return;
+
+		const uint32_t now = millis();
+		if ((int32_t)(now - nextSampleMs) < 0) return;
+
+		// Keep a fixed rate, but don't try to catch up after a long stall
+		nextSampleMs += SAMPLE_PERIOD_MS;
+		if ((int32_t)(now - nextSampleMs) >= 0) nextSampleMs = now + SAMPLE_PERIOD_MS;
+
+		Record record{};
+		record.timeMs = now;
+		record.batteryMv = (uint16_t)std::min<uint32_t>(robot.readInstantBatteryMilliVolts(), UINT16_MAX);
+		record.leftVelocity = robot.getLeftWheelVelocity();
+		record.rightVelocity = robot.getRightWheelVelocity();
+		record.flipperAngle = robot.getFlipperAngle();
+		record.flags = (robot.isBoostEnabled() ? FLAG_BOOST : 0)
+			| (robot.areActuatorsAsleep() ? FLAG_ACTUATORS_ASLEEP : 0)
+			| (isMacroRunning ? FLAG_MACRO_RUNNING : 0);
+		record.sinceCommandMs = hasCommand ? (uint16_t)std::min<uint32_t>(now - lastCommandMs, NO_COMMAND) : NO_COMMAND;
+		record.commands = commandsSinceSample;
+		commandsSinceSample = 0;
+
+		std::lock_guard<std::mutex> lock(ringMutex);
+		ring.records[ring.head] = record;
+		// Only publish the record once it is complete, so a reset mid-write loses one sample at most
+		ring.head = (ring.head + 1) % CAPACITY;
+		if (ring.count < CAPACITY) ++ring.count;
+	}
+
+	uint32_t BlackBoxRecorder::msUntilNextSample() const {
+		if (!isStarted) return UINT32_MAX;
+		const int32_t remaining = (int32_t)(nextSampleMs - millis());
+		return remaining > 0 ? remaining : 0;
+	}
+
+	std::vector<uint8_t> BlackBoxRecorder::exportCurrent() {
+		std::lock_guard<std::mutex> lock(ringMutex);
+		if (!isStarted) return {}; // The ring still holds the previous boot's recording (or garbage)
+		return serializeRing(0);
+	}
+}
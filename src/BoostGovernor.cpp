@@ -0,0 +1,119 @@
+#include "BoostGovernor.h"
+
+#include <PalookaLog/Log.h>
+#include <Preferences.h>
+#include <algorithm>
+#include <cmath>
+
+namespace Robot {
+	BoostGovernor::BoostGovernor() : BoostGovernor(Config{}) {}
+
+	BoostGovernor::BoostGovernor(const Config& config) : config(config), dutyCreditMs(config.dutyBurstMs) {}
+
+	void BoostGovernor::begin() {
+		Preferences prefs;
+		prefs.begin(PREFS_NAMESPACE, true); // read-only
+		armed = prefs.getBool(PREFS_ARMED, false);
+		prefs.end();
+	}
+
+	void BoostGovernor::setArmed(const bool isArmed) {
+		armed = isArmed;
+		LOG_INFO("[BoostGovernor] %s", isArmed ? "armed" : "disarmed");
+
+		Preferences prefs;
+		prefs.begin(PREFS_NAMESPACE, false);
+		prefs.putBool(PREFS_ARMED, isArmed);
+		prefs.end();
+	}
+
+	void BoostGovernor::noteDemand(const uint32_t nowMs) {
+		hasDemand = true;
+		lastDemandMs = nowMs;
+	}
+
+	void BoostGovernor::noteBatteryPercent(const int percent) {
+		batteryPercent = percent;
+	}
+
+	bool BoostGovernor::update(const uint32_t nowMs) {
+		if (!hasUpdated) {
+			lastUpdateMs = nowMs;
+			hasUpdated = true;
+		}
+		advance(nowMs - lastUpdateMs);
+		lastUpdateMs = nowMs;
+
+		const Reason newReason = decide(nowMs);
+		if (newReason == reason) return boosted;
+
+		const bool newBoosted = newReason == Reason::DEMAND;
+		if (boosted && !newBoosted && newReason != Reason::IDLE && newReason != Reason::DISARMED) {
+			++cutoffCount;
+			LOG_WARN("[BoostGovernor] off (%s) - heat %.2f, %lu ms of boost left", reasonName(newReason), heat,
+					static_cast<unsigned long>(dutyCreditMs));
+		} else {
+			LOG_INFO("[BoostGovernor] %s (%s)", newBoosted ? "on" : "off", reasonName(newReason));
+		}
+		if (newBoosted && !boosted) ++boostCount;
+
+		boosted = newBoosted;
+		reason = newReason;
+		return boosted;
+	}
+
+	BoostGovernor::Report BoostGovernor::getReport() const {
+		return Report{
+			armed.load(),
+			boosted,
+			reason,
+			heat,
+			static_cast<uint32_t>(dutyCreditMs),
+			boostCount,
+			cutoffCount,
+			totalBoostedMs
+		};
+	}
+
+	const char* BoostGovernor::reasonName(const Reason reason) {
+		switch (reason) {
+			case Reason::IDLE: return "idle";
+			case Reason::DEMAND: return "demand";
+			case Reason::DISARMED: return "disarmed";
+			case Reason::HEAT_LIMIT: return "heat limit";
+			case Reason::DUTY_LIMIT: return "duty limit";
+			case Reason::LOW_BATTERY: return "low battery";
+		}
+		return "unknown";
+	}
+
+	// Private
+	void BoostGovernor::advance(const uint32_t elapsedMs) {
+		if (elapsedMs == 0) return;
+
+		const float target = boosted ? BOOSTED_STEADY_HEAT : 0.0f;
+		heat = target + (heat - target) * std::exp(-static_cast<float>(elapsedMs) / config.heatTimeConstantMs);
+
+		if (boosted) {
+			dutyCreditMs -= elapsedMs;
+			totalBoostedMs += elapsedMs;
+		}
+		dutyCreditMs = std::clamp(dutyCreditMs + elapsedMs * config.maxDutyCycle, 0.0f, static_cast<float>(config.dutyBurstMs));
+	}
+
+	BoostGovernor::Reason BoostGovernor::decide(const uint32_t nowMs) {
+		// The limits recover whether or not boost is wanted, with hysteresis so boost doesn't chatter at the edge
+		if (heat >= 1.0f) isCoolingDown = true;
+		else if (isCoolingDown && heat <= config.heatResume) isCoolingDown = false;
+		if (dutyCreditMs <= 0.0f) isRecharging = true;
+		else if (isRecharging && dutyCreditMs >= config.dutyResumeMs) isRecharging = false;
+
+		if (!armed) return Reason::DISARMED;
+		const bool isHeld = hasDemand && (nowMs - lastDemandMs) < config.holdMs;
+		if (!isRequested && !isHeld) return Reason::IDLE;
+		if (batteryPercent >= 0 && batteryPercent <= config.lowBatteryPercent) return Reason::LOW_BATTERY;
+		if (isCoolingDown) return Reason::HEAT_LIMIT;
+		if (isRecharging) return Reason::DUTY_LIMIT;
+		return Reason::DEMAND;
+	}
+}
@@ -0,0 +1,102 @@
+#include "CaptivePortal.h"
+
+#include <algorithm>
+
+namespace PalookaNetwork {
+	// Paths are matched exactly, whatever the Host header says
+	const CaptivePortal::Probe CaptivePortal::PROBES[]{
+		{"/generate_204", Family::ANDROID, 204, "text/plain", ""},
+		{"/gen_204", Family::ANDROID, 204, "text/plain", ""},
+		{"/hotspot-detect.html", Family::APPLE, 200, "text/html", "<HTML><HEAD><TITLE>Success</TITLE></HEAD><BODY>Success</BODY></HTML>"},
+		{"/library/test/success.html", Family::APPLE, 200, "text/html", "<HTML><HEAD><TITLE>Success</TITLE></HEAD><BODY>Success</BODY></HTML>"},
+		{"/connecttest.txt", Family::WINDOWS, 200, "text/plain", "Microsoft Connect Test"},
+		{"/ncsi.txt", Family::WINDOWS, 200, "text/plain", "Microsoft NCSI"},
+		{"/success.txt", Family::OTHER, 200, "text/plain", "success\n"}, // Firefox
+	};
+	const size_t CaptivePortal::NUM_PROBES{sizeof(PROBES) / sizeof(PROBES[0])};
+
+	void CaptivePortal::begin() {
+		WiFi.onEvent([this](arduino_event_id_t /* event */, arduino_event_info_t info) {
+			noteJoined(info.wifi_ap_staipassigned.ip.addr);
+		}, ARDUINO_EVENT_WIFI_AP_STAIPASSIGNED);
+	}
+
+	void CaptivePortal::noteControllerConnected(const IPAddress& ip) {
+		std::lock_guard<std::mutex> lock(stationsMutex);
+		Station* station = findStation(static_cast<uint32_t>(ip));
+		if (!station || station->reachedController) return;
+
+		station->reachedController = true;
+		const uint32_t elapsedMs = millis() - station->joinedMs;
+		FamilyStats& familyStats = stats[static_cast<size_t>(station->family)];
+		++familyStats.controllers;
+		familyStats.lastJoinToControllerMs = elapsedMs;
+		familyStats.maxJoinToControllerMs = std::max(familyStats.maxJoinToControllerMs, elapsedMs);
+	}
+
+	CaptivePortal::FamilyStats CaptivePortal::getStats(const Family family) {
+		std::lock_guard<std::mutex> lock(stationsMutex);
+		return family < Family::COUNT ? stats[static_cast<size_t>(family)] : FamilyStats{};
+	}
+
+	const char* CaptivePortal::familyToString(const Family family) {
+		switch (family) {
+			case Family::ANDROID: return "android";
+			case Family::APPLE: return "apple";
+			case Family::WINDOWS: return "windows";
+			default: return "other";
+		}
+	}
+
+	bool CaptivePortal::canHandle(HTTPMethod method, String uri) {
+		return method == HTTP_GET && find(uri);
+	}
+
+	bool CaptivePortal::handle(WebServer& server, HTTPMethod requestMethod, String requestUri) {
+		const Probe* probe = find(requestUri);
+		if (!probe) return false;
+
+		server.sendHeader("Cache-Control", "no-cache, no-store");
+		server.send(probe->code, probe->contentType, probe->body);
+
+		std::lock_guard<std::mutex> lock(stationsMutex);
+		++stats[static_cast<size_t>(probe->family)].probes;
+		if (Station* station = findStation(static_cast<uint32_t>(server.client().remoteIP()))) {
+			if (station->family == Family::OTHER) station->family = probe->family;
+		}
+		return true;
+	}
+
+	// Private
+	const CaptivePortal::Probe* CaptivePortal::find(const String& uri) {
+		// Every path is short and differs early, so this costs a few character compares per request
+		for (size_t i = 0; i < NUM_PROBES; ++i) {
+			if (uri.equals(PROBES[i].path)) return &PROBES[i];
+		}
+		return nullptr;
+	}
+
+	void CaptivePortal::noteJoined(const uint32_t ip) {
+		std::lock_guard<std::mutex> lock(stationsMutex);
+		Station* station = findStation(ip);
+		if (!station) {
+			// Take a free entry, or the oldest one - DHCP hands out a small pool, so stale entries are replaced quickly
+			const uint32_t now = millis();
+			for (Station& candidate : stations) {
+				if (candidate.ip == 0) {
+					station = &candidate;
+					break;
+				}
+				if (!station || (now - candidate.joinedMs) > (now - station->joinedMs)) station = &candidate;
+			}
+		}
+		*station = Station{ip, static_cast<uint32_t>(millis()), Family::OTHER, false};
+	}
+
+	CaptivePortal::Station* CaptivePortal::findStation(const uint32_t ip) {
+		for (Station& station : stations) {
+			if (station.ip != 0 && station.ip == ip) return &station;
+		}
+		return nullptr;
+	}
+}
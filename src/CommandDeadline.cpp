@@ -0,0 +1,62 @@
+#include "CommandDeadline.h"
+
+#include <PalookaLog/Log.h>
+#include <Preferences.h>
+
+namespace Robot {
+	void CommandDeadline::begin() {
+		Preferences prefs;
+		prefs.begin(PREFS_NAMESPACE, true); // read-only
+		const uint32_t storedMaxAge = prefs.getUInt(PREFS_MAX_AGE, DEFAULT_MAX_AGE_MS);
+		const uint32_t stored = prefs.getUInt(PREFS_SILENCE_STOP, DEFAULT_SILENCE_STOP_MS);
+		prefs.end();
+
+		maxAgeMs = (storedMaxAge == 0 || storedMaxAge >= MIN_MAX_AGE_MS) ? storedMaxAge : DEFAULT_MAX_AGE_MS;
+		silenceStopMs = (stored == 0 || stored >= MIN_SILENCE_STOP_MS) ? stored : DEFAULT_SILENCE_STOP_MS;
+	}
+
+	bool CommandDeadline::isFresh(const uint32_t receivedMs) {
+		if (maxAgeMs == 0 || (millis() - receivedMs) <= maxAgeMs) return true;
+
+		++expired;
+		return false;
+	}
+
+	void CommandDeadline::update(const bool isMacroRunning) {
+		if (silenceStopMs == 0 || isMacroRunning) return;
+		if (robot.getLeftWheelVelocity() == 0 && robot.getRightWheelVelocity() == 0) return;
+		if ((millis() - lastDriveInputMs) < silenceStopMs) return;
+
+		robot.stopMoving();
+		++silenceStops;
+		LOG_INFO("No control input - wheels stopped");
+	}
+
+	bool CommandDeadline::setMaxAge(const uint32_t newMaxAgeMs) {
+		if (newMaxAgeMs != 0 && newMaxAgeMs < MIN_MAX_AGE_MS) return false;
+
+		maxAgeMs = newMaxAgeMs;
+
+		Preferences prefs;
+		prefs.begin(PREFS_NAMESPACE, false);
+		prefs.putUInt(PREFS_MAX_AGE, newMaxAgeMs);
+		prefs.end();
+		return true;
+	}
+
+	bool CommandDeadline::setSilenceStop(const uint32_t newSilenceStopMs) {
+		if (newSilenceStopMs != 0 && newSilenceStopMs < MIN_SILENCE_STOP_MS) return false;
+
+		silenceStopMs = newSilenceStopMs;
+
+		Preferences prefs;
+		prefs.begin(PREFS_NAMESPACE, false);
+		prefs.putUInt(PREFS_SILENCE_STOP, newSilenceStopMs);
+		prefs.end();
+		return true;
+	}
+
+	CommandDeadline::Report CommandDeadline::getReport() const {
+		return Report{maxAgeMs, silenceStopMs, expired, silenceStops};
+	}
+}
@@ -0,0 +1,69 @@
+#include "FrequencyGovernor.h"
+
+#include <esp_timer.h>
+#include <PalookaTrace/Trace.h>
+#include <algorithm>
+
+namespace Robot {
+	void FrequencyGovernor::begin() {
+		fullMhz = currentMhz = getCpuFrequencyMhz();
+		lastActivityMs = currentSinceMs = millis();
+	}
+
+	void FrequencyGovernor::notifyActivity() {
+		lastActivityMs = millis();
+		if (currentMhz == fullMhz) return;
+
+		const int64_t startUs = esp_timer_get_time();
+		setFrequency(fullMhz);
+		lastRampUpUs = static_cast<uint32_t>(esp_timer_get_time() - startUs);
+		maxRampUpUs = std::max(maxRampUpUs, lastRampUpUs);
+		++rampUps;
+	}
+
+	void FrequencyGovernor::update() {
+		if (currentMhz == LOW_CPU_MHZ) return;
+		if ((millis() - lastActivityMs) >= DEFAULT_SLOWDOWN_MS) slowDown();
+	}
+
+	void FrequencyGovernor::slowDown() {
+		if (currentMhz != LOW_CPU_MHZ) setFrequency(LOW_CPU_MHZ);
+	}
+
+	FrequencyGovernor::Report FrequencyGovernor::getReport() const {
+		Report report{currentMhz, {}, rampUps, lastRampUpUs, maxRampUpUs};
+		std::copy(std::begin(timeAt), std::end(timeAt), report.timeAt);
+
+		// Include the time at the current frequency so far
+		const uint32_t sinceMs = millis() - currentSinceMs;
+		for (TimeAt& entry : report.timeAt) {
+			if (entry.mhz == currentMhz || entry.mhz == 0) {
+				entry.mhz = currentMhz;
+				entry.ms += sinceMs;
+				break;
+			}
+		}
+		return report;
+	}
+
+	// Private
+	void FrequencyGovernor::setFrequency(const uint32_t mhz) {
+		account(millis());
+
+		TRACE_SYNC(); // Trace timestamps need a sync on each side of a clock change
+		setCpuFrequencyMhz(mhz);
+		TRACE_SYNC();
+		currentMhz = getCpuFrequencyMhz();
+	}
+
+	void FrequencyGovernor::account(const uint32_t nowMs) {
+		for (TimeAt& entry : timeAt) {
+			if (entry.mhz == currentMhz || entry.mhz == 0) {
+				entry.mhz = currentMhz;
+				entry.ms += nowMs - currentSinceMs;
+				break;
+			}
+		}
+		currentSinceMs = nowMs;
+	}
+}
@@ -0,0 +1,109 @@
+#include "MacroEngine.h"
+
+#include <esp_timer.h>
+#include <PalookaTrace/Trace.h>
+
+namespace Robot {
+	bool MacroEngine::define(const char* name, const MacroStep* steps, size_t numSteps) {
+		if (!name || !steps || numSteps == 0 || numSteps > MAX_STEPS) return false;
+		const size_t nameLength = strlen(name);
+		if (nameLength == 0 || nameLength >= MAX_NAME_LENGTH) return false;
+
+		std::lock_guard<std::mutex> lock(macrosMutex);
+		Macro* slot = find(name);
+		if (!slot) slot = find(""); // Empty name marks a free slot
+		if (!slot) return false;
+
+		strlcpy(slot->name, name, sizeof(slot->name));
+		memcpy(slot->steps, steps, numSteps * sizeof(MacroStep));
+		slot->numSteps = numSteps;
+		return true;
+	}
+
+	bool MacroEngine::remove(const char* name) {
+		if (!name || !name[0]) return false;
+
+		std::lock_guard<std::mutex> lock(macrosMutex);
+		Macro* macro = find(name);
+		if (!macro) return false;
+
+		*macro = Macro{};
+		return true;
+	}
+
+	bool MacroEngine::start(const char* name) {
+		if (!name || !name[0]) return false;
+
+		{
+			std::lock_guard<std::mutex> lock(macrosMutex);
+			Macro* macro = find(name);
+			if (!macro) return false;
+			active = *macro;
+		}
+
+		boost.request(false); // Not carried over from a macro this one replaces
+		running = true;
+		nextStep = 0;
+		nextStepDueUs = esp_timer_get_time();
+		update(); // The first step shouldn't wait for the next loop
+		return true;
+	}
+
+	void MacroEngine::abort() {
+		if (!running) return;
+
+		running = false;
+		robot.stopMoving();
+		boost.request(false);
+	}
+
+	void MacroEngine::update() {
+		if (!running) return;
+
+		const int64_t now = esp_timer_get_time();
+		while (running && now >= nextStepDueUs) {
+			if (nextStep >= active.numSteps) {
+				// The last step's duration has elapsed
+				running = false;
+				robot.stopMoving();
+				boost.request(false);
+				return;
+			}
+
+			const MacroStep& step = active.steps[nextStep++];
+			TRACE_INSTANT(ROBOT_MACRO_STEP);
+			applyStep(step);
+			// Schedule from the previous due time, not from now, so lateness doesn't accumulate
+			nextStepDueUs += static_cast<int64_t>(step.durationMs) * 1000;
+		}
+	}
+
+	uint32_t MacroEngine::msUntilNextStep() const {
+		if (!running) return UINT32_MAX;
+
+		const int64_t remainingUs = nextStepDueUs - esp_timer_get_time();
+		return remainingUs > 0 ? static_cast<uint32_t>(remainingUs / 1000) : 0;
+	}
+
+	// Private
+	MacroEngine::Macro* MacroEngine::find(const char* name) {
+		for (Macro& macro : macros) {
+			if (strncmp(macro.name, name, MAX_NAME_LENGTH) == 0) return &macro;
+		}
+		return nullptr;
+	}
+
+	void MacroEngine::applyStep(const MacroStep& step) {
+		switch (step.type) {
+			case MacroStep::Type::MOVE:
+				robot.move(step.x, step.y);
+				break;
+			case MacroStep::Type::FLIPPER:
+				robot.moveFlipper(step.angle);
+				break;
+			case MacroStep::Type::BOOST:
+				boost.request(step.boost);
+				break;
+		}
+	}
+}
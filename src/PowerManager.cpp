@@ -0,0 +1,88 @@
+#include "PowerManager.h"
+
+#include <PalookaLog/Log.h>
+#include <Preferences.h>
+#include <esp_timer.h>
+#include <algorithm>
+
+namespace Robot {
+	void PowerManager::begin() {
+		Preferences prefs;
+		prefs.begin(PREFS_NAMESPACE, true); // read-only
+		const uint32_t stored = prefs.getUInt(PREFS_IDLE_TIMEOUT, DEFAULT_IDLE_TIMEOUT_MS);
+		prefs.end();
+
+		idleTimeoutMs = (stored == 0 || stored >= MIN_IDLE_TIMEOUT_MS) ? stored : DEFAULT_IDLE_TIMEOUT_MS;
+		governor.begin();
+		lastActivityMs = millis();
+	}
+
+	void PowerManager::notifyActivity() {
+		lastActivityMs = millis();
+		if (isIdle) {
+			exitIdle();
+			return;
+		}
+		governor.notifyActivity(); // First, so the command runs at full speed
+	}
+
+	void PowerManager::update() {
+		// Moving wheels keep the clock up even between commands
+		if (robot.getLeftWheelVelocity() != 0 || robot.getRightWheelVelocity() != 0) governor.notifyActivity();
+		governor.update();
+
+		if (isIdle || idleTimeoutMs == 0) return;
+		if ((millis() - lastActivityMs) >= idleTimeoutMs) enterIdle();
+	}
+
+	bool PowerManager::setIdleTimeout(uint32_t timeoutMs) {
+		if (timeoutMs != 0 && timeoutMs < MIN_IDLE_TIMEOUT_MS) return false;
+
+		idleTimeoutMs = timeoutMs;
+
+		Preferences prefs;
+		prefs.begin(PREFS_NAMESPACE, false);
+		prefs.putUInt(PREFS_IDLE_TIMEOUT, timeoutMs);
+		prefs.end();
+		return true;
+	}
+
+	PowerManager::Report PowerManager::getReport() const {
+		constexpr float savingMa = EST_DRIVER_SAVING_MA + EST_SERVO_SAVING_MA;
+		const uint32_t idleMs = totalIdleMs + (isIdle ? (millis() - idleSinceMs) : 0);
+
+		return Report{
+			isIdle,
+			idleTimeoutMs,
+			lastWakeLatencyUs,
+			maxWakeLatencyUs,
+			wakeCount,
+			idleMs,
+			savingMa,
+			savingMa * (idleMs / 3600000.0f)
+		};
+	}
+
+	// Private
+	void PowerManager::enterIdle() {
+		robot.sleepActuators();
+		governor.slowDown(); // Usually already slowed down by now
+
+		isIdle = true;
+		idleSinceMs = millis();
+		LOG_INFO("[PowerManager] Idle - motor driver asleep, servo released, CPU slowed.");
+	}
+
+	void PowerManager::exitIdle() {
+		const int64_t startUs = esp_timer_get_time();
+		governor.notifyActivity(); // First so the rest of the wake-up runs at full speed
+		robot.wakeActuators();
+		lastWakeLatencyUs = static_cast<uint32_t>(esp_timer_get_time() - startUs);
+
+		isIdle = false;
+		totalIdleMs += millis() - idleSinceMs;
+		maxWakeLatencyUs = std::max(maxWakeLatencyUs, lastWakeLatencyUs);
+		++wakeCount;
+		LOG_INFO("[PowerManager] Woke in %lu us.", static_cast<unsigned long>(lastWakeLatencyUs));
+	}
+}
@@ -0,0 +1,82 @@
+#include "RobotBeacon.h"
+
+#include <ArduinoJson.h>
+#include <algorithm>
+
+namespace PalookaNetwork {
+	bool RobotBeacon::begin(const String& name, const uint16_t webSocketPort, const uint16_t udpControlPort) {
+		StaticJsonDocument<128> doc;
+		doc["palooka"] = 1;
+		doc["name"] = name;
+		doc["ws"] = webSocketPort;
+		doc["udp"] = udpControlPort;
+		payload.clear();
+		serializeJson(doc, payload);
+
+		running = udp.begin(PORT) == 1;
+		return running;
+	}
+
+	void RobotBeacon::poll() {
+		if (!running) return;
+
+		receive();
+
+		const uint32_t now = millis();
+		expire(now);
+		if (now - lastSentMs < INTERVAL_MS) return;
+		lastSentMs = now;
+
+		udp.beginPacket(WiFi.broadcastIP(), PORT);
+		udp.print(payload);
+		udp.endPacket();
+	}
+
+	size_t RobotBeacon::getRobots(Robot* out, const size_t maxRobots) const {
+		const size_t count = std::min(numRobots, maxRobots);
+		for (size_t i = 0; i < count; ++i) out[i] = robots[i];
+		return count;
+	}
+
+	// Private
+	void RobotBeacon::receive() {
+		char buffer[160];
+		for (int size = udp.parsePacket(); size > 0; size = udp.parsePacket()) {
+			const int length = udp.read(buffer, sizeof(buffer) - 1);
+			const IPAddress sender = udp.remoteIP();
+			if (length <= 0 || sender == WiFi.localIP()) continue; // Broadcasts can loop back to us
+
+			StaticJsonDocument<128> doc;
+			if (deserializeJson(doc, buffer, length) || doc["palooka"] != 1) continue;
+
+			record(sender, doc["name"] | "Palooka", doc["ws"] | 81, doc["udp"] | 0);
+		}
+	}
+
+	void RobotBeacon::record(const IPAddress& ip, const char* name, const uint16_t webSocketPort, const uint16_t udpControlPort) {
+		Robot* entry = nullptr;
+		for (size_t i = 0; i < numRobots; ++i) {
+			if (robots[i].ip == ip) { entry = &robots[i]; break; }
+		}
+		if (!entry) {
+			if (numRobots >= MAX_ROBOTS) return; // Full - newcomers appear once someone expires
+			entry = &robots[numRobots++];
+		}
+
+		entry->ip = ip;
+		strlcpy(entry->name, name, sizeof(entry->name));
+		entry->webSocketPort = webSocketPort;
+		entry->udpControlPort = udpControlPort;
+		entry->lastSeenMs = millis();
+	}
+
+	void RobotBeacon::expire(const uint32_t nowMs) {
+		for (size_t i = 0; i < numRobots; ) {
+			if (nowMs - robots[i].lastSeenMs > EXPIRY_MS) {
+				robots[i] = robots[--numRobots]; // Order doesn't matter
+				continue;
+			}
+			++i;
+		}
+	}
+}
@@ -1,19 +1,24 @@
 #include "RobotTaskManager.h"
 
+#include <PalookaLog/Log.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
 namespace Robot {
 	bool RobotTaskManager::requestBatteryCalibration(TickType_t timeout) {
 		uint32_t reply{0};
 		TaskHandle_t caller = xTaskGetCurrentTaskHandle();
 		if (!caller || !robotTaskHandle) return false;
 
+		// =========================== RACE CONDITION ===========================
+		// There's one slot for the caller, so if two tasks call this at the same time the second overwrites
+		// the first, which then times out. Only call this from a System::JobManager job - jobs run one at a
+		// time, so calls never overlap. The handle goes in calibrationCaller rather than the notification
+		// value, which can't hold a pointer on the host.
+		calibrationCaller.store(caller);
 		return (
-				// =========================== RACE CONDITION ===========================
-				// The line below uses a single task notification to send the caller handle.
-				// If multiple tasks call this function at the same time, the second caller
-				// may overwrite the notification, causing the first caller to potentially
-				// time out. For this application, we accept this limitation since
-				// battery calibration is low-priority and exact return value isn't critical.
-				xTaskNotify(robotTaskHandle, (uint32_t)caller, eSetValueWithOverwrite)
+				xTaskNotify(robotTaskHandle, 1, eSetValueWithOverwrite)
 				&&
 				xTaskNotifyWait(0, 0, &reply, timeout) // Wait for reply from Robot task
 				&&
@@ -22,7 +27,11 @@ namespace Robot {
 	}
 
 	void RobotTaskManager::begin() {
+		blackBox.begin(); // First, so the previous boot's recording is saved before anything else runs
 		robot.begin();
+		power.begin();
+		deadline.begin();
+		boost.begin();
 	}
 
 	void RobotTaskManager::RobotTask(void* pvParameters) {
@@ -51,8 +60,10 @@ namespace Robot {
 	{
 		static const unsigned long batteryUpdateInterval = 5000; // 5 seconds
 		static unsigned long lastBatteryUpdate = 0; // Last battery update time
-		static const unsigned long ledToggleInterval = 1000; // 1 second
-		static unsigned long lastLedToggle = 0; // Last time LED was toggled
+#ifdef PALOOKA_TRACE
+		static const unsigned long traceSyncInterval = 1000; // 1 second
+		static unsigned long lastTraceSync = 0;
+#endif
 		while(true)
 		{
 			unsigned long currentMillis = millis();
@@ -61,19 +72,36 @@ namespace Robot {
 				sendBatteryUpdate();
 				lastBatteryUpdate = currentMillis;
 			}
-			if((currentMillis - lastLedToggle) >= ledToggleInterval)
+#ifdef PALOOKA_TRACE
+			if((currentMillis - lastTraceSync) >= traceSyncInterval)
 			{
-				robot.toggleLed();
-				lastLedToggle = currentMillis;
+				TRACE_SYNC(); // Keeps trace timestamps accurate - see Trace::sync()
+				lastTraceSync = currentMillis;
 			}
-
-			handleWebsocketCommands(); // Non-blocking
+#endif
+
+			// Wait for a command with a 10ms timeout, or less if a macro step or black box sample is due sooner
+			const uint32_t waitMs = std::min<uint32_t>({10, macros.msUntilNextStep(), blackBox.msUntilNextSample()});
+			handleWebsocketCommands(pdMS_TO_TICKS(waitMs));
+			macros.update();
+			robot.updateWheels();
+
+			robot.updateBatteryEstimate();
+			applyBoost();
+			robot.updateBoost();
+			if(macros.isRunning()) { power.notifyActivity(); }
+			power.update();
+			deadline.update(macros.isRunning());
+			blackBox.update(macros.isRunning());
 
 			// Calibration Request checks
-			uint32_t callerHandle{0};
-			if (xTaskNotifyWait(0, 0, &callerHandle, 0) == pdTRUE) {
+			uint32_t request{0};
+			if (xTaskNotifyWait(0, 0, &request, 0) == pdTRUE) {
+				TRACE_SCOPE(ROBOT_CALIBRATION);
 				bool result{robot.calibrateBattery()};
-				xTaskNotify((TaskHandle_t)callerHandle, result, eSetValueWithOverwrite);
+				if (TaskHandle_t caller = calibrationCaller.exchange(nullptr)) {
+					xTaskNotify(caller, result, eSetValueWithOverwrite);
+				}
 			}
 
 			// Minor yield for other tasks to execute
@@ -81,39 +109,60 @@ namespace Robot {
 		}
 	}
 
-	void RobotTaskManager::handleWebsocketCommands()
+	void RobotTaskManager::handleWebsocketCommands(const TickType_t timeout)
 	{
 		PalookaNetwork::CommandData cmdData;
-		// Wait for a command with a 10ms timeout
-		if(xQueueReceive(websockQueue, &cmdData, pdMS_TO_TICKS(10)) != pdPASS) { return; }
+		if(xQueueReceive(websockQueue, &cmdData, timeout) != pdPASS) { return; }
+		TRACE_SCOPE(ROBOT_COMMAND);
+		blackBox.noteCommand();
+
+		// A stop is always applied, however late it is
+		if(!cmdData.isStop() && !deadline.isFresh(cmdData.receivedMs)) { return; }
+
+		power.notifyActivity(); // Wakes the actuators before the command is applied
+
+		// Live stick input always takes over from a running macro
+		if(cmdData.hasSlider || cmdData.hasJoystick) { macros.abort(); }
 
 		// Process slider control data
 		if(cmdData.hasSlider)
 		{
 			char robotLimb = cmdData.sliderName[0];
-			Serial.print("Limb: ");
-			Serial.print(robotLimb);
-			Serial.print(", Value: ");
-			Serial.println(cmdData.value);
+			LOG_DEBUG("Limb: %c, Value: %d", robotLimb, cmdData.value);
+			const bool isWheel = robotLimb != 'F' && robotLimb != 'f';
+			if(isWheel && std::abs(cmdData.value) >= FULL_STICK * 255) { boost.noteDemand(millis()); }
 
 			handleRobotSliderCommand(robotLimb, cmdData.value);
+			++appliedCommands;
+			if(isWheel) { deadline.noteDriveInput(cmdData.receivedMs); }
 		}
 		// Process joystick control data
 		else if(cmdData.hasJoystick)
 		{
-			Serial.print("Joystick X: ");
-			Serial.print(cmdData.x);
-			Serial.print(", Y: ");
-			Serial.println(cmdData.y);
+			LOG_DEBUG("Joystick X: %.2f, Y: %.2f", cmdData.x, cmdData.y);
+			if(std::max(std::fabs(cmdData.x), std::fabs(cmdData.y)) >= FULL_STICK) { boost.noteDemand(millis()); }
 
 			robot.move(cmdData.x, cmdData.y);
+			++appliedCommands;
+			deadline.noteDriveInput(cmdData.receivedMs);
 		}
 		// Process flip command
-		else if(cmdData.flip) { robot.flip(); }
-		else if(cmdData.toggleBoost) { robot.toggleBoost(); }
+		else if(cmdData.flip)
+		{
+			boost.noteDemand(millis());
+			applyBoost(); // Before the arm starts moving
+			robot.flip();
+		}
+		else if(cmdData.runMacro)
+		{
+			if(!macros.start(cmdData.macroName))
+			{
+				LOG_WARN("Unknown macro: %s", cmdData.macroName);
+			}
+		}
 		else
 		{
-			Serial.println("Unknown command structure.");
+			LOG_WARN("Unknown command structure.");
 		}
 	}
 
@@ -131,14 +180,24 @@ namespace Robot {
 				robot.moveFlipper(value);
 				break;
 			default:
-				Serial.println("Unknown robot limb JSON supplied.");
+				LOG_WARN("Unknown robot limb JSON supplied.");
 				break;
 		}
 	}
 
+	void RobotTaskManager::applyBoost()
+	{
+		const bool wanted = boost.update(millis());
+		if(wanted != robot.isBoostEnabled()) { robot.setBoostMode(wanted); }
+	}
+
 	void RobotTaskManager::sendBatteryUpdate()
 	{
+		TRACE_SCOPE(ROBOT_BATTERY_UPDATE);
 		int batteryLevel = robot.getBatteryPercentage();
+		lastBatteryPercent = batteryLevel;
+		boost.noteBatteryPercent(batteryLevel);
+		robot.getStatusLed().setCondition(PalookaBot::StatusLed::Condition::LOW_BATTERY, batteryLevel <= LOW_BATTERY_PERCENT);
 		StaticJsonDocument<100> batteryDoc;
 		batteryDoc["battery"] = batteryLevel;
 		String batteryJson;
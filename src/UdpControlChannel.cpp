@@ -0,0 +1,46 @@
+#include "UdpControlChannel.h"
+
+#include <esp_system.h>
+
+namespace PalookaNetwork {
+	bool UdpControlChannel::begin() {
+		return udp.begin(PORT) == 1;
+	}
+
+	uint16_t UdpControlChannel::openSession(const uint8_t clientNum) {
+		do {
+			sessionToken = static_cast<uint16_t>(esp_random());
+		} while (sessionToken == 0);
+
+		sessionClient = clientNum;
+		sessionOpen = true;
+		sequenceFilter.reset();
+		return sessionToken;
+	}
+
+	void UdpControlChannel::closeSession(const uint8_t clientNum) {
+		if (sessionOpen && clientNum == sessionClient) sessionOpen = false;
+	}
+
+	bool UdpControlChannel::poll(ControlFrame::Frame& newest) {
+		uint8_t buffer[ControlFrame::SIZE + 1]; // One spare byte so oversized datagrams are caught
+		bool hasNewest{false};
+
+		for (int size = udp.parsePacket(); size > 0; size = udp.parsePacket()) {
+			const int length = udp.read(buffer, sizeof(buffer));
+
+			ControlFrame::Frame frame;
+			if (!sessionOpen || length <= 0 || !ControlFrame::decode(buffer, length, frame)
+					|| frame.token != sessionToken || !sequenceFilter.accept(frame.sequence)) {
+				++dropped;
+				continue;
+			}
+
+			if (hasNewest) ++dropped; // Superseded before the robot ever saw it
+			newest = frame;
+			hasNewest = true;
+		}
+
+		return hasNewest;
+	}
+}
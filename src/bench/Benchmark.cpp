@@ -0,0 +1,75 @@
+#include "bench/Benchmark.h"
+
+#include <algorithm>
+#include <memory>
+#include <new>
+
+namespace Bench {
+	namespace {
+		void emptyBenchmark() {}
+
+		inline uint32_t cyclesSince(const uint32_t start) {
+			return ESP.getCycleCount() - start; // Wraps correctly for anything under ~17 s at 240 MHz
+		}
+	}
+
+	bool Registry::add(const Benchmark& benchmark) {
+		if (count >= MAX_BENCHMARKS || !benchmark.run || benchmark.iterations == 0) return false;
+		benchmarks[count++] = benchmark;
+		return true;
+	}
+
+	void Registry::runAll(Print& out) {
+		out.printf("# Running %u benchmarks on core %d at %lu MHz\n",
+				(unsigned)count, xPortGetCoreID(), (unsigned long)getCpuFrequencyMhz());
+
+		// The cost of reading the counter and making the call, removed from every result
+		Result overhead{};
+		if (!measure(Benchmark{"overhead", emptyBenchmark, 1000, nullptr}, 0, overhead)) {
+			out.println("# Not enough memory to measure the timing overhead");
+			return;
+		}
+		out.printf("# Timing overhead: %lu cycles\n", (unsigned long)overhead.min);
+
+		for (size_t i = 0; i < count; ++i) {
+			const Benchmark& benchmark = benchmarks[i];
+			if (benchmark.setup) benchmark.setup();
+
+			Result result{};
+			if (!measure(benchmark, overhead.min, result)) {
+				out.printf("# %s: not enough memory for %lu samples\n", benchmark.name, (unsigned long)benchmark.iterations);
+				continue;
+			}
+
+			out.printf("{\"bench\":\"%s\",\"iterations\":%lu,\"cpuMhz\":%lu,\"min\":%lu,\"median\":%lu,\"p99\":%lu,\"max\":%lu}\n",
+					benchmark.name, (unsigned long)benchmark.iterations, (unsigned long)getCpuFrequencyMhz(),
+					(unsigned long)result.min, (unsigned long)result.median, (unsigned long)result.p99, (unsigned long)result.max);
+		}
+		out.println("# Done");
+	}
+
+	// Private
+	bool Registry::measure(const Benchmark& benchmark, const uint32_t overheadCycles, Result& result) {
+		std::unique_ptr<uint32_t[]> samples(new (std::nothrow) uint32_t[benchmark.iterations]);
+		if (!samples) return false;
+
+		const uint32_t warmup = std::min(WARMUP_ITERATIONS, benchmark.iterations); // Slow benchmarks use few iterations
+		for (uint32_t i = 0; i < warmup; ++i) benchmark.run();
+
+		for (uint32_t i = 0; i < benchmark.iterations; ++i) {
+			const uint32_t start = ESP.getCycleCount();
+			benchmark.run();
+			const uint32_t cycles = cyclesSince(start);
+			samples[i] = cycles > overheadCycles ? cycles - overheadCycles : 0;
+		}
+
+		uint32_t* const first = samples.get();
+		uint32_t* const last = first + benchmark.iterations;
+		std::sort(first, last);
+		result.min = first[0];
+		result.median = first[benchmark.iterations / 2];
+		result.p99 = first[std::min<uint32_t>(benchmark.iterations - 1, (benchmark.iterations * 99) / 100)];
+		result.max = last[-1];
+		return true;
+	}
+}
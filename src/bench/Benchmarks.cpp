@@ -0,0 +1,132 @@
+// Benchmarks for the robot's hot paths. Each one mirrors what the firmware does on a single command or update.
+// Actuators are put to sleep first, so the motors and servo never move while benchmarks run.
+#include <ArduinoJson.h>
+#include <cstring>
+
+#include <PalookaBot/FlipperBot.h>
+#include <PalookaTrace/Trace.h>
+#include "bench/Benchmark.h"
+
+namespace {
+	using PalookaBot::Board;
+
+	PalookaBot::FlipperBot* robot{nullptr};
+
+	void setupRobot() {
+		if (robot) return;
+		robot = &PalookaBot::FlipperBot::getInstance();
+		robot->begin();
+		robot->sleepActuators(); // Motor driver asleep - PWM still runs but the wheels don't turn
+	}
+
+	// ========== WebSocket messages (AccessPoint::handleWebSocketMessage) ==========
+	// The real payload buffer is writable, so ArduinoJson parses it in place. Copy it fresh for each parse.
+	const char JOYSTICK_MESSAGE[] = "{\"x\":0.53,\"y\":-0.21}";
+	const char SLIDER_MESSAGE[] = "{\"sliderName\":\"L\",\"value\":-180}";
+	char messageBuffer[64];
+
+	void parseMessage(const char* message, size_t length) {
+		memcpy(messageBuffer, message, length);
+		StaticJsonDocument<200> doc; // Same document as handleWebSocketMessage
+		const DeserializationError error = deserializeJson(doc, reinterpret_cast<uint8_t*>(messageBuffer), length);
+		Bench::doNotOptimize(error);
+		Bench::doNotOptimize(doc);
+	}
+
+	void parseJoystickMessage() { parseMessage(JOYSTICK_MESSAGE, sizeof(JOYSTICK_MESSAGE) - 1); }
+	void parseSliderMessage() { parseMessage(SLIDER_MESSAGE, sizeof(SLIDER_MESSAGE) - 1); }
+
+	// ========== Battery update (RobotTaskManager::sendBatteryUpdate) ==========
+	void serializeBatteryUpdate() {
+		StaticJsonDocument<100> batteryDoc;
+		batteryDoc["battery"] = 87;
+		String batteryJson;
+		serializeJson(batteryDoc, batteryJson);
+		Bench::doNotOptimize(batteryJson);
+	}
+
+	// ========== Driving ==========
+	// Cycles through stick positions so every direction and branch is exercised
+	const float STICK_POSITIONS[][2] = {
+		{0.0f, 1.0f}, {0.7f, 0.7f}, {1.0f, 0.0f}, {0.4f, -0.9f}, {-0.3f, -0.3f}, {-1.0f, 0.2f}, {0.0f, 0.0f}, {-0.6f, 0.8f},
+	};
+	constexpr size_t NUM_STICK_POSITIONS = sizeof(STICK_POSITIONS) / sizeof(STICK_POSITIONS[0]);
+	size_t stickIndex{0};
+
+	void moveRobot() {
+		const float* position = STICK_POSITIONS[stickIndex++ % NUM_STICK_POSITIONS];
+		robot->move(position[0], position[1]);
+	}
+
+	const PalookaBot::Motor<Board::RightWheel> motor;
+	const short VELOCITIES[] = {255, -255, 128, -64, 0, 200, -1, 37};
+	constexpr size_t NUM_VELOCITIES = sizeof(VELOCITIES) / sizeof(VELOCITIES[0]);
+	size_t velocityIndex{0};
+
+	void setupMotor() {
+		setupRobot();
+		motor.begin(); // Same pins and channel as the robot's right wheel
+	}
+
+	void rotateMotor() { motor.rotate(VELOCITIES[velocityIndex++ % NUM_VELOCITIES]); }
+
+	// Motor::rotate as it was before pins were resolved at compile time: a digitalWrite for the direction
+	// and an analogWrite, which looks the pin's channel up on every call. analogWrite takes the right wheel's
+	// pins off the Motor's LEDC channels, so this has to run after the Motor benchmarks.
+	void legacyRotateMotor() {
+		short velocity = VELOCITIES[velocityIndex++ % NUM_VELOCITIES];
+		if (velocity == 0) {
+			digitalWrite(Board::RightWheel::DIRECTION_PIN, LOW);
+			analogWrite(Board::RightWheel::PWM_PIN, 0);
+			return;
+		}
+
+		velocity = constrain(velocity, -255, 255);
+		const bool isForwardDirection = velocity > 0;
+		if (!isForwardDirection) { velocity = 255 - abs(velocity); }
+		digitalWrite(Board::RightWheel::DIRECTION_PIN, isForwardDirection ? LOW : HIGH);
+		analogWrite(Board::RightWheel::PWM_PIN, velocity);
+	}
+
+	// ========== Battery ==========
+	void readBatteryPercent() { Bench::doNotOptimize(robot->getBatteryPercentage()); }
+	void readInstantBatteryMilliVolts() { Bench::doNotOptimize(robot->readInstantBatteryMilliVolts()); }
+
+	// ========== GPIO: Arduino calls vs. compile-time pins ==========
+	// Writing LOW to the driver's sleep pin keeps it asleep, so these are safe to repeat.
+	void legacyDigitalWrite() { digitalWrite(Board::DVR_SLEEP_PIN, LOW); }
+	void gpioPinWrite() { PalookaBot::GpioPin<Board::DVR_SLEEP_PIN>::low(); }
+	void legacyDigitalRead() { Bench::doNotOptimize(digitalRead(Board::DVR_SLEEP_PIN)); }
+	void gpioPinReadOutput() { Bench::doNotOptimize(PalookaBot::GpioPin<Board::DVR_SLEEP_PIN>::readOutput()); }
+
+	// ========== Status LED ==========
+	// Worst case: every call changes the pattern
+	bool isBoostShown{false};
+	void switchStatusLedPattern() {
+		isBoostShown = !isBoostShown;
+		robot->getStatusLed().setCondition(PalookaBot::StatusLed::Condition::BOOST, isBoostShown);
+	}
+
+#ifdef PALOOKA_TRACE
+	// ========== Tracing ==========
+	// Cost of one event - build with PLATFORMIO_BUILD_FLAGS=-DPALOOKA_TRACE pio run -e bench
+	void traceInstant() { TRACE_INSTANT(BOT_MOVE); }
+#endif
+}
+
+PALOOKA_BENCHMARK("deserializeJson.joystick", parseJoystickMessage);
+PALOOKA_BENCHMARK("deserializeJson.slider", parseSliderMessage);
+PALOOKA_BENCHMARK("serializeJson.battery", serializeBatteryUpdate);
+PALOOKA_BENCHMARK("FlipperBot::move", moveRobot, 1000, setupRobot);
+PALOOKA_BENCHMARK("Motor::rotate", rotateMotor, 1000, setupMotor);
+PALOOKA_BENCHMARK("Motor::rotate.analogWrite", legacyRotateMotor, 1000, setupMotor); // Baseline for Motor::rotate
+PALOOKA_BENCHMARK("Battery::readPercent", readBatteryPercent, 1000, setupRobot); // Was ~130 ms before SocEstimator
+PALOOKA_BENCHMARK("Battery::readInstantMilliVolts", readInstantBatteryMilliVolts, 1000, setupRobot);
+PALOOKA_BENCHMARK("digitalWrite", legacyDigitalWrite, 1000, setupRobot);
+PALOOKA_BENCHMARK("GpioPin::low", gpioPinWrite, 1000, setupRobot);
+PALOOKA_BENCHMARK("digitalRead", legacyDigitalRead, 1000, setupRobot);
+PALOOKA_BENCHMARK("GpioPin::readOutput", gpioPinReadOutput, 1000, setupRobot);
+PALOOKA_BENCHMARK("StatusLed::setCondition", switchStatusLedPattern, 1000, setupRobot);
+#ifdef PALOOKA_TRACE
+PALOOKA_BENCHMARK("Trace::instant", traceInstant);
+#endif
@@ -0,0 +1,24 @@
+// Entry point for the bench env (envs/bench.ini), used instead of src/main.cpp.
+// WiFi and the robot task are never started, so nothing else competes for core 1 while benchmarks run.
+#include <Arduino.h>
+
+#include "bench/Benchmark.h"
+
+namespace {
+	void benchTask(void* /* pvParameters */) {
+		Bench::Registry::getInstance().runAll(Serial);
+		vTaskDelete(nullptr);
+	}
+}
+
+void setup() {
+	Serial.begin(115200);
+	delay(2000); // Time to open the serial monitor after a reset
+
+	// Core 1 is where the robot task runs in the real firmware
+	xTaskCreatePinnedToCore(benchTask, "Bench::runAll", 8192, nullptr, 3, nullptr, 1);
+}
+
+void loop() {
+	vTaskDelay(portMAX_DELAY);
+}
@@ -1,5 +1,9 @@
+#include <PalookaLog/Log.h>
+
 #include "AccessPointManager.h"
 #include "RobotTaskManager.h"
+#include "system/InputService.h"
+#include "system/JobManager.h"
 #include "system/ResetService.h"
 
 PalookaNetwork::AccessPointManager& apManager{PalookaNetwork::AccessPointManager::getInstance()};
@@ -7,10 +11,16 @@ Robot::RobotTaskManager& robotManager{Robot::RobotTaskManager::getInstance(&apMa
 
 void setup() {
 	Serial.begin(115200);
+	Log::begin();
+	System::InputService::getInstance().begin();
 	System::ResetService::begin(5, 10000UL, 30000UL); // 10 & 30 seconds respectively
+	System::JobManager::getInstance().begin();
 
 	if (!apManager.begin()) {
 		Serial.println("Palooka Access Point failed in setup()");
+		PalookaBot::StatusLed& statusLed = PalookaBot::FlipperBot::getInstance().getStatusLed();
+		statusLed.begin();
+		statusLed.setCondition(PalookaBot::StatusLed::Condition::ERROR, true);
 		return;
 	}
 
@@ -0,0 +1,146 @@
+#include "sim/DriveModel.h"
+
+#include <PalookaBot/Board.h>
+#include <algorithm>
+#include <cmath>
+
+using PalookaBot::Board;
+
+namespace Sim {
+	namespace {
+		// Left then right. The left motor is mounted mirrored (FlipperBot inverts it), so its own forwards is the
+		// robot's backwards.
+		constexpr float FRAME_SIGNS[2]{-1.0f, 1.0f};
+
+		float sign(const float value) { return (value > 0.0f) - (value < 0.0f); }
+	}
+
+	DriveModel::DriveModel(const float stateOfCharge) : DriveModel(stateOfCharge, Params{}) {}
+
+	DriveModel::DriveModel(const float stateOfCharge, const Params& params) : params(params) {
+		state.stateOfCharge = std::clamp(stateOfCharge, 0.0f, 1.0f);
+		state.batteryV = openCircuitVolts(state.stateOfCharge);
+	}
+
+	void DriveModel::step(Hardware& hardware, const float dtS) {
+		const bool isDriverAwake = hardware.isHigh(Board::DVR_SLEEP_PIN);
+		const bool isServoPowered = hardware.isHigh(Board::EN5V_PIN);
+		state.isBoosted = hardware.pinModes[Board::BOOST_PIN] == OUTPUT && !hardware.isHigh(Board::BOOST_PIN);
+
+		// ========== Wheels ==========
+		const int64_t startUs = hardware.nowUs() - static_cast<int64_t>(dtS * 1e6f);
+		const float subDtS = dtS / SUBSTEPS;
+		float motorBatteryA{0.0f};
+		float averageA[2]{};
+		for (int i = 0; i < SUBSTEPS; ++i) {
+			const int64_t atUs = startUs + static_cast<int64_t>(i * subDtS * 1e6f);
+			motorBatteryA += stepMotor(0, hardware.isOutputHigh(Board::LeftWheel::PWM_PIN, atUs),
+					hardware.isOutputHigh(Board::LeftWheel::DIRECTION_PIN, atUs), isDriverAwake, subDtS);
+			motorBatteryA += stepMotor(1, hardware.isOutputHigh(Board::RightWheel::PWM_PIN, atUs),
+					hardware.isOutputHigh(Board::RightWheel::DIRECTION_PIN, atUs), isDriverAwake, subDtS);
+			averageA[0] += motorCurrentA[0];
+			averageA[1] += motorCurrentA[1];
+		}
+		state.leftMps = motorSpeedMps[0] * FRAME_SIGNS[0];
+		state.rightMps = motorSpeedMps[1] * FRAME_SIGNS[1];
+		state.leftA = averageA[0] / SUBSTEPS * FRAME_SIGNS[0];
+		state.rightA = averageA[1] / SUBSTEPS * FRAME_SIGNS[1];
+
+		// ========== Pose ==========
+		const double speed = (state.leftMps + state.rightMps) / 2.0;
+		const double turnRate = (state.rightMps - state.leftMps) / params.trackWidthM;
+		state.xM += speed * std::cos(state.headingRad) * dtS;
+		state.yM += speed * std::sin(state.headingRad) * dtS;
+		state.headingRad = std::remainder(state.headingRad + turnRate * dtS, 2.0 * M_PI);
+
+		// ========== Flipper ==========
+		const bool isFlipperMoving = std::fabs(state.flipperDeg - state.flipperTargetDeg) > 0.5f;
+		stepFlipper(hardware, dtS, isServoPowered);
+		float servoA{0.0f};
+		if (isServoPowered && isFlipperMoving) servoA = params.servoCurrentA * (state.isBoosted ? params.servoBoostFactor : 1.0f);
+
+		// ========== Battery ==========
+		// The terminal voltage the motors saw is from the previous step - 1 ms is far below any time constant here
+		state.batteryCurrentA = params.idleCurrentA + servoA + motorBatteryA / SUBSTEPS;
+		state.stateOfCharge = std::max(0.0f, state.stateOfCharge - state.batteryCurrentA * dtS / (params.batteryCapacityMah * 3.6f));
+		state.batteryV = std::max(0.0f, openCircuitVolts(state.stateOfCharge) - state.batteryCurrentA * params.batteryResistanceOhm);
+		connect(hardware);
+	}
+
+	void DriveModel::connect(Hardware& hardware) const {
+		hardware.adcInputMv[Board::BATTERY_CHANNEL] =
+				state.batteryV * 1000.0f * Board::BATTERY_R_BOT / (Board::BATTERY_R_TOP + Board::BATTERY_R_BOT);
+	}
+
+	float DriveModel::openCircuitVolts(const float stateOfCharge) {
+		// Typical 1S LiPo resting voltage in 5% steps from empty to full
+		static constexpr float VOLTS[]{
+			3.27f, 3.61f, 3.69f, 3.71f, 3.73f, 3.75f, 3.77f, 3.79f, 3.80f, 3.82f, 3.84f,
+			3.85f, 3.87f, 3.91f, 3.95f, 3.98f, 4.02f, 4.08f, 4.11f, 4.15f, 4.20f
+		};
+		constexpr int LAST = sizeof(VOLTS) / sizeof(VOLTS[0]) - 1;
+
+		const float position = std::clamp(stateOfCharge, 0.0f, 1.0f) * LAST;
+		const int index = std::min(static_cast<int>(position), LAST - 1);
+		return VOLTS[index] + (VOLTS[index + 1] - VOLTS[index]) * (position - index);
+	}
+
+	// Private
+	// DRV8833 inputs: IN1 high drives forwards, IN2 high backwards, both high brakes (the winding is shorted), both low
+	// coasts (the bridge lets go and any current left in the winding returns to the battery through the body diodes).
+	// Motor<Pins> drives both as PWM outputs, IN1 on PWM_PIN and IN2 on DIRECTION_PIN.
+	float DriveModel::stepMotor(const int motor, const bool in1, const bool in2, const bool isDriverAwake, const float dtS) {
+		float& currentA = motorCurrentA[motor];
+		float& speed = motorSpeedMps[motor];
+		const bool isCoasting = !isDriverAwake || (!in1 && !in2);
+
+		float terminalV{0.0f};
+		float batteryA{0.0f};
+		if (isCoasting) {
+			terminalV = -sign(currentA) * state.batteryV;
+			batteryA = -std::fabs(currentA);
+		} else if (in1 != in2) {
+			terminalV = in1 ? state.batteryV : -state.batteryV;
+			batteryA = in1 ? currentA : -currentA;
+		}
+
+		const float previousA = currentA;
+		currentA += (terminalV - params.motorResistanceOhm * currentA - params.motorConstant * speed) / params.motorInductanceH * dtS;
+		if (isCoasting && sign(currentA) != sign(previousA)) currentA = 0.0f; // The diodes only conduct one way
+
+		// Rolling resistance can stop the wheel but never push it backwards
+		const float motorForce = params.motorConstant * currentA;
+		const float speedSign = sign(speed);
+		float force = motorForce;
+		if (speedSign != 0.0f) force -= speedSign * params.rollingResistanceN;
+		else if (std::fabs(force) <= params.rollingResistanceN) force = 0.0f;
+		else force -= sign(force) * params.rollingResistanceN;
+
+		const float newSpeed = speed + force / params.wheelMassKg * dtS;
+		const bool hasStopped = speedSign != 0.0f && sign(newSpeed) != speedSign && std::fabs(motorForce) <= params.rollingResistanceN;
+		speed = hasStopped ? 0.0f : newSpeed;
+		return batteryA;
+	}
+
+	void DriveModel::stepFlipper(Hardware& hardware, const float dtS, const bool isPowered) {
+		const Hardware::ServoOutput& servo = hardware.servos[Board::FLIPPER_PIN];
+		if (!servo.isAttached || !isPowered || servo.periodHertz == 0) return; // Limp - the arm stays where it is
+
+		// A pulse only reaches the servo at the start of a frame
+		const int64_t nowUs = hardware.nowUs();
+		const int64_t periodUs = 1000000 / servo.periodHertz;
+		if (nextFrameUs < servo.attachedAtUs) nextFrameUs = servo.attachedAtUs; // Re-attached: frames restart
+		if (nowUs >= nextFrameUs) {
+			latchedPulseUs = servo.pulseUs;
+			nextFrameUs = servo.attachedAtUs + ((nowUs - servo.attachedAtUs) / periodUs + 1) * periodUs;
+		}
+		if (latchedPulseUs == 0) return; // Attached but no pulse yet
+
+		const float fraction = (latchedPulseUs - params.servoMinPulseUs) / (params.servoMaxPulseUs - params.servoMinPulseUs);
+		state.flipperTargetDeg = std::clamp(fraction, 0.0f, 1.0f) * params.servoRangeDeg;
+
+		const float maxMoveDeg = params.servoSlewDegPerS * (state.isBoosted ? params.servoBoostFactor : 1.0f) * dtS;
+		const float errorDeg = state.flipperTargetDeg - state.flipperDeg;
+		state.flipperDeg += std::clamp(errorDeg, -maxMoveDeg, maxMoveDeg);
+	}
+}
@@ -0,0 +1,138 @@
+#include "sim/Hardware.h"
+
+#include <algorithm>
+
+gpio_dev_t GPIO;
+
+namespace Sim {
+	int64_t Hardware::firmwareUs() const {
+		return timeUs;
+	}
+
+	void Hardware::advance(const int64_t us) {
+		const int64_t targetUs = timeUs + std::max<int64_t>(us, 0);
+		fireDueTimers(); // Timers started with a 0 timeout
+
+		while (timeUs < targetUs) {
+			const int64_t nextStepUs = lastStepUs + STEP_US;
+			int64_t nextUs = std::min(targetUs, nextStepUs);
+			{
+				std::lock_guard<std::mutex> lock(timersMutex);
+				for (const esp_timer_handle_t timer : timers) {
+					if (timer->isArmed && timer->dueUs < nextUs) nextUs = std::max(timer->dueUs, timeUs);
+				}
+			}
+
+			timeUs = nextUs;
+			fireDueTimers();
+			if (timeUs >= nextStepUs) {
+				lastStepUs = nextStepUs;
+				if (stepHandler) stepHandler(timeUs);
+			}
+		}
+	}
+
+	bool Hardware::isHigh(const uint8_t pin) const {
+		if (pin >= NUM_PINS) return false;
+		return pin < 32 ? (GPIO.out & (1UL << pin)) : (GPIO.out1.val & (1UL << (pin - 32)));
+	}
+
+	void Hardware::setLevel(const uint8_t pin, const bool isHigh) {
+		if (pin >= NUM_PINS) return;
+		if (pin < 32) {
+			if (isHigh) GPIO.out_w1ts = 1UL << pin;
+			else GPIO.out_w1tc = 1UL << pin;
+		} else {
+			if (isHigh) GPIO.out1_w1ts.val = 1UL << (pin - 32);
+			else GPIO.out1_w1tc.val = 1UL << (pin - 32);
+		}
+	}
+
+	bool Hardware::isOutputHigh(const uint8_t pin, const int64_t atUs) const {
+		for (uint8_t channel = 0; channel < NUM_LEDC_CHANNELS; ++channel) {
+			if (ledc[channel].pin != pin) continue;
+			if (ledc[channel].frequency == 0) return false;
+			const int64_t periodUs = 1000000 / ledc[channel].frequency;
+			return (atUs % periodUs) < ledcDutyFraction(channel) * periodUs;
+		}
+		return isHigh(pin);
+	}
+
+	float Hardware::ledcDutyFraction(const uint8_t channel) const {
+		if (channel >= NUM_LEDC_CHANNELS || ledc[channel].pin < 0 || ledc[channel].resolutionBits == 0) return 0.0f;
+		const float fullScale = static_cast<float>(1UL << ledc[channel].resolutionBits);
+		return std::min(ledc[channel].duty / fullScale, 1.0f);
+	}
+
+	int Hardware::readAdcRaw(const adc1_channel_t channel) {
+		if (channel >= ADC1_CHANNEL_MAX) return 0;
+
+		// Full scale of each attenuation, as listed for the ESP32 in the ADC docs
+		static constexpr float FULL_SCALE_MV[]{950.0f, 1250.0f, 1750.0f, 3100.0f};
+		const float fullScaleMv = FULL_SCALE_MV[adcAtten[channel]];
+
+		noiseState ^= noiseState << 13;
+		noiseState ^= noiseState >> 17;
+		noiseState ^= noiseState << 5;
+		const float noise = ((noiseState & 0xFFFF) / 32767.5f - 1.0f) * adcNoiseLsb;
+
+		const float raw = adcInputMv[channel] / fullScaleMv * 4095.0f + noise;
+		return static_cast<int>(std::clamp(std::lround(raw), 0L, 4095L));
+	}
+
+	esp_timer_handle_t Hardware::createTimer(const esp_timer_cb_t callback, void* const arg) {
+		const esp_timer_handle_t timer = new esp_timer{callback, arg, 0, 0, false};
+		std::lock_guard<std::mutex> lock(timersMutex);
+		timers.push_back(timer);
+		return timer;
+	}
+
+	bool Hardware::startTimer(const esp_timer_handle_t timer, const uint64_t timeoutUs, const uint64_t periodUs) {
+		std::lock_guard<std::mutex> lock(timersMutex);
+		if (timer->isArmed) return false;
+		timer->dueUs = firmwareUs() + timeoutUs;
+		timer->periodUs = periodUs;
+		timer->isArmed = true;
+		return true;
+	}
+
+	bool Hardware::stopTimer(const esp_timer_handle_t timer) {
+		std::lock_guard<std::mutex> lock(timersMutex);
+		if (!timer->isArmed) return false;
+		timer->isArmed = false;
+		return true;
+	}
+
+	bool Hardware::deleteTimer(const esp_timer_handle_t timer) {
+		{
+			std::lock_guard<std::mutex> lock(timersMutex);
+			if (timer->isArmed) return false;
+			timers.erase(std::remove(timers.begin(), timers.end(), timer), timers.end());
+		}
+		delete timer;
+		return true;
+	}
+
+	// Private
+	// Callbacks may start, stop or delete timers, so the list is searched again after each one
+	void Hardware::fireDueTimers() {
+		while (true) {
+			esp_timer_cb_t callback;
+			void* arg;
+			{
+				std::lock_guard<std::mutex> lock(timersMutex);
+				esp_timer_handle_t due{nullptr};
+				for (const esp_timer_handle_t timer : timers) {
+					if (timer->isArmed && timer->dueUs <= timeUs && (!due || timer->dueUs < due->dueUs)) due = timer;
+				}
+				if (!due) return;
+
+				if (due->periodUs > 0) due->dueUs += due->periodUs;
+				else due->isArmed = false;
+				callback = due->callback;
+				arg = due->arg;
+			}
+			callback(arg);
+		}
+	}
+}
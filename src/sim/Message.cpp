@@ -0,0 +1,115 @@
+#include "sim/Message.h"
+
+#include <cctype>
+#include <cstdlib>
+
+namespace Sim {
+	namespace {
+		void skipSpace(const std::string& text, size_t& i) {
+			while (i < text.size() && isspace(static_cast<unsigned char>(text[i]))) ++i;
+		}
+
+		// Reads a string starting at the opening quote. Escapes other than \uXXXX are unescaped.
+		bool readString(const std::string& text, size_t& i, std::string& out) {
+			if (i >= text.size() || text[i] != '"') return false;
+			out.clear();
+			for (++i; i < text.size(); ++i) {
+				char c = text[i];
+				if (c == '"') {
+					++i;
+					return true;
+				}
+				if (c == '\\' && i + 1 < text.size()) {
+					c = text[++i];
+					switch (c) {
+						case 'n': c = '\n'; break;
+						case 't': c = '\t'; break;
+						case 'r': c = '\r'; break;
+						case 'b': c = '\b'; break;
+						case 'f': c = '\f'; break;
+						default: break; // \" \\ \/ and \u (kept as written)
+					}
+				}
+				out += c;
+			}
+			return false;
+		}
+
+		// Reads a number, literal, or nested object/array as raw text
+		bool readRaw(const std::string& text, size_t& i, std::string& out) {
+			const size_t start = i;
+			int depth = 0;
+			std::string ignored;
+			while (i < text.size()) {
+				const char c = text[i];
+				if (c == '"') {
+					if (!readString(text, i, ignored)) return false;
+					continue;
+				}
+				if (c == '{' || c == '[') ++depth;
+				else if (c == '}' || c == ']') {
+					if (depth == 0) break;
+					--depth;
+				} else if (c == ',' && depth == 0) break;
+				++i;
+			}
+			out = text.substr(start, i - start);
+			while (!out.empty() && isspace(static_cast<unsigned char>(out.back()))) out.pop_back();
+			return depth == 0 && !out.empty();
+		}
+	}
+
+	bool Message::parse(const std::string& text) {
+		values.clear();
+		size_t i = 0;
+		skipSpace(text, i);
+		if (i >= text.size() || text[i] != '{') return false;
+		++i;
+
+		skipSpace(text, i);
+		if (i < text.size() && text[i] == '}') return true;
+
+		while (i < text.size()) {
+			std::string key, value;
+			skipSpace(text, i);
+			if (!readString(text, i, key)) return false;
+			skipSpace(text, i);
+			if (i >= text.size() || text[i] != ':') return false;
+			++i;
+			skipSpace(text, i);
+			if (i < text.size() && text[i] == '"') {
+				if (!readString(text, i, value)) return false;
+			} else if (!readRaw(text, i, value)) {
+				return false;
+			}
+			values[key] = value;
+
+			skipSpace(text, i);
+			if (i >= text.size()) return false;
+			if (text[i] == '}') return true;
+			if (text[i] != ',') return false;
+			++i;
+		}
+		return false;
+	}
+
+	double Message::getNumber(const std::string& key, const double fallback) const {
+		const auto it = values.find(key);
+		if (it == values.end()) return fallback;
+		if (it->second == "true") return 1;
+		char* end = nullptr;
+		const double value = strtod(it->second.c_str(), &end);
+		return end == it->second.c_str() ? fallback : value;
+	}
+
+	std::string Message::getString(const std::string& key, const std::string& fallback) const {
+		const auto it = values.find(key);
+		return it == values.end() ? fallback : it->second;
+	}
+
+	bool Message::getBool(const std::string& key) const {
+		const auto it = values.find(key);
+		if (it == values.end() || it->second == "false" || it->second == "null") return false;
+		return it->second == "true" || getNumber(key) != 0;
+	}
+}
@@ -0,0 +1,422 @@
+#include "sim/Simulator.h"
+
+#include <PalookaLog/Log.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+
+#include "sim/Message.h"
+
+namespace Sim {
+	namespace {
+		int64_t wallClockUs() {
+			return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		// Nearest-rank percentile of an unsorted copy
+		float percentile(std::vector<float> values, const float fraction) {
+			if (values.empty()) return 0.0f;
+			std::sort(values.begin(), values.end());
+			const size_t rank = static_cast<size_t>(std::ceil(fraction * values.size()));
+			return values[std::clamp<size_t>(rank, 1, values.size()) - 1];
+		}
+
+		void printSummary(FILE* out, const char* name, const std::vector<float>& values, const char* unit = "ms") {
+			if (values.empty()) {
+				fprintf(out, "%-10s n=0\n", name);
+				return;
+			}
+			fprintf(out, "%-10s n=%-5zu median %7.1f %-3s p95 %7.1f %-3s max %7.1f %s\n", name, values.size(),
+					percentile(values, 0.5f), unit, percentile(values, 0.95f), unit, percentile(values, 1.0f), unit);
+		}
+
+		void writeJsonSummary(FILE* out, const char* name, const std::vector<float>& values) {
+			fprintf(out, "\"%s\":{\"count\":%zu,\"median\":%.2f,\"p95\":%.2f,\"max\":%.2f}",
+					name, values.size(), percentile(values, 0.5f), percentile(values, 0.95f), percentile(values, 1.0f));
+		}
+	}
+
+	Simulator::Simulator(const Options& options)
+		: options(options),
+		hardware(Hardware::getInstance()),
+		robot(PalookaBot::FlipperBot::getInstance()),
+		deadline(robot),
+		model(options.stateOfCharge)
+	{ }
+
+	Simulator::~Simulator() {
+		if (trajectory) fclose(trajectory);
+		if (record) fclose(record);
+	}
+
+	int Simulator::run() {
+		const bool isReplay = !options.replayPath.empty();
+		hardware.setSerialEnabled(!options.isQuiet);
+		if (isReplay && !loadReplay()) return 1;
+
+		if (!options.trajectoryPath.empty()) {
+			trajectory = fopen(options.trajectoryPath.c_str(), "w");
+			if (!trajectory) {
+				fprintf(stderr, "Can't write %s\n", options.trajectoryPath.c_str());
+				return 1;
+			}
+			fprintf(trajectory, "t_ms,x_m,y_m,heading_deg,left_mps,right_mps,left_a,right_a,battery_v,battery_a,soc,"
+					"flipper_deg,boost,left_cmd,right_cmd\n");
+		}
+
+		if (!isReplay) {
+			if (!options.recordPath.empty()) {
+				record = fopen(options.recordPath.c_str(), "w");
+				if (!record) {
+					fprintf(stderr, "Can't write %s\n", options.recordPath.c_str());
+					return 1;
+				}
+			}
+			if (!server.begin(options.webSocketPort)) {
+				fprintf(stderr, "Can't listen on port %u\n", options.webSocketPort);
+				return 1;
+			}
+			server.onMessage([this](uint8_t client, const std::string& text) { onMessage(client, text); });
+			server.onConnection([this](uint8_t client, bool isConnected) { onConnection(client, isConnected); });
+			fprintf(stderr, "Simulator listening on ws://localhost:%u - open the controller with ?wsPort=%u\n",
+					options.webSocketPort, options.webSocketPort);
+		}
+
+		// Before time first moves, as input can already arrive during robot.begin()
+		for (PalookaNetwork::CommandRateLimiter& limiter : rateLimiters) {
+			limiter.setMaxRate(50); // AccessPoint::DEFAULT_MAX_COMMAND_RATE
+			limiter.reset();
+		}
+
+		// The physics runs whenever time moves, including inside the firmware's own delay() calls
+		hardware.setStepHandler([this](int64_t nowUs) { onStep(nowUs); });
+		wallStartUs = wallClockUs();
+
+		model.connect(hardware);
+		robot.begin();
+		if (!options.driveProfile.empty()) {
+			const PalookaBot::DriveProfile* profile = PalookaBot::DriveProfiles::findByName(options.driveProfile.c_str());
+			if (!profile) {
+				fprintf(stderr, "Unknown drive profile %s\n", options.driveProfile.c_str());
+				return 1;
+			}
+			robot.setDriveProfile(*profile);
+		}
+		deadline.begin();
+		boost.begin();
+
+		// Mirrors RobotTaskManager::robotTaskLoop(). Waiting on the command queue is a 1 ms step at a time.
+		uint32_t lastBatteryUpdate = 0;
+		while (!isFinished()) {
+			const uint32_t currentMillis = millis();
+			if ((currentMillis - lastBatteryUpdate) >= BATTERY_UPDATE_INTERVAL_MS) {
+				sendBatteryUpdate();
+				lastBatteryUpdate = currentMillis;
+			}
+
+			handleCommand();
+			robot.updateWheels();
+			robot.updateBatteryEstimate();
+			applyBoost();
+			robot.updateBoost();
+			deadline.update(false);
+			hardware.advance(Hardware::STEP_US);
+		}
+
+		hardware.setStepHandler(nullptr);
+		writeReports();
+		return 0;
+	}
+
+	// Private
+	// Each line is a controller message with the time it arrived: {"t":1250,"x":0,"y":1}
+	bool Simulator::loadReplay() {
+		std::ifstream file(options.replayPath);
+		if (!file) {
+			fprintf(stderr, "Can't read %s\n", options.replayPath.c_str());
+			return false;
+		}
+
+		std::string line;
+		size_t lineNumber = 0;
+		Message message;
+		while (std::getline(file, line)) {
+			++lineNumber;
+			if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+			if (!message.parse(line) || !message.has("t")) {
+				fprintf(stderr, "%s:%zu: expected a JSON object with \"t\"\n", options.replayPath.c_str(), lineNumber);
+				return false;
+			}
+			inputs.push_back(Input{static_cast<uint32_t>(message.getNumber("t")), line});
+		}
+		std::stable_sort(inputs.begin(), inputs.end(), [](const Input& a, const Input& b) { return a.atMs < b.atMs; });
+		return true;
+	}
+
+	bool Simulator::isFinished() const {
+		if (isStopRequested) return true;
+		if (options.replayPath.empty()) return false;
+
+		const uint32_t lastInputMs = inputs.empty() ? 0 : inputs.back().atMs;
+		return nextInput >= inputs.size() && queue.empty() && millis() >= lastInputMs + options.tailMs;
+	}
+
+	void Simulator::onStep(const int64_t nowUs) {
+		model.step(hardware, Hardware::STEP_US / 1e6f);
+		Log::drain(); // No drain task on the host
+
+		const DriveModel::State& state = model.getState();
+		distanceM += std::fabs(state.leftMps + state.rightMps) / 2.0 * Hardware::STEP_US / 1e6;
+		trackResponses(nowUs);
+		if (trajectory && nowUs >= nextSampleUs) {
+			writeSample(nowUs);
+			nextSampleUs = nowUs + options.sampleMs * 1000LL;
+		}
+
+		receiveInputs(nowUs);
+	}
+
+	// The network runs beside the robot task on the real robot, so input keeps arriving (and being stamped)
+	// while the firmware is blocked in a flip or a battery read
+	void Simulator::receiveInputs(const int64_t nowUs) {
+		if (!options.replayPath.empty()) {
+			while (nextInput < inputs.size() && inputs[nextInput].atMs * 1000LL <= nowUs) {
+				onMessage(0, inputs[nextInput].text);
+				++nextInput;
+			}
+		} else {
+			// Live: don't let simulated time run ahead of the wall clock, and handle the network while waiting
+			const int64_t aheadUs = nowUs - (wallClockUs() - wallStartUs);
+			server.poll(aheadUs > 0 ? static_cast<int>((aheadUs + 999) / 1000) : 0);
+		}
+
+		sendHeldCommands();
+	}
+
+	// Mirrors AccessPoint::sendHeldCommands()
+	void Simulator::sendHeldCommands() {
+		for (uint8_t client = 0; client < WebSocketServer::MAX_CLIENTS; ++client) {
+			if (!isCommandHeld[client] || !rateLimiters[client].allow(millis())) continue;
+			queue.push_back(heldCommands[client]);
+			isCommandHeld[client] = false;
+			driverClient = client;
+		}
+	}
+
+	// Mirrors AccessPoint::handleWebSocketMessage()
+	void Simulator::onMessage(const uint8_t client, const std::string& text) {
+		Message message;
+		if (!message.parse(text)) {
+			LOG_WARN_EVERY_MS(1000, "JSON parse error");
+			return;
+		}
+		if (record) {
+			const std::string body = text.substr(text.find('{') + 1);
+			const bool isEmpty = body.find_first_not_of(" \t\r\n") == body.find('}');
+			fprintf(record, "{\"t\":%lu%s%s\n", millis(), isEmpty ? "" : ",", body.c_str());
+		}
+
+		Command command{};
+		command.receivedMs = millis();
+		command.receivedUs = hardware.nowUs();
+		if (message.has("sliderName") && message.has("value")) {
+			command.type = Command::Type::SLIDER;
+			command.limb = message.getString("sliderName").c_str()[0];
+			command.value = static_cast<int>(message.getNumber("value"));
+		} else if (message.has("x") && message.has("y")) {
+			command.type = Command::Type::JOYSTICK;
+			command.x = static_cast<float>(message.getNumber("x"));
+			command.y = static_cast<float>(message.getNumber("y"));
+		} else if (message.getBool("flip")) {
+			command.type = Command::Type::FLIP;
+		} else if (message.getBool("toggleBoost")) {
+			boost.toggleArmed(); // On the network task, as it's saved to flash
+			return;
+		} else if (message.has("ping")) {
+			server.sendText(client, "{\"pong\":" + std::to_string(static_cast<unsigned long>(message.getNumber("ping"))) + "}");
+			return;
+		} else {
+			// Macros and the UDP channel aren't simulated - the controller keeps using the WebSocket without a reply
+			return;
+		}
+
+		++received;
+		if (command.type == Command::Type::SLIDER || command.type == Command::Type::JOYSTICK) {
+			if (client < WebSocketServer::MAX_CLIENTS) {
+				if (isCommandHeld[client]) ++rateLimited; // Dropped, as this one is newer
+				if (!command.isStop() && !rateLimiters[client].allow(millis())) {
+					heldCommands[client] = command;
+					isCommandHeld[client] = true;
+					return;
+				}
+				isCommandHeld[client] = false;
+			}
+			driverClient = client;
+		}
+		queue.push_back(command);
+	}
+
+	// Mirrors the connection handling in AccessPoint::begin() and AccessPoint::sendSnapshot()
+	void Simulator::onConnection(const uint8_t client, const bool isConnected) {
+		robot.getStatusLed().setCondition(PalookaBot::StatusLed::Condition::CLIENT_CONNECTED, server.connectedClients() > 0);
+		isCommandHeld[client] = false;
+		if (!isConnected) {
+			if (driverClient == client) driverClient = -1;
+			return;
+		}
+
+		rateLimiters[client].reset();
+		std::string snapshot = "{\"snapshot\":1,\"boost\":" + std::string(robot.isBoostEnabled() ? "true" : "false")
+				+ ",\"autoBoost\":" + std::string(boost.isArmed() ? "true" : "false")
+				+ ",\"flipper\":" + std::to_string(robot.getFlipperAngle());
+		if (lastBatteryPercent >= 0) snapshot += ",\"battery\":" + std::to_string(lastBatteryPercent);
+		snapshot += ",\"driver\":" + std::to_string(driverClient) + ",\"client\":" + std::to_string(client) + "}";
+		server.sendText(client, snapshot);
+	}
+
+	// Mirrors RobotTaskManager::handleWebsocketCommands()
+	void Simulator::handleCommand() {
+		if (queue.empty()) return;
+		const Command command = queue.front();
+		queue.pop_front();
+
+		// A stop is always applied, however late it is
+		if (!command.isStop() && !deadline.isFresh(command.receivedMs)) return;
+
+		++applied;
+		latencies.queueMs.push_back((hardware.nowUs() - command.receivedUs) / 1000.0f);
+		switch (command.type) {
+			case Command::Type::SLIDER:
+				LOG_DEBUG("Limb: %c, Value: %d", command.limb, command.value);
+				if (command.limb != 'F' && command.limb != 'f' && std::abs(command.value) >= FULL_STICK * 255) {
+					boost.noteDemand(millis());
+				}
+				handleSliderCommand(command.limb, command.value);
+				if (command.limb != 'F' && command.limb != 'f') {
+					deadline.noteDriveInput(command.receivedMs);
+					startSettling();
+				}
+				break;
+			case Command::Type::JOYSTICK:
+				LOG_DEBUG("Joystick X: %.2f, Y: %.2f", command.x, command.y);
+				if (std::max(std::fabs(command.x), std::fabs(command.y)) >= FULL_STICK) boost.noteDemand(millis());
+				robot.move(command.x, command.y);
+				deadline.noteDriveInput(command.receivedMs);
+				startSettling();
+				break;
+			case Command::Type::FLIP:
+				flipArrivalUs = command.receivedUs;
+				flipPeakDeg = 0;
+				boost.noteDemand(millis());
+				applyBoost();
+				robot.flip();
+				break;
+		}
+	}
+
+	void Simulator::handleSliderCommand(const char limb, const int value) {
+		switch (limb) {
+			case 'R': case 'r': robot.moveRightWheel(value); break;
+			case 'L': case 'l': robot.moveLeftWheel(value); break;
+			case 'F': case 'f': robot.moveFlipper(value); break;
+			default: LOG_WARN("Unknown robot limb JSON supplied."); break;
+		}
+	}
+
+	void Simulator::applyBoost() {
+		const bool wanted = boost.update(millis());
+		if (wanted != robot.isBoostEnabled()) robot.setBoostMode(wanted);
+	}
+
+	void Simulator::sendBatteryUpdate() {
+		lastBatteryPercent = robot.getBatteryPercentage(); // A quick reading through the estimator, as on the robot
+		boost.noteBatteryPercent(lastBatteryPercent);
+		robot.getStatusLed().setCondition(PalookaBot::StatusLed::Condition::LOW_BATTERY, lastBatteryPercent <= LOW_BATTERY_PERCENT);
+		server.broadcastText("{\"battery\":" + std::to_string(lastBatteryPercent) + "}");
+	}
+
+	void Simulator::startSettling() {
+		if (settleStartUs >= 0) ++superseded;
+		settleStartUs = hardware.nowUs();
+		settledForUs = 0;
+	}
+
+	void Simulator::trackResponses(const int64_t nowUs) {
+		const DriveModel::State& state = model.getState();
+		const float speeds[2]{state.leftMps, state.rightMps};
+
+		if (settleStartUs >= 0) {
+			bool isSettled = true;
+			for (int wheel = 0; wheel < 2; ++wheel) {
+				const float accel = (speeds[wheel] - previousSpeeds[wheel]) / (Hardware::STEP_US / 1e6f);
+				if (std::fabs(accel) >= SETTLED_ACCEL_MPS2) isSettled = false;
+			}
+			settledForUs = isSettled ? settledForUs + Hardware::STEP_US : 0;
+			if (settledForUs >= SETTLED_HOLD_US) {
+				latencies.settleMs.push_back((nowUs - settledForUs - settleStartUs) / 1000.0f);
+				settleStartUs = -1;
+			}
+		}
+		previousSpeeds[0] = speeds[0];
+		previousSpeeds[1] = speeds[1];
+
+		// The stroke tops out when the arm turns back, which may be short of the angle asked for
+		if (flipArrivalUs >= 0) {
+			if (state.flipperDeg > flipPeakDeg) {
+				flipPeakDeg = state.flipperDeg;
+			} else if (state.flipperDeg < flipPeakDeg) {
+				latencies.flipMs.push_back((nowUs - Hardware::STEP_US - flipArrivalUs) / 1000.0f);
+				latencies.flipPeakDeg.push_back(flipPeakDeg);
+				flipArrivalUs = -1;
+			}
+		}
+	}
+
+	void Simulator::writeSample(const int64_t nowUs) {
+		const DriveModel::State& state = model.getState();
+		fprintf(trajectory, "%.1f,%.4f,%.4f,%.2f,%.4f,%.4f,%.3f,%.3f,%.3f,%.3f,%.4f,%.1f,%d,%d,%d\n",
+				nowUs / 1000.0, state.xM, state.yM, state.headingRad * 180.0 / M_PI, state.leftMps, state.rightMps,
+				state.leftA, state.rightA, state.batteryV, state.batteryCurrentA, state.stateOfCharge, state.flipperDeg,
+				state.isBoosted, robot.getLeftWheelVelocity(), robot.getRightWheelVelocity());
+	}
+
+	void Simulator::writeReports() const {
+		const DriveModel::State& state = model.getState();
+		const Robot::CommandDeadline::Report deadlineReport = deadline.getReport();
+
+		printf("Simulated %.1f s: %u commands received, %u rate limited, %u expired, %u applied, %u silence stops\n",
+				hardware.nowUs() / 1e6, received, rateLimited, deadlineReport.expired, applied, deadlineReport.silenceStops);
+		printSummary(stdout, "queue", latencies.queueMs);
+		printSummary(stdout, "settle", latencies.settleMs);
+		printSummary(stdout, "flip", latencies.flipMs);
+		printSummary(stdout, "flip peak", latencies.flipPeakDeg, "deg");
+		const Robot::BoostGovernor::Report boostReport = boost.getReport();
+		printf("Boosted %u times for %.1f s in all, %u cut off by the governor's limits\n",
+				boostReport.boostCount, boostReport.totalBoostedMs / 1000.0f, boostReport.cutoffCount);
+		printf("Travelled %.2f m, ended at (%.3f, %.3f) facing %.1f deg. Battery %.3f V at %.1f%% charge (last reported %d%%)\n",
+				distanceM, state.xM, state.yM, state.headingRad * 180.0 / M_PI, state.batteryV, state.stateOfCharge * 100.0f,
+				lastBatteryPercent);
+
+		if (options.reportPath.empty()) return;
+		FILE* out = fopen(options.reportPath.c_str(), "w");
+		if (!out) {
+			fprintf(stderr, "Can't write %s\n", options.reportPath.c_str());
+			return;
+		}
+		fprintf(out, "{\"durationMs\":%.1f,\"received\":%u,\"rateLimited\":%u,\"expired\":%u,\"applied\":%u,"
+				"\"silenceStops\":%u,\"supersededBeforeSettling\":%u,",
+				hardware.nowUs() / 1000.0, received, rateLimited, deadlineReport.expired, applied,
+				deadlineReport.silenceStops, superseded);
+		writeJsonSummary(out, "queueMs", latencies.queueMs);
+		fputc(',', out);
+		writeJsonSummary(out, "settleMs", latencies.settleMs);
+		fputc(',', out);
+		writeJsonSummary(out, "flipMs", latencies.flipMs);
+		fputc(',', out);
+		writeJsonSummary(out, "flipPeakDeg", latencies.flipPeakDeg);
+		fprintf(out, ",\"distanceM\":%.3f,\"final\":{\"xM\":%.4f,\"yM\":%.4f,\"headingDeg\":%.2f,\"batteryV\":%.3f,\"stateOfCharge\":%.4f}}\n",
+				distanceM, state.xM, state.yM, state.headingRad * 180.0 / M_PI, state.batteryV, state.stateOfCharge);
+		fclose(out);
+	}
+}
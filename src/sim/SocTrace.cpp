@@ -0,0 +1,118 @@
+#include "sim/SocTrace.h"
+
+#include <PalookaBot/Battery.h>
+#include <PalookaBot/SocEstimator.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace Sim {
+	namespace {
+		std::vector<std::string> splitCsv(const std::string& line) {
+			std::vector<std::string> fields;
+			std::stringstream stream(line);
+			std::string field;
+			while (std::getline(stream, field, ',')) {
+				if (!field.empty() && field.back() == '\r') field.pop_back();
+				fields.push_back(field);
+			}
+			return fields;
+		}
+
+		int findColumn(const std::vector<std::string>& header, const char* name) {
+			for (size_t i = 0; i < header.size(); ++i) {
+				if (header[i] == name) return static_cast<int>(i);
+			}
+			return -1;
+		}
+
+		// Battery::readPercent() without its smoothing
+		int voltagePercent(const uint32_t mv) {
+			using PalookaBot::Battery;
+			if (mv >= Battery::FULL_MV) return 100;
+			if (mv <= Battery::FLAT_MV) return 0;
+			return static_cast<int>(std::lround(100.0f * (mv - Battery::FLAT_MV) / (Battery::FULL_MV - Battery::FLAT_MV)));
+		}
+
+		// Mean absolute change between consecutive reports, i.e. how much the figure shown to the driver jumps
+		struct Jitter {
+			int previous{-1};
+			long total{0};
+			int count{0};
+
+			void add(const int percent) {
+				if (previous >= 0) {
+					total += std::abs(percent - previous);
+					++count;
+				}
+				previous = percent;
+			}
+
+			float mean() const { return count ? static_cast<float>(total) / count : 0.0f; }
+		};
+	}
+
+	int replaySocTrace(const SocTraceOptions& options) {
+		std::ifstream in(options.tracePath);
+		if (!in) {
+			fprintf(stderr, "Can't read %s\n", options.tracePath.c_str());
+			return 1;
+		}
+
+		std::string line;
+		std::getline(in, line);
+		const std::vector<std::string> header = splitCsv(line);
+		const int timeColumn = findColumn(header, "time_ms");
+		const int mvColumn = findColumn(header, "battery_mv");
+		const int leftColumn = findColumn(header, "left_velocity");
+		const int rightColumn = findColumn(header, "right_velocity");
+		if (timeColumn < 0 || mvColumn < 0 || leftColumn < 0 || rightColumn < 0) {
+			fprintf(stderr, "%s: expected blackbox_decode.py CSV with time_ms, battery_mv, left_velocity and right_velocity\n",
+					options.tracePath.c_str());
+			return 1;
+		}
+
+		FILE* out = options.outputPath.empty() ? stdout : fopen(options.outputPath.c_str(), "w");
+		if (!out) {
+			fprintf(stderr, "Can't write %s\n", options.outputPath.c_str());
+			return 1;
+		}
+		fprintf(out, "time_ms,battery_mv,load_a,rested,estimate_percent,voltage_percent\n");
+
+		PalookaBot::SocEstimator estimator;
+		Jitter estimateJitter, voltageJitter;
+		bool hasCorrected{false};
+		uint32_t lastCorrectionMs{0};
+		size_t rows{0};
+		while (std::getline(in, line)) {
+			const std::vector<std::string> fields = splitCsv(line);
+			if (fields.size() < header.size()) continue;
+
+			const uint32_t timeMs = strtoul(fields[timeColumn].c_str(), nullptr, 10);
+			const uint32_t mv = strtoul(fields[mvColumn].c_str(), nullptr, 10);
+			estimator.update(timeMs, static_cast<int16_t>(atoi(fields[leftColumn].c_str())),
+					static_cast<int16_t>(atoi(fields[rightColumn].c_str())));
+			if (!hasCorrected || (timeMs - lastCorrectionMs) >= options.correctionMs) {
+				estimator.correct(timeMs, mv);
+				estimateJitter.add(estimator.getPercent());
+				voltageJitter.add(voltagePercent(mv));
+				hasCorrected = true;
+				lastCorrectionMs = timeMs;
+			}
+
+			fprintf(out, "%lu,%lu,%.3f,%d,%d,%d\n", static_cast<unsigned long>(timeMs), static_cast<unsigned long>(mv),
+					estimator.getLoadA(), estimator.isRested(timeMs), estimator.getPercent(), voltagePercent(mv));
+			++rows;
+		}
+		if (out != stdout) fclose(out);
+
+		fprintf(stderr, "%zu rows, %d corrections every %lu ms. Estimate ended at %d%%. "
+				"Mean change between reports: estimate %.1f%%, voltage only %.1f%%\n",
+				rows, estimateJitter.count + (estimateJitter.previous >= 0), static_cast<unsigned long>(options.correctionMs),
+				estimator.getPercent(), estimateJitter.mean(), voltageJitter.mean());
+		return 0;
+	}
+}
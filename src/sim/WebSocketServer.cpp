@@ -0,0 +1,316 @@
+#include "sim/WebSocketServer.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace Sim {
+	namespace {
+		constexpr const char* HANDSHAKE_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+		constexpr size_t MAX_MESSAGE_BYTES = 64 * 1024; // Macro uploads are the biggest thing the controller sends
+
+		enum Opcode : uint8_t { CONTINUATION = 0x0, TEXT = 0x1, BINARY = 0x2, CLOSE = 0x8, PING = 0x9, PONG = 0xA };
+
+		// SHA-1 of the handshake key - the only hash the protocol needs
+		std::string sha1(const std::string& message) {
+			uint32_t h[5]{0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+			std::string data = message;
+			const uint64_t bitLength = static_cast<uint64_t>(message.size()) * 8;
+			data += static_cast<char>(0x80);
+			while (data.size() % 64 != 56) data += '\0';
+			for (int i = 7; i >= 0; --i) data += static_cast<char>((bitLength >> (i * 8)) & 0xFF);
+
+			const auto rotate = [](uint32_t value, int bits) { return (value << bits) | (value >> (32 - bits)); };
+			for (size_t chunk = 0; chunk < data.size(); chunk += 64) {
+				uint32_t w[80];
+				for (int i = 0; i < 16; ++i) {
+					const auto* bytes = reinterpret_cast<const uint8_t*>(data.data() + chunk + i * 4);
+					w[i] = (bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+				}
+				for (int i = 16; i < 80; ++i) w[i] = rotate(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+				uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+				for (int i = 0; i < 80; ++i) {
+					uint32_t f, k;
+					if (i < 20) { f = (b & c) | (~b & d); k = 0x5A827999; }
+					else if (i < 40) { f = b ^ c ^ d; k = 0x6ED9EBA1; }
+					else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+					else { f = b ^ c ^ d; k = 0xCA62C1D6; }
+					const uint32_t temp = rotate(a, 5) + f + e + k + w[i];
+					e = d; d = c; c = rotate(b, 30); b = a; a = temp;
+				}
+				h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+			}
+
+			std::string digest;
+			for (const uint32_t word : h) {
+				for (int i = 3; i >= 0; --i) digest += static_cast<char>((word >> (i * 8)) & 0xFF);
+			}
+			return digest;
+		}
+
+		std::string base64(const std::string& bytes) {
+			static constexpr char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+			std::string out;
+			for (size_t i = 0; i < bytes.size(); i += 3) {
+				const size_t remaining = bytes.size() - i;
+				uint32_t group = static_cast<uint8_t>(bytes[i]) << 16;
+				if (remaining > 1) group |= static_cast<uint8_t>(bytes[i + 1]) << 8;
+				if (remaining > 2) group |= static_cast<uint8_t>(bytes[i + 2]);
+				out += ALPHABET[(group >> 18) & 0x3F];
+				out += ALPHABET[(group >> 12) & 0x3F];
+				out += remaining > 1 ? ALPHABET[(group >> 6) & 0x3F] : '=';
+				out += remaining > 2 ? ALPHABET[group & 0x3F] : '=';
+			}
+			return out;
+		}
+
+		// Value of a header in a raw HTTP request, or "" if it's missing. Names are matched case-insensitively.
+		std::string headerValue(const std::string& request, const char* name) {
+			const size_t nameLength = strlen(name);
+			size_t lineStart = request.find("\r\n");
+			while (lineStart != std::string::npos) {
+				lineStart += 2;
+				const size_t lineEnd = request.find("\r\n", lineStart);
+				if (lineEnd == std::string::npos || lineEnd == lineStart) break;
+				if (lineEnd - lineStart > nameLength && request[lineStart + nameLength] == ':'
+						&& strncasecmp(request.c_str() + lineStart, name, nameLength) == 0) {
+					size_t valueStart = lineStart + nameLength + 1;
+					while (valueStart < lineEnd && request[valueStart] == ' ') ++valueStart;
+					return request.substr(valueStart, lineEnd - valueStart);
+				}
+				lineStart = lineEnd;
+			}
+			return "";
+		}
+
+		bool sendAll(const int fd, const char* data, size_t length) {
+			while (length > 0) {
+				const ssize_t sent = send(fd, data, length, MSG_NOSIGNAL);
+				if (sent < 0) {
+					if (errno == EINTR) continue;
+					if (errno == EAGAIN || errno == EWOULDBLOCK) {
+						pollfd waitFor{fd, POLLOUT, 0};
+						::poll(&waitFor, 1, 100);
+						continue;
+					}
+					return false;
+				}
+				data += sent;
+				length -= sent;
+			}
+			return true;
+		}
+	}
+
+	WebSocketServer::~WebSocketServer() {
+		for (uint8_t client = 0; client < MAX_CLIENTS; ++client) close(client);
+		if (listenFd >= 0) ::close(listenFd);
+	}
+
+	bool WebSocketServer::begin(const uint16_t port) {
+		listenFd = socket(AF_INET, SOCK_STREAM, 0);
+		if (listenFd < 0) return false;
+
+		const int reuse = 1;
+		setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+		sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_ANY);
+		address.sin_port = htons(port);
+		if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listenFd, MAX_CLIENTS) != 0) {
+			::close(listenFd);
+			listenFd = -1;
+			return false;
+		}
+		fcntl(listenFd, F_SETFL, O_NONBLOCK);
+		return true;
+	}
+
+	void WebSocketServer::poll(const int timeoutMs) {
+		pollfd fds[MAX_CLIENTS + 1];
+		uint8_t clientFor[MAX_CLIENTS + 1];
+		nfds_t count = 0;
+		if (listenFd >= 0) fds[count++] = pollfd{listenFd, POLLIN, 0};
+		for (uint8_t client = 0; client < MAX_CLIENTS; ++client) {
+			if (clients[client].fd < 0) continue;
+			clientFor[count] = client;
+			fds[count++] = pollfd{clients[client].fd, POLLIN, 0};
+		}
+
+		if (::poll(fds, count, timeoutMs) <= 0) return;
+		for (nfds_t i = 0; i < count; ++i) {
+			if (!fds[i].revents) continue;
+			if (fds[i].fd == listenFd) accept();
+			else read(clientFor[i]);
+		}
+	}
+
+	void WebSocketServer::sendText(const uint8_t client, const std::string& text) {
+		if (client < MAX_CLIENTS && clients[client].isOpen) sendFrame(clients[client], TEXT, text);
+	}
+
+	void WebSocketServer::broadcastText(const std::string& text) {
+		for (uint8_t client = 0; client < MAX_CLIENTS; ++client) sendText(client, text);
+	}
+
+	uint8_t WebSocketServer::connectedClients() const {
+		uint8_t count = 0;
+		for (const Client& client : clients) count += client.isOpen;
+		return count;
+	}
+
+	// Private
+	void WebSocketServer::accept() {
+		const int fd = ::accept(listenFd, nullptr, nullptr);
+		if (fd < 0) return;
+
+		for (Client& client : clients) {
+			if (client.fd >= 0) continue;
+			const int noDelay = 1; // Control messages are tiny and latency is what's being measured
+			setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+			fcntl(fd, F_SETFL, O_NONBLOCK);
+			client = Client{};
+			client.fd = fd;
+			return;
+		}
+		::close(fd); // Full
+	}
+
+	void WebSocketServer::read(const uint8_t client) {
+		Client& connection = clients[client];
+		char buffer[4096];
+		const ssize_t received = recv(connection.fd, buffer, sizeof(buffer), 0);
+		if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+			close(client);
+			return;
+		}
+		if (received < 0) return;
+		connection.received.append(buffer, received);
+
+		if (!connection.isOpen) {
+			if (connection.received.find("\r\n\r\n") == std::string::npos) {
+				if (connection.received.size() > 8192) close(client);
+				return;
+			}
+			if (!handshake(connection)) {
+				close(client);
+				return;
+			}
+			if (connectionHandler) connectionHandler(client, true);
+		}
+		if (!readFrames(client)) close(client);
+	}
+
+	bool WebSocketServer::handshake(Client& client) {
+		const size_t end = client.received.find("\r\n\r\n") + 4;
+		const std::string request = client.received.substr(0, end);
+		client.received.erase(0, end);
+
+		const std::string key = headerValue(request, "Sec-WebSocket-Key");
+		if (request.compare(0, 4, "GET ") != 0 || key.empty()) {
+			static constexpr char BAD_REQUEST[] = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+			sendAll(client.fd, BAD_REQUEST, sizeof(BAD_REQUEST) - 1);
+			return false;
+		}
+
+		const std::string response = "HTTP/1.1 101 Switching Protocols\r\n"
+				"Upgrade: websocket\r\n"
+				"Connection: Upgrade\r\n"
+				"Sec-WebSocket-Accept: " + base64(sha1(key + HANDSHAKE_GUID)) + "\r\n\r\n";
+		if (!sendAll(client.fd, response.data(), response.size())) return false;
+		client.isOpen = true;
+		return true;
+	}
+
+	// Parses every complete frame received so far. Returns false if the connection should be closed.
+	bool WebSocketServer::readFrames(const uint8_t client) {
+		Client& connection = clients[client];
+		std::string& data = connection.received;
+
+		while (data.size() >= 2) {
+			const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+			const bool isFinal = bytes[0] & 0x80;
+			const uint8_t opcode = bytes[0] & 0x0F;
+			const bool isMasked = bytes[1] & 0x80;
+			uint64_t length = bytes[1] & 0x7F;
+			size_t headerSize = 2;
+			if (length == 126) {
+				if (data.size() < 4) return true;
+				length = (bytes[2] << 8) | bytes[3];
+				headerSize = 4;
+			} else if (length == 127) {
+				if (data.size() < 10) return true;
+				length = 0;
+				for (int i = 2; i < 10; ++i) length = (length << 8) | bytes[i];
+				headerSize = 10;
+			}
+			if (!isMasked || length > MAX_MESSAGE_BYTES) return false; // Clients must mask (RFC 6455 5.1)
+			if (data.size() < headerSize + 4 + length) return true;
+
+			const uint8_t* mask = bytes + headerSize;
+			std::string payload = data.substr(headerSize + 4, length);
+			for (size_t i = 0; i < payload.size(); ++i) payload[i] ^= mask[i % 4];
+			data.erase(0, headerSize + 4 + length);
+
+			switch (opcode) {
+				case TEXT:
+				case BINARY:
+				case CONTINUATION:
+					connection.fragments += payload;
+					if (connection.fragments.size() > MAX_MESSAGE_BYTES) return false;
+					if (isFinal) {
+						const std::string message = std::move(connection.fragments);
+						connection.fragments.clear();
+						if (messageHandler) messageHandler(client, message);
+						if (connection.fd < 0) return true; // The handler closed it
+					}
+					break;
+				case PING:
+					sendFrame(connection, PONG, payload);
+					break;
+				case CLOSE:
+					sendFrame(connection, CLOSE, payload.substr(0, 2));
+					return false;
+				default:
+					break; // Unsolicited pongs
+			}
+		}
+		return true;
+	}
+
+	void WebSocketServer::sendFrame(Client& client, const uint8_t opcode, const std::string& payload) {
+		std::string frame;
+		frame += static_cast<char>(0x80 | opcode);
+		if (payload.size() < 126) {
+			frame += static_cast<char>(payload.size());
+		} else if (payload.size() <= 0xFFFF) {
+			frame += static_cast<char>(126);
+			frame += static_cast<char>(payload.size() >> 8);
+			frame += static_cast<char>(payload.size() & 0xFF);
+		} else {
+			frame += static_cast<char>(127);
+			for (int i = 7; i >= 0; --i) frame += static_cast<char>((static_cast<uint64_t>(payload.size()) >> (i * 8)) & 0xFF);
+		}
+		frame += payload;
+		sendAll(client.fd, frame.data(), frame.size());
+	}
+
+	void WebSocketServer::close(const uint8_t client) {
+		Client& connection = clients[client];
+		if (connection.fd < 0) return;
+
+		const bool wasOpen = connection.isOpen;
+		::close(connection.fd);
+		connection = Client{};
+		if (wasOpen && connectionHandler) connectionHandler(client, false);
+	}
+}
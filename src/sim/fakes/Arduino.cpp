@@ -0,0 +1,151 @@
+#include <Arduino.h>
+
+#include <cerrno>
+#include <cstdarg>
+#include <unistd.h>
+
+#include "sim/Hardware.h"
+
+using Sim::Hardware;
+
+HardwareSerial Serial;
+EspClass ESP;
+
+namespace {
+	uint32_t cpuFrequencyMhz{240};
+
+	// Straight to the file descriptor, unbuffered, so output interleaves with the simulator's own in order
+	size_t writeToStderr(const char* text, const size_t length) {
+		size_t written{0};
+		while (written < length) {
+			const ssize_t result = ::write(STDERR_FILENO, text + written, length - written);
+			if (result < 0) {
+				if (errno == EINTR) continue;
+				break;
+			}
+			written += result;
+		}
+		return written;
+	}
+}
+
+long map(const long x, const long in_min, const long in_max, const long out_min, const long out_max) {
+	const long dividend = out_max - out_min;
+	const long divisor = in_max - in_min;
+	if (divisor == 0) return out_min;
+	return (x - in_min) * dividend / divisor + out_min;
+}
+
+// ========== Time ==========
+unsigned long millis() { return static_cast<unsigned long>(Hardware::getInstance().firmwareUs() / 1000); }
+unsigned long micros() { return static_cast<unsigned long>(Hardware::getInstance().firmwareUs()); }
+
+void delay(const uint32_t ms) { Hardware::getInstance().advance(ms * 1000LL); }
+void delayMicroseconds(const uint32_t us) { Hardware::getInstance().advance(us); }
+
+// ========== GPIO ==========
+void pinMode(const uint8_t pin, const uint8_t mode) {
+	if (pin < Hardware::NUM_PINS) Hardware::getInstance().pinModes[pin] = mode;
+}
+
+void digitalWrite(const uint8_t pin, const uint8_t val) { Hardware::getInstance().setLevel(pin, val != LOW); }
+
+// Pins nothing drives read as their pull resistor leaves them
+int digitalRead(const uint8_t pin) {
+	const Hardware& hardware = Hardware::getInstance();
+	if (pin >= Hardware::NUM_PINS) return LOW;
+	if (hardware.pinModes[pin] == OUTPUT) return hardware.isHigh(pin) ? HIGH : LOW;
+	return (hardware.pinModes[pin] & PULLUP) ? HIGH : LOW;
+}
+
+// ========== Interrupts ==========
+void attachInterruptArg(uint8_t /* pin */, void (* /* handler */)(void*), void* /* arg */, int /* mode */) {}
+void detachInterrupt(uint8_t /* pin */) {}
+
+// ========== LEDC ==========
+double ledcSetup(const uint8_t channel, const double freq, const uint8_t resolution_bits) {
+	Hardware& hardware = Hardware::getInstance();
+	if (channel >= Hardware::NUM_LEDC_CHANNELS || resolution_bits == 0 || resolution_bits > 20) return 0;
+
+	const int8_t pin = hardware.ledc[channel].pin;
+	hardware.ledc[channel] = Hardware::LedcChannel{0, static_cast<uint32_t>(freq), resolution_bits, pin};
+	return freq;
+}
+
+void ledcAttachPin(const uint8_t pin, const uint8_t channel) {
+	Hardware& hardware = Hardware::getInstance();
+	if (channel >= Hardware::NUM_LEDC_CHANNELS || pin >= Hardware::NUM_PINS) return;
+	hardware.ledc[channel].pin = pin;
+	hardware.pinModes[pin] = OUTPUT;
+}
+
+void ledcDetachPin(const uint8_t pin) {
+	for (Hardware::LedcChannel& channel : Hardware::getInstance().ledc) {
+		if (channel.pin == pin) channel.pin = -1;
+	}
+}
+
+void ledcWrite(const uint8_t channel, const uint32_t duty) {
+	if (channel < Hardware::NUM_LEDC_CHANNELS) Hardware::getInstance().ledc[channel].duty = duty;
+}
+
+// ========== String ==========
+#if defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38))
+size_t strlcpy(char* const destination, const char* const source, const size_t size) {
+	const size_t length = strlen(source);
+	if (size > 0) {
+		const size_t copied = std::min(length, size - 1);
+		memcpy(destination, source, copied);
+		destination[copied] = '\0';
+	}
+	return length;
+}
+#endif
+
+// ========== Serial ==========
+size_t HardwareSerial::print(const char* text) {
+	if (!Hardware::getInstance().isSerialEnabled() || !text) return 0;
+	return writeToStderr(text, strlen(text));
+}
+
+size_t HardwareSerial::printf(const char* format, ...) {
+	if (!Hardware::getInstance().isSerialEnabled()) return 0;
+	char text[256];
+	va_list args;
+	va_start(args, format);
+	const int length = vsnprintf(text, sizeof(text), format, args);
+	va_end(args);
+	if (length < 0) return 0;
+	return writeToStderr(text, std::min<size_t>(length, sizeof(text) - 1));
+}
+
+// ========== ESP ==========
+void EspClass::restart() {
+	Serial.println("[Host] ESP.restart() - exiting");
+	_exit(0); // Without static destructors, which could wait on tasks that will never run again
+}
+
+uint32_t getCpuFrequencyMhz() { return cpuFrequencyMhz; }
+
+bool setCpuFrequencyMhz(const uint32_t cpuFreqMhz) {
+	// The frequencies the core accepts with a 40 MHz crystal
+	if (cpuFreqMhz != 240 && cpuFreqMhz != 160 && cpuFreqMhz != 80 && cpuFreqMhz != 40 && cpuFreqMhz != 20
+			&& cpuFreqMhz != 10) return false;
+	cpuFrequencyMhz = cpuFreqMhz;
+	return true;
+}
+
+// ========== FreeRTOS ==========
+BaseType_t xTaskCreate(TaskFunction_t /* task */, const char* /* name */, uint32_t /* stackDepth */,
+		void* /* parameters */, unsigned int /* priority */, TaskHandle_t* createdTask) {
+	if (createdTask) *createdTask = nullptr;
+	return pdFAIL;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t /* task */) {
+	return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t /* clearOnExit */, TickType_t /* ticksToWait */) {
+	return 0;
+}
@@ -0,0 +1,167 @@
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <random>
+
+#include "driver/adc.h"
+#include "driver/gpio.h"
+#include "driver/pcnt.h"
+#include "esp_adc_cal.h"
+#include "esp_ipc.h"
+#include "esp_system.h"
+#include "esp_wifi.h"
+#include "hal/cpu_hal.h"
+#include "sim/Hardware.h"
+
+using Sim::Hardware;
+
+// ========== System ==========
+const char* esp_err_to_name(const esp_err_t code) {
+	switch (code) {
+		case ESP_OK: return "ESP_OK";
+		case ESP_FAIL: return "ESP_FAIL";
+		case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+		case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+		case ESP_ERR_NVS_NO_FREE_PAGES: return "ESP_ERR_NVS_NO_FREE_PAGES";
+		case ESP_ERR_NVS_NEW_VERSION_FOUND: return "ESP_ERR_NVS_NEW_VERSION_FOUND";
+		default: return "UNKNOWN ERROR";
+	}
+}
+
+esp_reset_reason_t esp_reset_reason() { return ESP_RST_POWERON; }
+
+uint32_t esp_random() {
+	static std::mt19937 generator{std::random_device{}()};
+	return generator();
+}
+
+esp_err_t esp_ipc_call_blocking(uint32_t /* cpu_id */, const esp_ipc_func_t func, void* arg) {
+	if (!func) return ESP_ERR_INVALID_ARG;
+	func(arg);
+	return ESP_OK;
+}
+
+uint32_t cpu_hal_get_cycle_count() {
+	return static_cast<uint32_t>(Hardware::getInstance().firmwareUs() * getCpuFrequencyMhz());
+}
+
+// ========== WiFi driver ==========
+esp_err_t esp_wifi_set_ps(wifi_ps_type_t /* type */) { return ESP_OK; }
+esp_err_t esp_wifi_set_bandwidth(wifi_interface_t /* ifx */, wifi_bandwidth_t /* bw */) { return ESP_OK; }
+esp_err_t esp_wifi_set_max_tx_power(int8_t /* power */) { return ESP_OK; }
+
+// ========== esp_timer ==========
+esp_err_t esp_timer_create(const esp_timer_create_args_t* create_args, esp_timer_handle_t* out_handle) {
+	if (!create_args || !create_args->callback || !out_handle) return ESP_ERR_INVALID_ARG;
+	*out_handle = Hardware::getInstance().createTimer(create_args->callback, create_args->arg);
+	return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(const esp_timer_handle_t timer, const uint64_t timeout_us) {
+	if (!timer) return ESP_ERR_INVALID_ARG;
+	return Hardware::getInstance().startTimer(timer, timeout_us, 0) ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t esp_timer_start_periodic(const esp_timer_handle_t timer, const uint64_t period) {
+	if (!timer || period == 0) return ESP_ERR_INVALID_ARG;
+	return Hardware::getInstance().startTimer(timer, period, period) ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t esp_timer_stop(const esp_timer_handle_t timer) {
+	if (!timer) return ESP_ERR_INVALID_ARG;
+	return Hardware::getInstance().stopTimer(timer) ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t esp_timer_delete(const esp_timer_handle_t timer) {
+	if (!timer) return ESP_ERR_INVALID_ARG;
+	return Hardware::getInstance().deleteTimer(timer) ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+int64_t esp_timer_get_time() { return Hardware::getInstance().firmwareUs(); }
+
+// ========== ADC ==========
+esp_err_t adc1_config_width(adc_bits_width_t /* width_bit */) { return ESP_OK; } // Always 12 bits
+
+esp_err_t adc1_config_channel_atten(const adc1_channel_t channel, const adc_atten_t atten) {
+	if (channel >= ADC1_CHANNEL_MAX) return ESP_ERR_INVALID_ARG;
+	Hardware::getInstance().adcAtten[channel] = atten;
+	return ESP_OK;
+}
+
+int adc1_get_raw(const adc1_channel_t channel) { return Hardware::getInstance().readAdcRaw(channel); }
+
+esp_adc_cal_value_t esp_adc_cal_characterize(const adc_unit_t adc_num, const adc_atten_t atten,
+		const adc_bits_width_t bit_width, const uint32_t default_vref, esp_adc_cal_characteristics_t* chars) {
+	static constexpr uint32_t FULL_SCALE_MV[]{950, 1250, 1750, 3100}; // Matches Hardware::readAdcRaw()
+	if (chars) *chars = esp_adc_cal_characteristics_t{adc_num, atten, bit_width, FULL_SCALE_MV[atten], 0, default_vref};
+	return ESP_ADC_CAL_VAL_DEFAULT_VREF;
+}
+
+uint32_t esp_adc_cal_raw_to_voltage(const uint32_t adc_reading, const esp_adc_cal_characteristics_t* chars) {
+	return chars ? (adc_reading * chars->coeff_a + 2047) / 4095 : 0;
+}
+
+// ========== GPIO ==========
+esp_err_t gpio_set_direction(gpio_num_t /* gpio_num */, gpio_mode_t /* mode */) { return ESP_OK; }
+esp_err_t gpio_set_pull_mode(gpio_num_t /* gpio_num */, gpio_pull_mode_t /* pull */) { return ESP_OK; }
+
+// ========== Pulse counter ==========
+// Counts the rising edges of the servo on the unit's pin: one per frame while the servo is attached
+namespace {
+	struct CounterUnit {
+		int pin{-1};
+		bool isRunning{false};
+		int64_t runningSinceUs{0};
+		double frames{0};
+	};
+	CounterUnit counterUnits[PCNT_UNIT_MAX];
+
+	double framesSince(const CounterUnit& unit) {
+		if (!unit.isRunning || unit.pin < 0 || unit.pin >= Hardware::NUM_PINS) return 0;
+		const Hardware::ServoOutput& servo = Hardware::getInstance().servos[unit.pin];
+		if (!servo.isAttached) return 0;
+		return (esp_timer_get_time() - unit.runningSinceUs) * servo.periodHertz / 1e6;
+	}
+}
+
+esp_err_t pcnt_unit_config(const pcnt_config_t* pcnt_config) {
+	if (!pcnt_config || pcnt_config->unit >= PCNT_UNIT_MAX) return ESP_ERR_INVALID_ARG;
+	counterUnits[pcnt_config->unit] = CounterUnit{pcnt_config->pulse_gpio_num};
+	return ESP_OK;
+}
+
+esp_err_t pcnt_set_pin(const pcnt_unit_t unit, pcnt_channel_t /* channel */, const int pulse_io, int /* ctrl_io */) {
+	if (unit >= PCNT_UNIT_MAX) return ESP_ERR_INVALID_ARG;
+	counterUnits[unit].pin = pulse_io;
+	return ESP_OK;
+}
+
+esp_err_t pcnt_counter_pause(const pcnt_unit_t pcnt_unit) {
+	if (pcnt_unit >= PCNT_UNIT_MAX) return ESP_ERR_INVALID_ARG;
+	CounterUnit& unit = counterUnits[pcnt_unit];
+	unit.frames += framesSince(unit);
+	unit.isRunning = false;
+	return ESP_OK;
+}
+
+esp_err_t pcnt_counter_resume(const pcnt_unit_t pcnt_unit) {
+	if (pcnt_unit >= PCNT_UNIT_MAX) return ESP_ERR_INVALID_ARG;
+	CounterUnit& unit = counterUnits[pcnt_unit];
+	if (!unit.isRunning) unit.runningSinceUs = esp_timer_get_time();
+	unit.isRunning = true;
+	return ESP_OK;
+}
+
+esp_err_t pcnt_counter_clear(const pcnt_unit_t pcnt_unit) {
+	if (pcnt_unit >= PCNT_UNIT_MAX) return ESP_ERR_INVALID_ARG;
+	CounterUnit& unit = counterUnits[pcnt_unit];
+	unit.frames = 0;
+	unit.runningSinceUs = esp_timer_get_time();
+	return ESP_OK;
+}
+
+esp_err_t pcnt_get_counter_value(const pcnt_unit_t pcnt_unit, int16_t* count) {
+	if (pcnt_unit >= PCNT_UNIT_MAX || !count) return ESP_ERR_INVALID_ARG;
+	const CounterUnit& unit = counterUnits[pcnt_unit];
+	*count = static_cast<int16_t>(std::min(unit.frames + framesSince(unit), static_cast<double>(INT16_MAX)));
+	return ESP_OK;
+}
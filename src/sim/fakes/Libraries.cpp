@@ -0,0 +1,158 @@
+#include <ESP32Servo.h>
+#include <Preferences.h>
+#include <nvs_flash.h>
+
+#include <map>
+#include <mutex>
+
+#include "sim/Hardware.h"
+
+using Sim::Hardware;
+
+// ========== ESP32Servo ==========
+int Servo::attach(const int newPin, const int newMinPulseUs, const int newMaxPulseUs) {
+	if (newPin < 0 || newPin >= Hardware::NUM_PINS) return 0;
+	if (attached()) detach();
+
+	pin = newPin;
+	minPulseUs = newMinPulseUs;
+	maxPulseUs = newMaxPulseUs;
+	Hardware& hardware = Hardware::getInstance();
+	hardware.pinModes[pin] = OUTPUT;
+	hardware.servos[pin] = Hardware::ServoOutput{true, static_cast<uint16_t>(periodHertz), static_cast<uint16_t>(pulseUs),
+			hardware.nowUs()};
+	return 1; // ESP32Servo returns the LEDC channel, which only has to be non-zero here
+}
+
+void Servo::detach() {
+	if (!attached()) return;
+	Hardware::getInstance().servos[pin].isAttached = false;
+	pin = -1;
+}
+
+void Servo::write(int angle) {
+	if (angle >= MIN_PULSE_WIDTH_US) { // Like the library, large values are taken as microseconds
+		writeMicroseconds(angle);
+		return;
+	}
+	angle = constrain(angle, 0, 180);
+	writeMicroseconds(map(angle, 0, 180, minPulseUs, maxPulseUs));
+}
+
+void Servo::writeMicroseconds(const int newPulseUs) {
+	pulseUs = constrain(newPulseUs, minPulseUs, maxPulseUs);
+	if (attached()) Hardware::getInstance().servos[pin].pulseUs = pulseUs;
+}
+
+// ========== Preferences ==========
+namespace {
+	struct Value {
+		uint32_t number;
+		float decimal;
+		std::string text;
+	};
+
+	// The rtos env reads and writes preferences from several tasks, so every access holds storeMutex
+	std::mutex storeMutex;
+	std::map<std::string, Value> store;
+}
+
+bool Preferences::begin(const char* name, const bool isReadOnly) {
+	if (!name || isOpen) return false;
+	space = name;
+	readOnly = isReadOnly;
+	isOpen = true;
+	return true;
+}
+
+bool Preferences::isKey(const char* key) {
+	std::lock_guard<std::mutex> lock(storeMutex);
+	return isOpen && store.count(fullKey(key));
+}
+
+bool Preferences::remove(const char* key) {
+	std::lock_guard<std::mutex> lock(storeMutex);
+	return canWrite() && store.erase(fullKey(key));
+}
+
+bool Preferences::clear() {
+	if (!canWrite()) return false;
+	std::lock_guard<std::mutex> lock(storeMutex);
+	const std::string prefix = space + '/';
+	for (auto it = store.lower_bound(prefix); it != store.end() && it->first.compare(0, prefix.size(), prefix) == 0;) {
+		it = store.erase(it);
+	}
+	return true;
+}
+
+uint32_t Preferences::getUInt(const char* key, const uint32_t defaultValue) {
+	std::lock_guard<std::mutex> lock(storeMutex);
+	const auto it = isOpen ? store.find(fullKey(key)) : store.end();
+	return it != store.end() ? it->second.number : defaultValue;
+}
+
+size_t Preferences::putUInt(const char* key, const uint32_t value) {
+	if (!canWrite()) return 0;
+	std::lock_guard<std::mutex> lock(storeMutex);
+	store[fullKey(key)].number = value;
+	return sizeof(value);
+}
+
+uint16_t Preferences::getUShort(const char* key, const uint16_t defaultValue) {
+	return static_cast<uint16_t>(getUInt(key, defaultValue));
+}
+
+size_t Preferences::putUShort(const char* key, const uint16_t value) { return putUInt(key, value) ? sizeof(value) : 0; }
+
+uint8_t Preferences::getUChar(const char* key, const uint8_t defaultValue) {
+	return static_cast<uint8_t>(getUInt(key, defaultValue));
+}
+
+size_t Preferences::putUChar(const char* key, const uint8_t value) { return putUInt(key, value) ? sizeof(value) : 0; }
+
+int8_t Preferences::getChar(const char* key, const int8_t defaultValue) {
+	return static_cast<int8_t>(getUInt(key, static_cast<uint8_t>(defaultValue)));
+}
+
+size_t Preferences::putChar(const char* key, const int8_t value) {
+	return putUInt(key, static_cast<uint8_t>(value)) ? sizeof(value) : 0;
+}
+
+bool Preferences::getBool(const char* key, const bool defaultValue) { return getUInt(key, defaultValue) != 0; }
+
+size_t Preferences::putBool(const char* key, const bool value) { return putUInt(key, value) ? sizeof(value) : 0; }
+
+float Preferences::getFloat(const char* key, const float defaultValue) {
+	std::lock_guard<std::mutex> lock(storeMutex);
+	const auto it = isOpen ? store.find(fullKey(key)) : store.end();
+	return it != store.end() ? it->second.decimal : defaultValue;
+}
+
+size_t Preferences::putFloat(const char* key, const float value) {
+	if (!canWrite()) return 0;
+	std::lock_guard<std::mutex> lock(storeMutex);
+	store[fullKey(key)].decimal = value;
+	return sizeof(value);
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+	std::lock_guard<std::mutex> lock(storeMutex);
+	const auto it = isOpen ? store.find(fullKey(key)) : store.end();
+	return it != store.end() ? String(it->second.text) : defaultValue;
+}
+
+size_t Preferences::putString(const char* key, const String& value) {
+	if (!canWrite()) return 0;
+	std::lock_guard<std::mutex> lock(storeMutex);
+	store[fullKey(key)].text = value.c_str();
+	return value.length();
+}
+
+// ========== nvs_flash ==========
+esp_err_t nvs_flash_init() { return ESP_OK; }
+
+esp_err_t nvs_flash_erase() {
+	std::lock_guard<std::mutex> lock(storeMutex);
+	store.clear();
+	return ESP_OK;
+}
@@ -0,0 +1,596 @@
+#include <LittleFS.h>
+#include <Update.h>
+#include <WebServer.h>
+#include <WebSocketsServer.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "sim/Host.h"
+
+using Sim::Host;
+
+WiFiClass WiFi;
+fs::FS LittleFS;
+UpdateClass Update;
+
+namespace {
+	bool sendAll(const int fd, const char* data, size_t length) {
+		while (length > 0) {
+			const ssize_t sent = send(fd, data, length, MSG_NOSIGNAL);
+			if (sent < 0) {
+				if (errno == EINTR) continue;
+				if (errno == EAGAIN || errno == EWOULDBLOCK) {
+					pollfd waitFor{fd, POLLOUT, 0};
+					::poll(&waitFor, 1, 100);
+					continue;
+				}
+				return false;
+			}
+			data += sent;
+			length -= sent;
+		}
+		return true;
+	}
+
+	// Non-blocking TCP listener on every interface, or -1
+	int listenOn(const uint16_t port) {
+		const int fd = socket(AF_INET, SOCK_STREAM, 0);
+		if (fd < 0) return -1;
+
+		const int reuse = 1;
+		setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+		sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_ANY);
+		address.sin_port = htons(port);
+		if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 4) != 0) {
+			::close(fd);
+			return -1;
+		}
+		fcntl(fd, F_SETFL, O_NONBLOCK);
+		return fd;
+	}
+
+	int hexValue(const char c) {
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
+
+	std::string urlDecode(const std::string& text) {
+		std::string decoded;
+		for (size_t i = 0; i < text.size(); ++i) {
+			if (text[i] == '+') {
+				decoded += ' ';
+			} else if (text[i] == '%' && i + 2 < text.size() && hexValue(text[i + 1]) >= 0 && hexValue(text[i + 2]) >= 0) {
+				decoded += static_cast<char>(hexValue(text[i + 1]) * 16 + hexValue(text[i + 2]));
+				i += 2;
+			} else {
+				decoded += text[i];
+			}
+		}
+		return decoded;
+	}
+
+	void parseArgs(const std::string& text, std::vector<std::pair<std::string, std::string>>& args) {
+		size_t start = 0;
+		while (start < text.size()) {
+			size_t end = text.find('&', start);
+			if (end == std::string::npos) end = text.size();
+			const std::string pair = text.substr(start, end - start);
+			const size_t equals = pair.find('=');
+			if (!pair.empty()) {
+				args.emplace_back(urlDecode(pair.substr(0, equals)),
+						equals == std::string::npos ? std::string() : urlDecode(pair.substr(equals + 1)));
+			}
+			start = end + 1;
+		}
+	}
+
+	std::string headerValue(const std::string& head, const char* name) {
+		const size_t nameLength = strlen(name);
+		size_t lineStart = head.find("\r\n");
+		while (lineStart != std::string::npos) {
+			lineStart += 2;
+			const size_t lineEnd = head.find("\r\n", lineStart);
+			if (lineEnd == std::string::npos || lineEnd == lineStart) break;
+			if (lineEnd - lineStart > nameLength && head[lineStart + nameLength] == ':'
+					&& strncasecmp(head.c_str() + lineStart, name, nameLength) == 0) {
+				size_t valueStart = lineStart + nameLength + 1;
+				while (valueStart < lineEnd && head[valueStart] == ' ') ++valueStart;
+				return head.substr(valueStart, lineEnd - valueStart);
+			}
+			lineStart = lineEnd;
+		}
+		return "";
+	}
+
+	HTTPMethod methodFromName(const std::string& name) {
+		if (name == "GET") return HTTP_GET;
+		if (name == "HEAD") return HTTP_HEAD;
+		if (name == "POST") return HTTP_POST;
+		if (name == "PUT") return HTTP_PUT;
+		if (name == "PATCH") return HTTP_PATCH;
+		if (name == "DELETE") return HTTP_DELETE;
+		if (name == "OPTIONS") return HTTP_OPTIONS;
+		return HTTP_ANY;
+	}
+
+	const char* reasonPhrase(const int code) {
+		switch (code) {
+			case 200: return "OK";
+			case 202: return "Accepted";
+			case 204: return "No Content";
+			case 302: return "Found";
+			case 400: return "Bad Request";
+			case 404: return "Not Found";
+			case 409: return "Conflict";
+			case 413: return "Payload Too Large";
+			case 500: return "Internal Server Error";
+			case 503: return "Service Unavailable";
+			default: return "";
+		}
+	}
+
+	const char* contentTypeFor(const std::string& path) {
+		static constexpr const char* TYPES[][2]{
+			{".html", "text/html"}, {".htm", "text/html"}, {".css", "text/css"}, {".js", "application/javascript"},
+			{".json", "application/json"}, {".png", "image/png"}, {".ico", "image/x-icon"}, {".svg", "image/svg+xml"},
+			{".txt", "text/plain"}
+		};
+		for (const auto& type : TYPES) {
+			const size_t length = strlen(type[0]);
+			if (path.size() >= length && path.compare(path.size() - length, length, type[0]) == 0) return type[1];
+		}
+		return "application/octet-stream";
+	}
+
+	// Routes added with on()
+	class FunctionRequestHandler : public RequestHandler {
+		public:
+			FunctionRequestHandler(const String& uri, const HTTPMethod method, WebServer::THandlerFunction fn,
+					WebServer::THandlerFunction ufn)
+				: uri(uri), method(method), fn(std::move(fn)), ufn(std::move(ufn)) {}
+
+			bool canHandle(const HTTPMethod requestMethod, const String requestUri) override {
+				return (method == HTTP_ANY || method == requestMethod) && requestUri == uri;
+			}
+
+			bool canUpload(const String requestUri) override { return ufn && canHandle(HTTP_POST, requestUri); }
+
+			bool handle(WebServer& /* server */, const HTTPMethod requestMethod, const String requestUri) override {
+				if (!canHandle(requestMethod, requestUri)) return false;
+				fn();
+				return true;
+			}
+
+			void upload(WebServer& /* server */, const String requestUri, HTTPUpload& /* upload */) override {
+				if (canUpload(requestUri)) ufn();
+			}
+
+		private:
+			const String uri;
+			const HTTPMethod method;
+			const WebServer::THandlerFunction fn;
+			const WebServer::THandlerFunction ufn;
+	};
+
+	// serveStatic(): GETs under uri map to files under path, with index.htm for directories
+	class StaticRequestHandler : public RequestHandler {
+		public:
+			StaticRequestHandler(fs::FS& fs, const char* path, const char* uri) : fs(fs), path(path), uri(uri) {}
+
+			bool canHandle(const HTTPMethod requestMethod, const String requestUri) override {
+				return requestMethod == HTTP_GET && requestUri.startsWith(uri.c_str());
+			}
+
+			bool handle(WebServer& server, const HTTPMethod requestMethod, const String requestUri) override {
+				if (!canHandle(requestMethod, requestUri)) return false;
+
+				std::string filePath = path + std::string(requestUri.c_str()).substr(uri.size());
+				if (!filePath.empty() && filePath.back() == '/') filePath += "index.htm";
+				std::string::size_type doubleSlash;
+				while ((doubleSlash = filePath.find("//")) != std::string::npos) filePath.erase(doubleSlash, 1);
+
+				File file = fs.open(filePath.c_str(), "r");
+				if (!file || file.isDirectory()) return false;
+				server.streamFile(file, contentTypeFor(filePath));
+				return true;
+			}
+
+		private:
+			fs::FS& fs;
+			const std::string path;
+			const std::string uri;
+	};
+}
+
+// ========== WiFi ==========
+String IPAddress::toString() const {
+	char text[16];
+	snprintf(text, sizeof(text), "%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]);
+	return String(text);
+}
+
+bool WiFiClass::softAP(const String& /* ssid */, const String& /* passphrase */, const int channel) {
+	if (channel < 1 || channel > 13) return false;
+	apChannel = static_cast<uint8_t>(channel);
+	return true;
+}
+
+uint8_t* WiFiClass::macAddress(uint8_t* mac) const {
+	static constexpr uint8_t HOST_MAC[6]{0x02, 0x00, 0x00, 0x00, 0x00, 0x01}; // Locally administered
+	memcpy(mac, HOST_MAC, sizeof(HOST_MAC));
+	return mac;
+}
+
+wl_status_t WiFiClass::begin(const char* /* ssid */, const char* /* passphrase */) { return WL_CONNECTED; }
+
+void WiFiClass::onEvent(EventHandler handler, arduino_event_id_t /* event */) { eventHandler = std::move(handler); }
+
+// ========== WiFiUDP ==========
+uint8_t WiFiUDP::begin(const uint16_t port) {
+	stop();
+	fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (fd < 0) return 0;
+
+	const int enable = 1;
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)); // Several robots on one host share the beacon port
+	setsockopt(fd, SOL_SOCKET, SO_BROADCAST, &enable, sizeof(enable));
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	address.sin_port = htons(port);
+	if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+		stop();
+		return 0;
+	}
+	fcntl(fd, F_SETFL, O_NONBLOCK);
+	return 1;
+}
+
+void WiFiUDP::stop() {
+	if (fd >= 0) ::close(fd);
+	fd = -1;
+	received.clear();
+	readOffset = 0;
+}
+
+int WiFiUDP::parsePacket() {
+	received.clear();
+	readOffset = 0;
+	if (fd < 0) return 0;
+
+	char buffer[1500];
+	sockaddr_in sender{};
+	socklen_t senderLength = sizeof(sender);
+	ssize_t length;
+	do {
+		length = recvfrom(fd, buffer, sizeof(buffer), 0, reinterpret_cast<sockaddr*>(&sender), &senderLength);
+	} while (length < 0 && errno == EINTR);
+	if (length <= 0) return 0;
+
+	received.assign(buffer, length);
+	remoteAddress = IPAddress(static_cast<uint32_t>(sender.sin_addr.s_addr));
+	remotePortNumber = ntohs(sender.sin_port);
+	return static_cast<int>(length);
+}
+
+int WiFiUDP::read(uint8_t* buffer, const size_t length) {
+	const size_t count = std::min(length, received.size() - readOffset);
+	memcpy(buffer, received.data() + readOffset, count);
+	readOffset += count;
+	return static_cast<int>(count);
+}
+
+int WiFiUDP::beginPacket(const IPAddress ip, const uint16_t port) {
+	sending.clear();
+	sendAddress = ip;
+	sendPort = port;
+	isSending = true;
+	return 1;
+}
+
+size_t WiFiUDP::write(const uint8_t* buffer, const size_t size) {
+	if (!isSending) return 0;
+	sending.append(reinterpret_cast<const char*>(buffer), size);
+	return size;
+}
+
+int WiFiUDP::endPacket() {
+	if (!isSending || fd < 0) return 0;
+	isSending = false;
+
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = static_cast<uint32_t>(sendAddress);
+	address.sin_port = htons(sendPort);
+	ssize_t sent;
+	do {
+		sent = sendto(fd, sending.data(), sending.size(), 0, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+	} while (sent < 0 && errno == EINTR);
+	return sent == static_cast<ssize_t>(sending.size());
+}
+
+// ========== LittleFS ==========
+fs::File::File(FILE* openFile, const bool isDirectory, const size_t size)
+	: file(openFile, [](FILE* handle) { if (handle) fclose(handle); }), directory(isDirectory), fileSize(size) {}
+
+size_t fs::File::read(uint8_t* buffer, const size_t size) {
+	return file ? fread(buffer, 1, size, file.get()) : 0;
+}
+
+void fs::File::close() {
+	file.reset();
+	directory = false;
+	fileSize = 0;
+}
+
+fs::File fs::FS::open(const char* path, const char* mode) {
+	const std::string hostPath = Host::getInstance().dataDir + (path[0] == '/' ? "" : "/") + path;
+	struct stat info;
+	if (!mode || mode[0] != 'r' || stat(hostPath.c_str(), &info) != 0) return File();
+	if (S_ISDIR(info.st_mode)) return File(nullptr, true, 0);
+
+	FILE* file = fopen(hostPath.c_str(), "rb");
+	return file ? File(file, false, static_cast<size_t>(info.st_size)) : File();
+}
+
+bool fs::FS::exists(const char* path) {
+	const std::string hostPath = Host::getInstance().dataDir + (path[0] == '/' ? "" : "/") + path;
+	struct stat info;
+	return stat(hostPath.c_str(), &info) == 0;
+}
+
+// ========== WebServer ==========
+WebServer::~WebServer() {
+	for (RequestHandler* handler : ownedHandlers) delete handler;
+	if (listenFd >= 0) ::close(listenFd);
+}
+
+void WebServer::begin() {
+	listenFd = listenOn(Host::getInstance().port(robotPort));
+	if (listenFd < 0) {
+		Serial.printf("[Host] Can't serve HTTP on port %u: %s\n", Host::getInstance().port(robotPort), strerror(errno));
+	}
+}
+
+void WebServer::handleClient() {
+	if (listenFd < 0) return;
+	sockaddr_in peer{};
+	socklen_t peerLength = sizeof(peer);
+	clientFd = ::accept(listenFd, reinterpret_cast<sockaddr*>(&peer), &peerLength);
+	if (clientFd < 0) return;
+	fcntl(clientFd, F_SETFL, O_NONBLOCK);
+	clientAddress = IPAddress(static_cast<uint32_t>(peer.sin_addr.s_addr));
+
+	HTTPMethod method;
+	std::string uri, contentType, body;
+	args.clear();
+	responseHeaders.clear();
+	contentLength = CONTENT_LENGTH_NOT_SET;
+	isChunked = false;
+	hasResponded = false;
+	if (readRequest(method, uri, contentType, body)) {
+		const size_t query = uri.find('?');
+		if (query != std::string::npos) {
+			parseArgs(uri.substr(query + 1), args);
+			uri.erase(query);
+		}
+		const bool isMultipart = contentType.rfind("multipart/form-data", 0) == 0;
+		if (contentType.rfind("application/x-www-form-urlencoded", 0) == 0) parseArgs(body, args);
+		else if (!isMultipart && !body.empty()) args.emplace_back("plain", body);
+
+		dispatch(method, urlDecode(uri), isMultipart);
+	}
+
+	::close(clientFd);
+	clientFd = -1;
+}
+
+void WebServer::on(const String& uri, const HTTPMethod method, THandlerFunction fn) {
+	addOwnedHandler(new FunctionRequestHandler(uri, method, std::move(fn), nullptr));
+}
+
+void WebServer::on(const String& uri, const HTTPMethod method, THandlerFunction fn, THandlerFunction ufn) {
+	addOwnedHandler(new FunctionRequestHandler(uri, method, std::move(fn), std::move(ufn)));
+}
+
+void WebServer::addHandler(RequestHandler* handler) {
+	if (!lastHandler) firstHandler = handler;
+	else lastHandler->next(handler);
+	lastHandler = handler;
+}
+
+void WebServer::serveStatic(const char* uri, fs::FS& fs, const char* path) {
+	addOwnedHandler(new StaticRequestHandler(fs, path, uri));
+}
+
+String WebServer::arg(const String& name) const {
+	for (const auto& [argName, value] : args) {
+		if (name == argName) return String(value);
+	}
+	return String();
+}
+
+bool WebServer::hasArg(const String& name) const {
+	for (const auto& entry : args) {
+		if (name == entry.first) return true;
+	}
+	return false;
+}
+
+void WebServer::sendHeader(const String& name, const String& value, const bool first) {
+	const std::string header = std::string(name.c_str()) + ": " + value.c_str() + "\r\n";
+	responseHeaders = first ? header + responseHeaders : responseHeaders + header;
+}
+
+void WebServer::send(const int code, const char* contentType, const String& content) {
+	send_P(code, contentType, content.c_str(), content.length());
+}
+
+void WebServer::send_P(const int code, const char* contentType, const char* content, const size_t length) {
+	writeHead(code, contentType, contentLength == CONTENT_LENGTH_NOT_SET ? length : contentLength);
+	if (length > 0) sendContent(content, length);
+}
+
+void WebServer::sendContent(const char* content, const size_t length) {
+	if (!isChunked) {
+		writeAll(content, length);
+		return;
+	}
+	char size[20];
+	snprintf(size, sizeof(size), "%zx\r\n", length);
+	writeAll(size, strlen(size));
+	writeAll(content, length);
+	writeAll("\r\n", 2);
+	if (length == 0) isChunked = false; // The last chunk
+}
+
+size_t WebServer::streamFile(fs::File& file, const String& contentType) {
+	writeHead(200, contentType.c_str(), file.size());
+	uint8_t buffer[4096];
+	size_t total = 0;
+	for (size_t length = file.read(buffer, sizeof(buffer)); length > 0; length = file.read(buffer, sizeof(buffer))) {
+		if (!writeAll(reinterpret_cast<const char*>(buffer), length)) break;
+		total += length;
+	}
+	return total;
+}
+
+// Private
+void WebServer::addOwnedHandler(RequestHandler* handler) {
+	ownedHandlers.push_back(handler);
+	addHandler(handler);
+}
+
+bool WebServer::readRequest(HTTPMethod& method, std::string& uri, std::string& contentType, std::string& body) {
+	using Clock = std::chrono::steady_clock;
+	const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(REQUEST_TIMEOUT_MS);
+	std::string received;
+	size_t headEnd = std::string::npos;
+	size_t contentLength = 0;
+
+	while (true) {
+		if (headEnd == std::string::npos) {
+			headEnd = received.find("\r\n\r\n");
+			if (headEnd != std::string::npos) {
+				const std::string head = received.substr(0, headEnd + 2); // With the last header's line end
+				contentLength = strtoul(headerValue(head, "Content-Length").c_str(), nullptr, 10);
+				contentType = headerValue(head, "Content-Type");
+				const size_t methodEnd = head.find(' ');
+				const size_t uriEnd = head.find(' ', methodEnd + 1);
+				if (methodEnd == std::string::npos || uriEnd == std::string::npos) return false;
+				method = methodFromName(head.substr(0, methodEnd));
+				uri = head.substr(methodEnd + 1, uriEnd - methodEnd - 1);
+				received.erase(0, headEnd + 4);
+			} else if (received.size() > 8192) {
+				return false;
+			}
+		}
+		if (headEnd != std::string::npos) {
+			body.append(received, 0, MAX_BODY_BYTES > body.size() ? MAX_BODY_BYTES - body.size() : 0);
+			contentLength -= std::min(contentLength, received.size());
+			received.clear();
+			if (contentLength == 0) return true;
+		}
+
+		const int remainingMs = static_cast<int>(
+				std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count());
+		if (remainingMs <= 0) return false;
+		pollfd waitFor{clientFd, POLLIN, 0};
+		if (::poll(&waitFor, 1, remainingMs) < 0 && errno != EINTR) return false;
+
+		char buffer[4096];
+		const ssize_t length = recv(clientFd, buffer, sizeof(buffer), 0);
+		if (length == 0 || (length < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) return false;
+		if (length > 0) received.append(buffer, length);
+	}
+}
+
+void WebServer::dispatch(const HTTPMethod method, const std::string& uri, const bool isMultipart) {
+	const String requestUri(uri);
+	RequestHandler* handler = firstHandler;
+	while (handler && !handler->canHandle(method, requestUri)) handler = handler->next();
+
+	if (handler && isMultipart && handler->canUpload(requestUri)) {
+		currentUpload = HTTPUpload{};
+		currentUpload.status = UPLOAD_FILE_START;
+		handler->upload(*this, requestUri, currentUpload);
+		currentUpload.status = UPLOAD_FILE_END;
+		handler->upload(*this, requestUri, currentUpload);
+	}
+
+	const bool handled = handler && handler->handle(*this, method, requestUri);
+	if (handled) return;
+	if (notFoundHandler) notFoundHandler();
+	else send(404, "text/plain", String("Not found: ") + requestUri);
+}
+
+void WebServer::writeHead(const int code, const char* contentType, const size_t length) {
+	if (hasResponded) return;
+	hasResponded = true;
+	isChunked = length == CONTENT_LENGTH_UNKNOWN;
+
+	std::string head = "HTTP/1.1 " + std::to_string(code) + " " + reasonPhrase(code) + "\r\n";
+	if (contentType) head += std::string("Content-Type: ") + contentType + "\r\n";
+	head += isChunked ? std::string("Transfer-Encoding: chunked\r\n") : "Content-Length: " + std::to_string(length) + "\r\n";
+	head += "Connection: close\r\n";
+	head += responseHeaders;
+	head += "\r\n";
+	writeAll(head.data(), head.size());
+}
+
+bool WebServer::writeAll(const char* data, const size_t length) {
+	return clientFd >= 0 && sendAll(clientFd, data, length);
+}
+
+// ========== WebSocketsServer ==========
+void WebSocketsServer::begin() {
+	server.onMessage([this](const uint8_t client, const std::string& text) {
+		if (!eventHandler) return;
+		std::string payload = text; // The library hands out a writable, terminated buffer
+		eventHandler(client, WStype_TEXT, reinterpret_cast<uint8_t*>(&payload[0]), payload.size());
+	});
+	server.onConnection([this](const uint8_t client, const bool isConnected) {
+		if (eventHandler) eventHandler(client, isConnected ? WStype_CONNECTED : WStype_DISCONNECTED, nullptr, 0);
+	});
+
+	std::lock_guard<std::recursive_mutex> lock(serverMutex);
+	const uint16_t port = Host::getInstance().port(robotPort);
+	if (!server.begin(port)) Serial.printf("[Host] Can't serve WebSockets on port %u: %s\n", port, strerror(errno));
+}
+
+void WebSocketsServer::loop() {
+	std::lock_guard<std::recursive_mutex> lock(serverMutex);
+	server.poll(0);
+}
+
+bool WebSocketsServer::sendTXT(const uint8_t num, const char* payload) {
+	std::lock_guard<std::recursive_mutex> lock(serverMutex);
+	server.sendText(num, payload);
+	return true;
+}
+
+bool WebSocketsServer::broadcastTXT(const char* payload) {
+	std::lock_guard<std::recursive_mutex> lock(serverMutex);
+	server.broadcastText(payload);
+	return true;
+}
+
+uint8_t WebSocketsServer::connectedClients() {
+	std::lock_guard<std::recursive_mutex> lock(serverMutex);
+	return server.connectedClients();
+}
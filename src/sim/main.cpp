@@ -0,0 +1,78 @@
+// Entry point for the sim env (envs/sim.ini): the robot's control code on a simulated robot, on the host.
+//
+// Live, driven from the controller page (cd frontend && npm run dev, then open it with ?wsPort=8081):
+//   .pio/build/sim/program --record drive.jsonl --trajectory drive.csv
+// Replay, as fast as possible:
+//   .pio/build/sim/program --replay drive.jsonl --trajectory drive.csv --report drive.json
+//
+// Replay input is one controller message per line with its arrival time in ms: {"t":1250,"x":0,"y":1}
+//
+// Battery estimator only, over a black box recording (python dev_scripts/blackbox_decode.py ... -o run.csv):
+//   .pio/build/sim/program --soc-trace run.csv > soc.csv
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "sim/Simulator.h"
+#include "sim/SocTrace.h"
+
+namespace {
+	Sim::Simulator* running{nullptr};
+
+	void onInterrupt(int /* signal */) {
+		if (running) running->requestStop();
+	}
+
+	void printUsage(const char* program) {
+		fprintf(stderr,
+				"Usage: %s [options]\n"
+				"  --port N          WebSocket port for the controller (default 8081)\n"
+				"  --record FILE     write live input to FILE for --replay\n"
+				"  --replay FILE     apply recorded input instead of listening, then exit\n"
+				"  --tail-ms N       keep simulating N ms after the last replayed input (default 2000)\n"
+				"  --trajectory FILE write pose, wheel speeds, battery and flipper as CSV\n"
+				"  --sample-ms N     trajectory sample period (default 10)\n"
+				"  --report FILE     write the command and latency report as JSON\n"
+				"  --battery F       starting state of charge, 0 to 1 (default 0.9)\n"
+				"  --drive-profile P wheel decay and braking: coast, brake or sharp (default coast)\n"
+				"  --quiet           hide the firmware's Serial output\n"
+				"  --soc-trace FILE  run the battery estimator over a decoded black box CSV instead, writing CSV to stdout\n"
+				"  --soc-every-ms N  correction interval for --soc-trace (default 5000)\n",
+				program);
+	}
+}
+
+int main(int argc, char** argv) {
+	Sim::Simulator::Options options;
+	Sim::SocTraceOptions socTraceOptions;
+	for (int i = 1; i < argc; ++i) {
+		const char* arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+		if (strcmp(arg, "--quiet") == 0) options.isQuiet = true;
+		else if (strcmp(arg, "--port") == 0 && hasValue) options.webSocketPort = static_cast<uint16_t>(atoi(argv[++i]));
+		else if (strcmp(arg, "--record") == 0 && hasValue) options.recordPath = argv[++i];
+		else if (strcmp(arg, "--replay") == 0 && hasValue) options.replayPath = argv[++i];
+		else if (strcmp(arg, "--tail-ms") == 0 && hasValue) options.tailMs = strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(arg, "--trajectory") == 0 && hasValue) options.trajectoryPath = argv[++i];
+		else if (strcmp(arg, "--sample-ms") == 0 && hasValue) options.sampleMs = strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(arg, "--report") == 0 && hasValue) options.reportPath = argv[++i];
+		else if (strcmp(arg, "--battery") == 0 && hasValue) options.stateOfCharge = strtof(argv[++i], nullptr);
+		else if (strcmp(arg, "--drive-profile") == 0 && hasValue) options.driveProfile = argv[++i];
+		else if (strcmp(arg, "--soc-trace") == 0 && hasValue) socTraceOptions.tracePath = argv[++i];
+		else if (strcmp(arg, "--soc-every-ms") == 0 && hasValue) socTraceOptions.correctionMs = strtoul(argv[++i], nullptr, 10);
+		else {
+			printUsage(argv[0]);
+			return 2;
+		}
+	}
+	if (options.sampleMs == 0) options.sampleMs = 1;
+	if (!socTraceOptions.tracePath.empty()) return Sim::replaySocTrace(socTraceOptions);
+
+	Sim::Simulator simulator(options);
+	running = &simulator;
+	signal(SIGINT, onInterrupt); // Ctrl+C ends a live session and writes the reports
+	const int result = simulator.run();
+	running = nullptr;
+	return result;
+}
@@ -0,0 +1,209 @@
+#include "system/InputService.h"
+
+#include <algorithm>
+
+namespace System {
+	QueueHandle_t InputService::messages{nullptr};
+
+	void InputService::begin() {
+		if (messages) return;
+
+		messages = xQueueCreate(16, sizeof(Message));
+		xTaskCreate(
+			InputService::inputTask,
+			"System::InputService",
+			4096, // Callbacks run here, and the factory reset one wipes NVS
+			this,
+			1,
+			nullptr
+		);
+	}
+
+	bool InputService::add(const Config& config, Callback callback) {
+		if (!messages || !callback) return false;
+
+		std::lock_guard<std::mutex> lock(inputsMutex);
+		if (find(config.pin)) return false;
+
+		const auto slotIt = std::find_if(std::begin(inputs), std::end(inputs), [](const Input& input) { return !input.isUsed; });
+		if (slotIt == std::end(inputs)) return false;
+		const uint8_t slot = slotIt - std::begin(inputs);
+		void* const slotArg = reinterpret_cast<void*>(static_cast<uintptr_t>(slot));
+
+		Input& input = *slotIt;
+		input = Input{};
+		input.config = config;
+		input.callback = std::move(callback);
+
+		const esp_timer_create_args_t debounceArgs{
+			[](void* arg) { onTimer(static_cast<uint8_t>(reinterpret_cast<uintptr_t>(arg)), MessageType::SETTLED); },
+			slotArg, ESP_TIMER_TASK, "InputDebounce", false
+		};
+		const esp_timer_create_args_t gestureArgs{
+			[](void* arg) { onTimer(static_cast<uint8_t>(reinterpret_cast<uintptr_t>(arg)), MessageType::GESTURE_TIMER); },
+			slotArg, ESP_TIMER_TASK, "InputGesture", false
+		};
+		if (esp_timer_create(&debounceArgs, &input.debounceTimer) != ESP_OK) return false;
+		if (esp_timer_create(&gestureArgs, &input.gestureTimer) != ESP_OK) {
+			esp_timer_delete(input.debounceTimer);
+			return false;
+		}
+
+		pinMode(config.pin, config.activeLow ? INPUT_PULLUP : INPUT);
+		input.isUsed = true;
+		attachInterruptArg(config.pin, onEdge, slotArg, CHANGE);
+
+		// Settle straight away, so a pin that is already active is reported
+		const Message settle{slot, MessageType::SETTLED, esp_timer_get_time()};
+		xQueueSend(messages, &settle, 0);
+		return true;
+	}
+
+	bool InputService::remove(const uint8_t pin) {
+		std::lock_guard<std::mutex> lock(inputsMutex);
+		Input* input = find(pin);
+		if (!input) return false;
+
+		detachInterrupt(pin);
+		esp_timer_stop(input->debounceTimer);
+		esp_timer_stop(input->gestureTimer);
+		esp_timer_delete(input->debounceTimer);
+		esp_timer_delete(input->gestureTimer);
+		*input = Input{}; // Messages still queued for this slot are ignored
+		return true;
+	}
+
+	bool InputService::getStats(const uint8_t pin, Stats& stats) {
+		std::lock_guard<std::mutex> lock(inputsMutex);
+		const Input* input = find(pin);
+		if (!input) return false;
+
+		stats = input->stats;
+		return true;
+	}
+
+	// Private
+	void IRAM_ATTR InputService::onEdge(void* arg) {
+		const Message message{static_cast<uint8_t>(reinterpret_cast<uintptr_t>(arg)), MessageType::EDGE, esp_timer_get_time()};
+		BaseType_t higherPriorityTaskWoken{pdFALSE};
+		xQueueSendFromISR(messages, &message, &higherPriorityTaskWoken);
+		if (higherPriorityTaskWoken) portYIELD_FROM_ISR();
+	}
+
+	void InputService::onTimer(const uint8_t slot, const MessageType type) {
+		const Message message{slot, type, esp_timer_get_time()};
+		xQueueSend(messages, &message, 0);
+	}
+
+	void InputService::inputTask(void* pvParameters) {
+		auto* self = static_cast<InputService*>(pvParameters);
+		Message message;
+		while (true) {
+			if (xQueueReceive(messages, &message, portMAX_DELAY) == pdPASS) self->handleMessage(message);
+		}
+	}
+
+	void InputService::handleMessage(const Message& message) {
+		Event event{};
+		Callback callback;
+		{
+			std::lock_guard<std::mutex> lock(inputsMutex);
+			if (message.slot >= MAX_INPUTS || !inputs[message.slot].isUsed) return;
+			Input& input = inputs[message.slot];
+
+			bool hasEvent{false};
+			switch (message.type) {
+				case MessageType::EDGE:
+					++input.stats.edges;
+					if (input.firstEdgeUs == 0) input.firstEdgeUs = message.timeUs;
+					startTimer(input.debounceTimer, input.debounceDueUs, input.config.debounceMs * 1000LL); // Restarted by every bounce
+					break;
+				case MessageType::SETTLED:
+					if (message.timeUs < input.debounceDueUs) break; // Timer was restarted after this expiry was queued
+					hasEvent = onSettled(input, message.timeUs, event);
+					break;
+				case MessageType::GESTURE_TIMER:
+					if (message.timeUs < input.gestureDueUs) break;
+					hasEvent = onGestureTimer(input, message.timeUs, event);
+					break;
+			}
+			if (!hasEvent) return;
+
+			event.pin = input.config.pin;
+			event.latencyUs += static_cast<uint32_t>(esp_timer_get_time() - message.timeUs); // Time spent queued
+			if (event.type == EventType::PRESS || event.type == EventType::RELEASE) {
+				input.stats.lastLatencyUs = event.latencyUs;
+				input.stats.maxLatencyUs = std::max(input.stats.maxLatencyUs, event.latencyUs);
+			}
+			++input.stats.events;
+			callback = input.callback; // Called without the lock, so callbacks may add or remove inputs
+		}
+
+		callback(event);
+	}
+
+	bool InputService::onSettled(Input& input, const int64_t timeUs, Event& event) {
+		const int64_t edgeUs = input.firstEdgeUs ? input.firstEdgeUs : timeUs;
+		input.firstEdgeUs = 0;
+
+		const bool isPressed = (digitalRead(input.config.pin) == LOW) == input.config.activeLow;
+		if (isPressed == input.isPressed) return false; // Bounced back to where it was
+		input.isPressed = isPressed;
+
+		event.latencyUs = static_cast<uint32_t>(timeUs - edgeUs);
+		esp_timer_stop(input.gestureTimer);
+		input.gestureDueUs = 0;
+
+		if (isPressed) {
+			input.pressedAtUs = edgeUs;
+			input.longPressSent = false;
+			if (input.config.longPressMs > 0) {
+				const int64_t remainingUs = input.config.longPressMs * 1000LL - (timeUs - edgeUs);
+				startTimer(input.gestureTimer, input.gestureDueUs, std::max<int64_t>(remainingUs, 1));
+			}
+			event.type = EventType::PRESS;
+			return true;
+		}
+
+		event.type = EventType::RELEASE;
+		event.heldMs = static_cast<uint32_t>((edgeUs - input.pressedAtUs) / 1000);
+		if (input.longPressSent) {
+			input.pressCount = 0; // A long press ends any multi-press sequence
+		} else if (input.config.multiPressGapMs > 0) {
+			if (input.pressCount < UINT8_MAX) ++input.pressCount;
+			startTimer(input.gestureTimer, input.gestureDueUs, input.config.multiPressGapMs * 1000LL);
+		}
+		return true;
+	}
+
+	bool InputService::onGestureTimer(Input& input, const int64_t timeUs, Event& event) {
+		input.gestureDueUs = 0;
+
+		if (input.isPressed) {
+			if (input.config.longPressMs == 0 || input.longPressSent) return false;
+			input.longPressSent = true;
+			event.type = EventType::LONG_PRESS;
+			event.heldMs = static_cast<uint32_t>((timeUs - input.pressedAtUs) / 1000);
+			return true;
+		}
+
+		if (input.pressCount == 0) return false;
+		event.type = EventType::MULTI_PRESS;
+		event.count = input.pressCount;
+		input.pressCount = 0;
+		return true;
+	}
+
+	void InputService::startTimer(const esp_timer_handle_t timer, int64_t& dueUs, const int64_t afterUs) {
+		esp_timer_stop(timer); // Fails harmlessly if it isn't running
+		dueUs = esp_timer_get_time() + afterUs;
+		esp_timer_start_once(timer, afterUs);
+	}
+
+	InputService::Input* InputService::find(const uint8_t pin) {
+		for (Input& input : inputs) {
+			if (input.isUsed && input.config.pin == pin) return &input;
+		}
+		return nullptr;
+	}
+}
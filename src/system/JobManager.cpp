@@ -0,0 +1,121 @@
+#include "system/JobManager.h"
+
+namespace System {
+	void JobManager::begin() {
+		if (pendingJobs) return;
+
+		pendingJobs = xQueueCreate(MAX_JOBS, sizeof(uint32_t));
+		xTaskCreate(
+			JobManager::workerTask,
+			"System::JobManager",
+			4096,
+			this,
+			1,
+			nullptr
+		);
+	}
+
+	uint32_t JobManager::submit(const char* name, JobFunction function) {
+		if (!pendingJobs || !function) return 0;
+
+		uint32_t id{0};
+		{
+			std::lock_guard<std::mutex> lock(jobsMutex);
+
+			// Reuse an empty slot, or the oldest finished job
+			Job* slot = nullptr;
+			for (Job& job : jobs) {
+				const bool isFree = job.id == 0
+					|| ((job.status == Status::SUCCEEDED || job.status == Status::FAILED) && !job.completionPending);
+				if (isFree && (!slot || job.id < slot->id)) slot = &job;
+			}
+			if (!slot) return 0;
+
+			id = nextId++;
+			*slot = Job{id, name, function, Status::QUEUED, false};
+		}
+
+		if (xQueueSend(pendingJobs, &id, 0) != pdPASS) {
+			std::lock_guard<std::mutex> lock(jobsMutex);
+			if (Job* job = find(id)) *job = Job{};
+			return 0;
+		}
+		return id;
+	}
+
+	JobManager::Status JobManager::getStatus(uint32_t id, const char** name) {
+		std::lock_guard<std::mutex> lock(jobsMutex);
+		const Job* job = find(id);
+		if (!job) return Status::UNKNOWN;
+
+		if (name) *name = job->name;
+		return job->status;
+	}
+
+	void JobManager::dispatchCompletions(const CompletionCallback& callback) {
+		for (Job& job : jobs) {
+			uint32_t id{0};
+			const char* name{nullptr};
+			Status status{Status::UNKNOWN};
+			{
+				std::lock_guard<std::mutex> lock(jobsMutex);
+				if (!job.completionPending) continue;
+
+				job.completionPending = false;
+				id = job.id;
+				name = job.name;
+				status = job.status;
+			}
+			callback(id, name, status); // Outside the lock so the callback can query jobs
+		}
+	}
+
+	const char* JobManager::statusToString(Status status) {
+		switch (status) {
+			case Status::QUEUED: return "queued";
+			case Status::RUNNING: return "running";
+			case Status::SUCCEEDED: return "succeeded";
+			case Status::FAILED: return "failed";
+			default: return "unknown";
+		}
+	}
+
+	// Private
+	void JobManager::workerTask(void* pvParameters) {
+		auto* self = static_cast<JobManager*>(pvParameters);
+		uint32_t id{0};
+		while (true) {
+			if (xQueueReceive(self->pendingJobs, &id, portMAX_DELAY) == pdPASS) {
+				self->runJob(id);
+			}
+		}
+	}
+
+	void JobManager::runJob(uint32_t id) {
+		JobFunction function{nullptr};
+		{
+			std::lock_guard<std::mutex> lock(jobsMutex);
+			Job* job = find(id);
+			if (!job) return;
+
+			job->status = Status::RUNNING;
+			function = job->function;
+		}
+
+		const bool succeeded = function();
+
+		std::lock_guard<std::mutex> lock(jobsMutex);
+		if (Job* job = find(id)) {
+			job->status = succeeded ? Status::SUCCEEDED : Status::FAILED;
+			job->completionPending = true;
+		}
+	}
+
+	JobManager::Job* JobManager::find(uint32_t id) {
+		if (id == 0) return nullptr;
+		for (Job& job : jobs) {
+			if (job.id == id) return &job;
+		}
+		return nullptr;
+	}
+}
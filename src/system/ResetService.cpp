@@ -1,7 +1,7 @@
 #include "system/ResetService.h"
 #include "system/NVSUtils.h"
 #include <Arduino.h>
-#include <esp_task_wdt.h>  // optional if you want watchdog handling
+#include <esp_timer.h>
 
 namespace System {
 	void ResetService::begin(int resetPin, unsigned long holdTimeMs, unsigned long maxMonitorTimeMs) {
@@ -9,45 +9,41 @@ namespace System {
 		_holdTimeMs = holdTimeMs;
 		_maxMonitorTimeMs = maxMonitorTimeMs;
 
-		pinMode(_resetPin, INPUT_PULLUP);
+		InputService::Config config;
+		config.pin = _resetPin;
+		config.debounceMs = 50;
+		config.longPressMs = _holdTimeMs;
+		if (!InputService::getInstance().add(config, ResetService::onResetPin)) {
+			Serial.println("[ResetService] Could not watch the reset pin.");
+			return;
+		}
 
-		xTaskCreate(
-			ResetService::resetTask,
-			"System::ResetService",
-			2048,
-			nullptr,
-			1,
-			nullptr
-		);
+		esp_timer_handle_t windowTimer;
+		const esp_timer_create_args_t windowArgs{ResetService::onMonitorWindowExpired, nullptr, ESP_TIMER_TASK, "ResetWindow", false};
+		if (esp_timer_create(&windowArgs, &windowTimer) == ESP_OK) {
+			esp_timer_start_once(windowTimer, _maxMonitorTimeMs * 1000ULL);
+		}
 	}
 
 	// This function refers to IO5 as a button since shorting it logically works like pressing a button
-	void ResetService::resetTask(void* pvParameters) {
-		const TickType_t debounceDelay{50 / portTICK_PERIOD_MS};
-		const unsigned long taskStart = millis();
-		unsigned long pressStart = 0;
-		bool buttonPreviouslyPressed = false;
-
-		while ((millis() - taskStart) < _maxMonitorTimeMs) {
-			const bool pinShorted = (digitalRead(_resetPin) == LOW);
-
-			if (pinShorted) {
-				if (!buttonPreviouslyPressed) {
-					pressStart = millis();
-					Serial.println("[ResetService] Button pressed. Hold to confirm reset...");
-				} else if (millis() - pressStart >= _holdTimeMs) {
-					Serial.println("[ResetService] Long press detected. Performing factory reset...");
-					System::Utils::wipeNVSPartition();
-					ESP.restart();
-				}
-			}
-
-			buttonPreviouslyPressed = pinShorted;
-			vTaskDelay(debounceDelay);
+	void ResetService::onResetPin(const InputService::Event& event) {
+		switch (event.type) {
+			case InputService::EventType::PRESS:
+				Serial.printf("[ResetService] Button pressed (%lu us). Hold to confirm reset...\n", (unsigned long)event.latencyUs);
+				break;
+			case InputService::EventType::LONG_PRESS:
+				Serial.println("[ResetService] Long press detected. Performing factory reset...");
+				System::Utils::wipeNVSPartition();
+				ESP.restart();
+				break;
+			default:
+				break;
 		}
+	}
 
-		Serial.println("[ResetService] Monitoring window expired. Task ending.");
-		vTaskDelete(nullptr);
+	void ResetService::onMonitorWindowExpired(void* /* arg */) {
+		InputService::getInstance().remove(_resetPin);
+		Serial.println("[ResetService] Monitoring window expired. Reset pin released.");
 	}
 
 	int ResetService::_resetPin = -1;
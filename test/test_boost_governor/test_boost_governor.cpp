@@ -0,0 +1,193 @@
+// BoostGovernor's state machine, driven with explicit times. Run with: pio test -e native
+#include <unity.h>
+#include <cmath>
+
+#include "BoostGovernor.h"
+
+using Robot::BoostGovernor;
+
+namespace {
+	constexpr uint32_t STEP_MS = 10;
+
+	// Heat only: a 1 s time constant, and a duty budget too big to run out
+	BoostGovernor::Config heatConfig() {
+		BoostGovernor::Config config;
+		config.heatTimeConstantMs = 1000;
+		config.maxDutyCycle = 1.0f;
+		config.dutyBurstMs = 1000000;
+		return config;
+	}
+
+	// Duty only: heat that barely moves, and a 1 s bucket refilling at 25%
+	BoostGovernor::Config dutyConfig() {
+		BoostGovernor::Config config;
+		config.heatTimeConstantMs = 1000000000;
+		config.maxDutyCycle = 0.25f;
+		config.dutyBurstMs = 1000;
+		config.dutyResumeMs = 500;
+		return config;
+	}
+
+	constexpr uint32_t NEVER = UINT32_MAX;
+
+	// Demands boost every step from `fromMs` until update() returns `isBoosted`. Returns the time it did, or NEVER
+	// if it didn't within `limitMs`.
+	uint32_t demandUntil(BoostGovernor& governor, const bool isBoosted, const uint32_t fromMs, const uint32_t limitMs) {
+		for (uint32_t nowMs = fromMs; nowMs <= fromMs + limitMs; nowMs += STEP_MS) {
+			governor.noteDemand(nowMs);
+			if (governor.update(nowMs) == isBoosted) return nowMs;
+		}
+		return NEVER;
+	}
+}
+
+void setUp() {}
+
+void tearDown() {
+	BoostGovernor().setArmed(false); // Arming is saved - don't leak it into the next test
+}
+
+void test_starts_disarmed() {
+	BoostGovernor governor;
+	governor.begin();
+	governor.noteDemand(0);
+
+	TEST_ASSERT_FALSE(governor.isArmed());
+	TEST_ASSERT_FALSE(governor.update(0));
+	TEST_ASSERT_EQUAL(BoostGovernor::Reason::DISARMED, governor.getReason());
+}
+
+void test_arming_survives_a_restart() {
+	BoostGovernor().setArmed(true);
+
+	BoostGovernor restarted;
+	restarted.begin();
+	TEST_ASSERT_TRUE(restarted.isArmed());
+}
+
+void test_demand_boosts_for_the_hold_time() {
+	BoostGovernor governor;
+	governor.setArmed(true);
+	governor.noteDemand(0);
+
+	TEST_ASSERT_TRUE(governor.update(0));
+	TEST_ASSERT_EQUAL(BoostGovernor::Reason::DEMAND, governor.getReason());
+	TEST_ASSERT_TRUE(governor.update(799));
+	TEST_ASSERT_FALSE(governor.update(800));
+	TEST_ASSERT_EQUAL(BoostGovernor::Reason::IDLE, governor.getReason());
+	TEST_ASSERT_EQUAL_UINT32(0, governor.getReport().cutoffCount); // Running out of demand isn't a cut-off
+}
+
+void test_request_holds_until_withdrawn() {
+	BoostGovernor governor;
+	governor.setArmed(true);
+	governor.request(true);
+
+	TEST_ASSERT_TRUE(governor.update(0));
+	TEST_ASSERT_TRUE(governor.update(5000)); // Long past the hold time
+	governor.request(false);
+	TEST_ASSERT_FALSE(governor.update(5010));
+	TEST_ASSERT_EQUAL(BoostGovernor::Reason::IDLE, governor.getReason());
+}
+
+void test_heat_cuts_sustained_boost() {
+	BoostGovernor governor(heatConfig());
+	governor.setArmed(true);
+
+	TEST_ASSERT_EQUAL_UINT32(0, demandUntil(governor, true, 0, 0)); // On straight away
+	// Heat rises towards 2.0 with a 1 s time constant, so it reaches the limit after ln(2) s
+	const uint32_t cutMs = demandUntil(governor, false, STEP_MS, 5000);
+	TEST_ASSERT_UINT32_WITHIN(15, 700, cutMs);
+	TEST_ASSERT_EQUAL(BoostGovernor::Reason::HEAT_LIMIT, governor.getReason());
+	TEST_ASSERT_EQUAL_UINT32(1, governor.getReport().cutoffCount);
+}
+
+void test_heat_cools_down_to_the_resume_level() {
+	BoostGovernor governor(heatConfig());
+	governor.setArmed(true);
+	const uint32_t cutMs = demandUntil(governor, false, 0, 5000);
+	const float heatAtCut = governor.getReport().heat;
+	TEST_ASSERT_TRUE(heatAtCut >= 1.0f);
+
+	// Still wanted, but held off while heat falls from ~1.0 to heatResume (0.6): ln(heat / 0.6) s
+	const uint32_t resumeMs = demandUntil(governor, true, cutMs + STEP_MS, 5000);
+	TEST_ASSERT_UINT32_WITHIN(15, 1000.0f * std::log(heatAtCut / 0.6f), resumeMs - cutMs);
+	TEST_ASSERT_TRUE(governor.getReport().heat <= 0.6f);
+}
+
+void test_duty_budget_runs_out_and_refills() {
+	BoostGovernor governor(dutyConfig());
+	governor.setArmed(true);
+
+	// Boosted, the 1000 ms bucket drains at 1 - 0.25 per ms
+	const uint32_t cutMs = demandUntil(governor, false, 0, 5000);
+	TEST_ASSERT_UINT32_WITHIN(15, 1333, cutMs);
+	TEST_ASSERT_EQUAL(BoostGovernor::Reason::DUTY_LIMIT, governor.getReason());
+
+	// Then refills at 0.25 per ms up to dutyResumeMs (500 ms)
+	const uint32_t resumeMs = demandUntil(governor, true, cutMs + STEP_MS, 5000);
+	TEST_ASSERT_UINT32_WITHIN(15, 2000, resumeMs - cutMs);
+}
+
+void test_duty_budget_holds_at_the_burst_size() {
+	BoostGovernor governor(dutyConfig());
+	governor.setArmed(true);
+	demandUntil(governor, false, 0, 5000);
+
+	TEST_ASSERT_FALSE(governor.update(60000)); // Long idle
+	TEST_ASSERT_EQUAL_UINT32(1000, governor.getReport().dutyCreditMs);
+}
+
+void test_low_battery_refuses_boost() {
+	BoostGovernor governor;
+	governor.setArmed(true);
+	governor.noteDemand(0);
+
+	const int lowPercent = BoostGovernor::Config{}.lowBatteryPercent;
+	governor.noteBatteryPercent(lowPercent);
+	TEST_ASSERT_FALSE(governor.update(0));
+	TEST_ASSERT_EQUAL(BoostGovernor::Reason::LOW_BATTERY, governor.getReason());
+
+	governor.noteBatteryPercent(lowPercent + 1);
+	TEST_ASSERT_TRUE(governor.update(10));
+}
+
+void test_low_battery_cuts_boost_that_is_on() {
+	BoostGovernor governor;
+	governor.setArmed(true);
+	TEST_ASSERT_EQUAL_UINT32(0, demandUntil(governor, true, 0, 0));
+
+	governor.noteBatteryPercent(BoostGovernor::Config{}.lowBatteryPercent);
+	governor.noteDemand(10);
+	TEST_ASSERT_FALSE(governor.update(10));
+	TEST_ASSERT_EQUAL_UINT32(1, governor.getReport().cutoffCount);
+}
+
+void test_disarm_turns_boost_off() {
+	BoostGovernor governor;
+	governor.setArmed(true);
+	governor.noteDemand(0);
+	TEST_ASSERT_TRUE(governor.update(0));
+
+	governor.setArmed(false);
+	governor.noteDemand(10);
+	TEST_ASSERT_FALSE(governor.update(10));
+	TEST_ASSERT_EQUAL(BoostGovernor::Reason::DISARMED, governor.getReason());
+	TEST_ASSERT_EQUAL_UINT32(0, governor.getReport().cutoffCount); // The driver's choice, not a limit
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_starts_disarmed);
+	RUN_TEST(test_arming_survives_a_restart);
+	RUN_TEST(test_demand_boosts_for_the_hold_time);
+	RUN_TEST(test_request_holds_until_withdrawn);
+	RUN_TEST(test_heat_cuts_sustained_boost);
+	RUN_TEST(test_heat_cools_down_to_the_resume_level);
+	RUN_TEST(test_duty_budget_runs_out_and_refills);
+	RUN_TEST(test_duty_budget_holds_at_the_burst_size);
+	RUN_TEST(test_low_battery_refuses_boost);
+	RUN_TEST(test_low_battery_cuts_boost_that_is_on);
+	RUN_TEST(test_disarm_turns_boost_off);
+	return UNITY_END();
+}
@@ -0,0 +1,93 @@
+// ChannelScorer::pickChannel against scan lists like the ones WiFi.scanNetworks() returns. Run with: pio test -e native
+#include <unity.h>
+
+#include "ChannelScorer.h"
+
+using namespace PalookaNetwork::ChannelScorer;
+
+namespace {
+	template<size_t N>
+	uint8_t pick(const ScanResult (&scan)[N]) { return pickChannel(scan, N); }
+
+	// Home: the ISP router and a neighbour's, both on 6
+	constexpr ScanResult HOME[]{{6, -48}, {6, -81}, {1, -90}};
+
+	// School hall: a managed network on 1, 6 and 11, with the nearest access point on 11
+	constexpr ScanResult SCHOOL[]{{1, -72}, {6, -70}, {11, -45}, {1, -80}, {6, -78}, {11, -60}};
+
+	// Event venue: crowded 1 and 6, and a few loud phone hotspots on in-between channels
+	constexpr ScanResult VENUE[]{
+		{1, -60}, {1, -65}, {1, -70}, {1, -82}, {6, -58}, {6, -66}, {6, -75},
+		{3, -55}, {4, -62}, {9, -85}, {11, -88}
+	};
+
+	// Apartment block: one loud network on 11 against a crowd of faint ones on 1, choosing between the two
+	constexpr ScanResult APARTMENT[]{{11, -40}, {1, -88}, {1, -89}, {1, -90}, {1, -91}, {1, -92}, {1, -93}};
+	constexpr uint8_t APARTMENT_CANDIDATES[]{1, 11};
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_empty_scan_picks_the_first_candidate() {
+	TEST_ASSERT_EQUAL_UINT8(1, pickChannel(nullptr, 0));
+}
+
+void test_home_avoids_the_routers_channel() {
+	TEST_ASSERT_EQUAL_UINT8(11, pick(HOME));
+}
+
+void test_school_avoids_the_loudest_access_point() {
+	TEST_ASSERT_EQUAL_UINT8(1, pick(SCHOOL));
+}
+
+void test_venue_counts_overlap_from_in_between_channels() {
+	// 11 only has two faint networks near it; the hotspots on 3 and 4 overlap both 1 and 6
+	TEST_ASSERT_EQUAL_UINT8(11, pick(VENUE));
+}
+
+void test_a_crowd_outweighs_one_loud_network() {
+	// The log keeps one loud network from counting for more than a handful of faint ones
+	TEST_ASSERT_EQUAL_UINT8(11, pickChannel(APARTMENT, 7, APARTMENT_CANDIDATES, 2));
+}
+
+void test_networks_below_the_noise_floor_still_cost_airtime() {
+	constexpr ScanResult scan[]{{1, -99}};
+	TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, scoreChannel(1, scan, 1));
+	TEST_ASSERT_EQUAL_UINT8(6, pick(scan));
+}
+
+void test_overlap_falls_off_with_channel_distance() {
+	constexpr ScanResult scan[]{{3, -60}};
+	TEST_ASSERT_TRUE(scoreChannel(3, scan, 1) > scoreChannel(1, scan, 1));
+	TEST_ASSERT_TRUE(scoreChannel(1, scan, 1) > scoreChannel(6, scan, 1));
+	TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.0f, scoreChannel(11, scan, 1));
+}
+
+void test_ties_go_to_the_earliest_candidate() {
+	constexpr ScanResult scan[]{{6, -50}};
+	TEST_ASSERT_EQUAL_UINT8(1, pick(scan)); // 1 and 11 are both five channels away
+
+	constexpr uint8_t candidates[]{11, 1};
+	TEST_ASSERT_EQUAL_UINT8(11, pickChannel(scan, 1, candidates, 2));
+}
+
+void test_custom_candidates() {
+	constexpr uint8_t candidates[]{1, 6, 11, 13};
+	TEST_ASSERT_EQUAL_UINT8(13, pickChannel(SCHOOL, 6, candidates, 4)); // Two channels from 11 only overlaps it partly
+	TEST_ASSERT_EQUAL_UINT8(DEFAULT_CANDIDATES[0], pickChannel(HOME, 3, nullptr, 0));
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_empty_scan_picks_the_first_candidate);
+	RUN_TEST(test_home_avoids_the_routers_channel);
+	RUN_TEST(test_school_avoids_the_loudest_access_point);
+	RUN_TEST(test_venue_counts_overlap_from_in_between_channels);
+	RUN_TEST(test_a_crowd_outweighs_one_loud_network);
+	RUN_TEST(test_networks_below_the_noise_floor_still_cost_airtime);
+	RUN_TEST(test_overlap_falls_off_with_channel_distance);
+	RUN_TEST(test_ties_go_to_the_earliest_candidate);
+	RUN_TEST(test_custom_candidates);
+	return UNITY_END();
+}
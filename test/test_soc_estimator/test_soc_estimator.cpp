@@ -0,0 +1,123 @@
+// SocEstimator's discharge curve, charge counting and voltage correction. Run with: pio test -e native
+#include <unity.h>
+
+#include <PalookaBot/SocEstimator.h>
+
+using PalookaBot::SocEstimator;
+
+namespace {
+	// No idle draw or internal resistance, so readings map straight onto the curve
+	SocEstimator::Params idealParams() {
+		SocEstimator::Params params;
+		params.idleCurrentA = 0.0f;
+		params.resistanceOhm = 0.0f;
+		return params;
+	}
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_curve_ends() {
+	TEST_ASSERT_EQUAL_UINT32(3270, SocEstimator::openCircuitMvAt(0.0f));
+	TEST_ASSERT_EQUAL_UINT32(4200, SocEstimator::openCircuitMvAt(1.0f));
+	TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.0f, SocEstimator::stateOfChargeAt(3270));
+	TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.0f, SocEstimator::stateOfChargeAt(4200));
+}
+
+void test_curve_clamps_outside_the_range() {
+	TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.0f, SocEstimator::stateOfChargeAt(3000));
+	TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.0f, SocEstimator::stateOfChargeAt(4350));
+	TEST_ASSERT_EQUAL_UINT32(3270, SocEstimator::openCircuitMvAt(-0.5f));
+	TEST_ASSERT_EQUAL_UINT32(4200, SocEstimator::openCircuitMvAt(1.5f));
+}
+
+void test_curve_steps_and_interpolation() {
+	TEST_ASSERT_EQUAL_UINT32(3800, SocEstimator::openCircuitMvAt(0.4f));	// A 5% step
+	TEST_ASSERT_EQUAL_UINT32(3805, SocEstimator::openCircuitMvAt(0.4125f));	// A quarter of the way to 3820 mV
+	TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.7f, SocEstimator::stateOfChargeAt(3950));
+	TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.725f, SocEstimator::stateOfChargeAt(3965)); // Halfway to 3980 mV
+}
+
+void test_curve_round_trips() {
+	for (uint32_t mv = 3270; mv <= 4200; mv += 5) {
+		TEST_ASSERT_INT_WITHIN(1, mv, SocEstimator::openCircuitMvAt(SocEstimator::stateOfChargeAt(mv)));
+	}
+}
+
+void test_seed_adds_back_the_idle_sag() {
+	SocEstimator::Params params;
+	params.idleCurrentA = 0.1f;
+	params.resistanceOhm = 0.5f; // 50 mV
+	SocEstimator estimator(params);
+	estimator.seed(0, 3750);
+
+	TEST_ASSERT_FLOAT_WITHIN(0.001f, SocEstimator::stateOfChargeAt(3800), estimator.getStateOfCharge());
+}
+
+void test_counts_charge_at_the_commanded_load() {
+	SocEstimator estimator(idealParams());
+	estimator.seed(0, 4200);
+	estimator.update(0, SocEstimator::MAX_DUTY, SocEstimator::MAX_DUTY); // 2 x 0.5 A
+
+	// 45 mAh of the default 450 mAh
+	estimator.update(162000, 0, 0);
+	TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.9f, estimator.getStateOfCharge());
+	TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, estimator.getLoadA());
+}
+
+void test_rested_correction_closes_a_share_of_the_gap() {
+	SocEstimator estimator(idealParams());
+	estimator.seed(0, 3800); // 40%
+	estimator.update(0, 0, 0);
+
+	TEST_ASSERT_TRUE(estimator.isRested(2000));
+	estimator.correct(2000, 3950); // Reads 70%
+	TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.4f + 0.3f * 0.3f, estimator.getStateOfCharge());
+}
+
+void test_correction_under_load_is_weak_and_adds_back_the_sag() {
+	SocEstimator::Params params = idealParams();
+	params.resistanceOhm = 0.2f;
+	SocEstimator estimator(params);
+	estimator.seed(0, 3800); // 40%
+	estimator.update(0, SocEstimator::MAX_DUTY, SocEstimator::MAX_DUTY); // 1 A, so 200 mV of sag
+
+	TEST_ASSERT_FALSE(estimator.isRested(0));
+	estimator.correct(0, 3750); // 3950 mV at rest, 70%
+	TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.4f + 0.03f * 0.3f, estimator.getStateOfCharge());
+}
+
+void test_rests_only_after_rest_ms_with_the_motors_off() {
+	SocEstimator estimator(idealParams());
+	estimator.seed(0, 3800);
+	estimator.update(0, 100, 0);
+	estimator.update(1000, 0, 0); // Motors off from here
+
+	TEST_ASSERT_FALSE(estimator.isRested(2999));
+	TEST_ASSERT_TRUE(estimator.isRested(3000));
+}
+
+void test_first_correction_seeds() {
+	SocEstimator estimator(idealParams());
+	TEST_ASSERT_FALSE(estimator.isSeeded());
+
+	estimator.correct(0, 3950);
+	TEST_ASSERT_TRUE(estimator.isSeeded());
+	TEST_ASSERT_EQUAL_INT(70, estimator.getPercent());
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_curve_ends);
+	RUN_TEST(test_curve_clamps_outside_the_range);
+	RUN_TEST(test_curve_steps_and_interpolation);
+	RUN_TEST(test_curve_round_trips);
+	RUN_TEST(test_seed_adds_back_the_idle_sag);
+	RUN_TEST(test_counts_charge_at_the_commanded_load);
+	RUN_TEST(test_rested_correction_closes_a_share_of_the_gap);
+	RUN_TEST(test_correction_under_load_is_weak_and_adds_back_the_sag);
+	RUN_TEST(test_rests_only_after_rest_ms_with_the_motors_off);
+	RUN_TEST(test_first_correction_seeds);
+	return UNITY_END();
+}